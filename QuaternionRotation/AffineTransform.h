@@ -0,0 +1,254 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// AffineTransform.h
+// =================
+// 3x4 affine transform; 3x3 linear part (rotation/scale/shear) and
+// translation. The bottom row of Matrix4 is always (0, 0, 0, 1) for affine
+// transforms, so it is not stored (48 bytes instead of 64) and not computed.
+//
+// The elements are stored as column major order, the first 9 elements are
+// the same layout as Matrix3.
+// |  0  3  6  9 |
+// |  1  4  7 10 |
+// |  2  5  8 11 |
+// | (0  0  0  1)|
+//
+// Composition is 36 multiply-adds (Matrix4 uses 64), and the inverse is
+// the inverse of the 3x3 part with Matrix3::invert(). Convert to Matrix4 with
+// toMatrix4() only when it is passed to OpenGL.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include "Vectors.h"
+#include "Matrices.h"
+
+class AffineTransform
+{
+public:
+	//constructors
+	constexpr AffineTransform();  //init with identity
+	constexpr AffineTransform(const float src[12]);
+	constexpr AffineTransform(const Matrix3& linear, const Vector3& translation);
+	constexpr explicit AffineTransform(const Matrix4& m); //drop the bottom row, assume it is (0,0,0,1)
+
+	constexpr void      set(const float src[12]);
+	constexpr void      setLinear(const Matrix3& linear);
+	constexpr void      setTranslation(const Vector3& t);
+
+	constexpr const float* get() const;
+	constexpr Matrix3   getLinear() const;          //3x3 rotation/scale/shear part
+	constexpr Vector3   getTranslation() const;
+	constexpr Matrix4   toMatrix4() const;          //4x4 matrix for OpenGL
+
+	constexpr AffineTransform& identity();
+	AffineTransform&    invert();                   //the linear part is identity if singular
+
+	//transform vectors
+	constexpr Vector3   transformPoint(const Vector3& p) const;      //p' = L * p + T
+	constexpr Vector3   transformDirection(const Vector3& d) const;  //d' = L * d, no translation
+
+	//operators
+	constexpr AffineTransform operator*(const AffineTransform& rhs) const;   //composition: A3 = A1 * A2
+	constexpr AffineTransform& operator*=(const AffineTransform& rhs);       //composition: A1' = A1 * A2
+	constexpr Vector3   operator*(const Vector3& p) const;           //same as transformPoint()
+	constexpr bool      operator==(const AffineTransform& rhs) const; //exact compare, no epsilon
+	constexpr bool      operator!=(const AffineTransform& rhs) const; //exact compare, no epsilon
+	constexpr float     operator[](int index) const;
+	constexpr float&    operator[](int index);
+
+	friend std::ostream& operator<<(std::ostream& os, const AffineTransform& a);
+
+private:
+	float m[12];
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for AffineTransform
+///////////////////////////////////////////////////////////////////////////////
+constexpr AffineTransform::AffineTransform() : m()
+{
+	identity();
+}
+
+constexpr AffineTransform::AffineTransform(const float src[12]) : m()
+{
+	set(src);
+}
+
+constexpr AffineTransform::AffineTransform(const Matrix3& linear, const Vector3& translation) : m()
+{
+	setLinear(linear);
+	setTranslation(translation);
+}
+
+constexpr AffineTransform::AffineTransform(const Matrix4& mat) : m()
+{
+	m[0] = mat[0];  m[1] = mat[1];  m[2] = mat[2];
+	m[3] = mat[4];  m[4] = mat[5];  m[5] = mat[6];
+	m[6] = mat[8];  m[7] = mat[9];  m[8] = mat[10];
+	m[9] = mat[12]; m[10] = mat[13]; m[11] = mat[14];
+}
+
+constexpr void AffineTransform::set(const float src[12])
+{
+	for (int i = 0; i < 12; ++i)
+		m[i] = src[i];
+}
+
+constexpr void AffineTransform::setLinear(const Matrix3& linear)
+{
+	for (int i = 0; i < 9; ++i)
+		m[i] = linear[i];
+}
+
+constexpr void AffineTransform::setTranslation(const Vector3& t)
+{
+	m[9] = t.x;  m[10] = t.y;  m[11] = t.z;
+}
+
+constexpr const float* AffineTransform::get() const
+{
+	return m;
+}
+
+constexpr Matrix3 AffineTransform::getLinear() const
+{
+	return Matrix3(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]);
+}
+
+constexpr Vector3 AffineTransform::getTranslation() const
+{
+	return Vector3(m[9], m[10], m[11]);
+}
+
+constexpr Matrix4 AffineTransform::toMatrix4() const
+{
+	return Matrix4(m[0], m[1], m[2], 0,
+		m[3], m[4], m[5], 0,
+		m[6], m[7], m[8], 0,
+		m[9], m[10], m[11], 1);
+}
+
+constexpr AffineTransform& AffineTransform::identity()
+{
+	m[0] = m[4] = m[8] = 1.0f;
+	m[1] = m[2] = m[3] = m[5] = m[6] = m[7] = 0.0f;
+	m[9] = m[10] = m[11] = 0.0f;
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse of affine transform
+// y = L*x + T  ->  x = L^-1*y - L^-1*T
+//  [ L | T ]-1   [ L^-1 | -L^-1 * T ]
+//  [ --+-- ]   = [ -----+---------- ]
+//  [ 0 | 1 ]     [  0   +     1     ]
+// If L is singular, L^-1 becomes identity by Matrix3::invert(), same as
+// Matrix4::invertAffine().
+///////////////////////////////////////////////////////////////////////////////
+inline AffineTransform& AffineTransform::invert()
+{
+	Matrix3 r = getLinear();
+	r.invert();
+	setLinear(r);
+
+	float x = m[9];
+	float y = m[10];
+	float z = m[11];
+	m[9] = -(r[0] * x + r[3] * y + r[6] * z);
+	m[10] = -(r[1] * x + r[4] * y + r[7] * z);
+	m[11] = -(r[2] * x + r[5] * y + r[8] * z);
+	return *this;
+}
+
+constexpr Vector3 AffineTransform::transformPoint(const Vector3& p) const
+{
+	return Vector3(m[0] * p.x + m[3] * p.y + m[6] * p.z + m[9],
+		m[1] * p.x + m[4] * p.y + m[7] * p.z + m[10],
+		m[2] * p.x + m[5] * p.y + m[8] * p.z + m[11]);
+}
+
+constexpr Vector3 AffineTransform::transformDirection(const Vector3& d) const
+{
+	return Vector3(m[0] * d.x + m[3] * d.y + m[6] * d.z,
+		m[1] * d.x + m[4] * d.y + m[7] * d.z,
+		m[2] * d.x + m[5] * d.y + m[8] * d.z);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// composition, A1 * A2 = [ L1*L2 | L1*T2 + T1 ]
+// 27 multiply-adds for L1*L2 and 9 for L1*T2
+///////////////////////////////////////////////////////////////////////////////
+constexpr AffineTransform AffineTransform::operator*(const AffineTransform& rhs) const
+{
+	float r[12] = {};
+	for (int c = 0; c < 4; ++c)
+	{
+		float x = rhs.m[c * 3];
+		float y = rhs.m[c * 3 + 1];
+		float z = rhs.m[c * 3 + 2];
+		r[c * 3] = m[0] * x + m[3] * y + m[6] * z;
+		r[c * 3 + 1] = m[1] * x + m[4] * y + m[7] * z;
+		r[c * 3 + 2] = m[2] * x + m[5] * y + m[8] * z;
+	}
+	r[9] += m[9];
+	r[10] += m[10];
+	r[11] += m[11];
+	return AffineTransform(r);
+}
+
+constexpr AffineTransform& AffineTransform::operator*=(const AffineTransform& rhs)
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+constexpr Vector3 AffineTransform::operator*(const Vector3& p) const
+{
+	return transformPoint(p);
+}
+
+constexpr bool AffineTransform::operator==(const AffineTransform& rhs) const
+{
+	for (int i = 0; i < 12; ++i)
+	{
+		if (m[i] != rhs.m[i])
+			return false;
+	}
+	return true;
+}
+
+constexpr bool AffineTransform::operator!=(const AffineTransform& rhs) const
+{
+	return !(*this == rhs);
+}
+
+constexpr float AffineTransform::operator[](int index) const
+{
+	return m[index];
+}
+
+constexpr float& AffineTransform::operator[](int index)
+{
+	return m[index];
+}
+
+inline std::ostream& operator<<(std::ostream& os, const AffineTransform& a)
+{
+	os << std::fixed << std::setprecision(5);
+	for (int r = 0; r < 3; ++r)
+	{
+		os << "[" << std::setw(10) << a.m[r] << " " << std::setw(10) << a.m[r + 3] << " "
+			<< std::setw(10) << a.m[r + 6] << " " << std::setw(10) << a.m[r + 9] << "]\n";
+	}
+	os << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+	return os;
+}
@@ -4,7 +4,11 @@
 #include "Matrices.h"
 #include "Quaternion.h"
 #include "Timer.h"
-#include <sstream>
+#include "benchmark.h"
+#include "simdDispatch.h"
+#include "frameArena.h"
+#include "profiler.h"
+#include <cstring>
 
 //GLUT CALLBACK functions//////////////////////////////////////////////////////////////////////////
 void displayCB();
@@ -35,8 +39,9 @@ void draw();
 const int SCREEN_WIDTH = 1280;
 const int SCREEN_HEIGHT = 720;
 const float ANIM_DURATION = 200.0f;     // ms
-const float D2R = acosf(-1.0f) / 180.0f;
-const float R2D = 180.0f / acosf(-1.0);
+const char* TRACE_FILE = "trace.json";  // written by 'p' with GIL_PROFILE
+constexpr float D2R = Gil::trig::PI / 180.0f;
+constexpr float R2D = 180.0f / Gil::trig::PI;
 
 //global varibales
 void* font = GLUT_BITMAP_8_BY_13;
@@ -53,6 +58,7 @@ float runTime;
 Timer timer;
 Quaternion quat;
 Quaternion fromQ, toQ;
+Gil::FrameArena frameArena(64 * 1024);    // transient data of the frames
 float fromX, fromY;     // prev mouse coords һ
 float animTime;
 
@@ -129,11 +135,22 @@ void drawCube()
 ///////////////////////////////////////////////////////////////////////////////
 void draw()
 {
+	GIL_PROFILE_ZONE("draw");
 	drawCube();
 }
 
 int main(int argc, char** argv)
 {
+	// select the batch kernels once before any use (GIL_SIMD to override)
+	std::cout << "SIMD: " << Gil::getSimdLevelName(Gil::getKernels().level) << std::endl;
+
+	// run the micro benchmarks only, without opening the window
+	if (argc > 1 && strcmp(argv[1], "-bench") == 0)
+	{
+		Gil::runBenchmarks();
+		return 0;
+	}
+
 	// test quaternion ====================================
 	Vector3 v(1, 2, 3);                             // 3D vertex to rotate
 	Vector3 r(0.57735f, 0.57735f, 0.57735f);        // rotation axis (unit vector)
@@ -158,19 +175,20 @@ int main(int argc, char** argv)
 	std::cout << "M*v  = " << v2 << std::endl;
 	std::cout << std::endl;
 
-	Timer t;
+	Timer t(Timer::CYCLES);								// sub-microsecond code below
 
 	// sequence of multiple rotations with quaternion form
-	Quaternion qx = Quaternion(Vector3(1, 0, 0), 22.5f * D2R); // 45 degree about x-axis
-	Quaternion qy = Quaternion(Vector3(0, 1, 0), 22.5f * D2R); // 45 degree about y-axis
-	Quaternion qz = Quaternion(Vector3(0, 0, 1), 22.5f * D2R); // 45 degree about z-axis
+	// the axis quaternions are computed at compile time
+	constexpr Quaternion qx = Quaternion(Vector3(1, 0, 0), 22.5f * D2R); // 45 degree about x-axis
+	constexpr Quaternion qy = Quaternion(Vector3(0, 1, 0), 22.5f * D2R); // 45 degree about y-axis
+	constexpr Quaternion qz = Quaternion(Vector3(0, 0, 1), 22.5f * D2R); // 45 degree about z-axis
 	t.start();
 	q = qx * qy * qz;										// rotation order: qz -> qy -> qx
 	t.stop();
 
 	std::cout << "Multiple Rotations, qx*qy*qz = " << q << std::endl;
 	std::cout << q.getMatrix() << std::endl;
-	std::cout << "Elapsed Time: " << t.getElapsedTimeInMicroSec() << " us\n" << std::endl;
+	std::cout << "Elapsed Time: " << t.getElapsedTimeInNanoSec() << " ns\n" << std::endl;
 
 	// sequence of multiple rotations with matrix form
 	Matrix4 mx = Matrix4().rotateX(45);
@@ -181,7 +199,7 @@ int main(int argc, char** argv)
 	t.stop();
 	// compare the result with the quaternion
 	std::cout << "Multiple Rotations, Mx*My*Mz = \n" << m << std::endl;
-	std::cout << "Elapsed Time: " << t.getElapsedTimeInMicroSec() << " us" << std::endl;
+	std::cout << "Elapsed Time: " << t.getElapsedTimeInNanoSec() << " ns" << std::endl;
 	//=====================================================
 
 	initSharedMem();
@@ -364,6 +382,8 @@ void initLights()
 ///////////////////////////////////////////////////////////////////////////////
 void showInfo()
 {
+	GIL_PROFILE_ZONE("showInfo");
+
 	// backup current model-view matrix
 	glPushMatrix();                     // save current modelview matrix
 	glLoadIdentity();                   // reset modelview matrix
@@ -377,19 +397,26 @@ void showInfo()
 	const int FONT_HEIGHT = 14;
 	float color[4] = { 1, 1, 1, 1 };
 
-	// for print infos
-	std::stringstream ss;
-	ss << " Raw: (" << mouseX << ", " << mouseY << ")";
-	drawString(ss.str().c_str(), 2, screenHeight - (FONT_HEIGHT * 1), color, font);
-	ss.str("");
+	// for print infos, formatted in the frame arena
+	Gil::LinearArena& arena = frameArena.current();
+	const char* text = arena.format(" Raw: (%g, %g)", mouseX, mouseY);
+	drawString(text, 2, screenHeight - (FONT_HEIGHT * 1), color, font);
 
-	ss << std::fixed << std::setprecision(3);
-	ss << "Quat: " << quat;
-	drawString(ss.str().c_str(), 2, screenHeight - (FONT_HEIGHT * 2), color, font);
-	ss.str("");
+	text = arena.format("Quat: [%.3f, %.3f, %.3f, %.3f]", quat.s, quat.x, quat.y, quat.z);
+	drawString(text, 2, screenHeight - (FONT_HEIGHT * 2), color, font);
 
-	// unset floating format
-	ss << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+#ifdef GIL_PROFILE
+	// zones of the last frame, indented by depth
+	const Gil::FrameStats& stats = Gil::getProfileFrame();
+	text = arena.format("Frame: %.3f ms%s", stats.frameNs * 1e-6, Gil::isProfileTracing() ? "  (tracing)" : "");
+	drawString(text, 2, screenHeight - (FONT_HEIGHT * 3), color, font);
+	for (size_t i = 0; i < stats.zones.size(); ++i)
+	{
+		const Gil::ZoneStats& zone = stats.zones[i];
+		text = arena.format("%*s%s: %d x %.3f ms", zone.depth * 2 + 1, "", zone.name, zone.count, zone.totalNs * 1e-6 / zone.count);
+		drawString(text, 2, screenHeight - (FONT_HEIGHT * (4 + (int)i)), color, font);
+	}
+#endif
 
 	// restore projection matrix
 	glPopMatrix();                   // restore to previous projection matrix
@@ -404,6 +431,9 @@ void showInfo()
 //////////////////////////////////////////////////////////////////////////
 void displayCB()
 {
+	GIL_PROFILE_FRAME();                // sums the previous frame
+	GIL_PROFILE_ZONE("displayCB");
+
 	//float elapsedTime = (float)timer.getElapsedTimeInMilliSec();
 	//frameTime = elapsedTime - runTime;
 	//runTime += frameTime;
@@ -426,6 +456,9 @@ void displayCB()
 
 	glPopMatrix();
 	glutSwapBuffers();
+
+	// swap the frame arenas, the data of 2 frames ago is freed
+	frameArena.endFrame();
 }
 
 
@@ -491,6 +524,18 @@ void keyboardCB(unsigned char key, int x, int y)
 		quat.Set(1, 0, 0, 0);
 	}
 	break;
+
+#ifdef GIL_PROFILE
+	case 'p': // start or write the trace of the profiler zones
+	case 'P':
+		if (!Gil::isProfileTracing())
+			Gil::beginProfileTrace();
+		else if (Gil::endProfileTrace(TRACE_FILE))
+			std::cout << "Profile trace written to " << TRACE_FILE << std::endl;
+		else
+			std::cout << "Failed to write " << TRACE_FILE << std::endl;
+		break;
+#endif
 	default:
 		;
 	}
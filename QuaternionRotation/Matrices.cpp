@@ -18,6 +18,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Matrices.h"
+#include "MatrixN.h"
+#include "Quaternion.h"
+#include "simdDispatch.h"
 
 
 const float DEG2RAD = 3.141593f / 180.0f; //角度转弧度
@@ -25,16 +28,6 @@ const float RAD2DEG = 180.0f / 3.141593f; //弧度转角度
 const float EPSILON = 0.00001f; //误差
 
 
-///////////////////////////////////////////////////////////////////////////////
-//transpose 2x2 matrix  //转置
-///////////////////////////////////////////////////////////////////////////////
-
-Matrix2& Matrix2::transpose()
-{
-	std::swap(m[1], m[2]);
-	return *this;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 //return the determinant of 2x2 matrix //行列式
 ///////////////////////////////////////////////////////////////////////////////
@@ -77,7 +70,7 @@ Matrix2& Matrix2::invert()
 float Matrix2::getAngle() const
 {
 	//angel between -pi ~ +pi (-180 ~ +180)
-	return atan2f(m[1], m[0]) * RAD2DEG;
+	return Gil::arcTangent2(m[1], m[0]) * RAD2DEG;
 }
 
 
@@ -86,18 +79,6 @@ float Matrix2::getAngle() const
 
 
 
-///////////////////////////////////////////////////////////////////////////////
-//transpose 3x3 matrix
-///////////////////////////////////////////////////////////////////////////////
-Matrix3& Matrix3::transpose()
-{
-	std::swap(m[1], m[3]);
-	std::swap(m[2], m[6]);
-	std::swap(m[5], m[7]);
-	return *this;
-}
-
-
 ///////////////////////////////////////////////////////////////////////////////
 //return the determinant of 3x3 matrix
 // [ a d g ]
@@ -181,7 +162,7 @@ Vector3 Matrix3::getAngle() const
 	// find yaw (around y-axis) first
 	// NOTE: asin() returns -90~+90, so correct the angle range -180~+180
 	// using z value of forward vector
-	yaw = RAD2DEG * asinf(m[6]);
+	yaw = RAD2DEG * Gil::arcSine(m[6]);
 	if (m[8] < 0)
 	{
 		if (yaw >= 0) yaw = 180.0f - yaw;
@@ -193,12 +174,12 @@ Vector3 Matrix3::getAngle() const
 	if (m[0] > -EPSILON && m[0] < EPSILON)
 	{
 		roll = 0;  //@@ assume roll=0
-		pitch = RAD2DEG * atan2f(m[1], m[4]);
+		pitch = RAD2DEG * Gil::arcTangent2(m[1], m[4]);
 	}
 	else
 	{
-		roll = RAD2DEG * atan2f(-m[3], m[0]);
-		pitch = RAD2DEG * atan2f(-m[7], m[8]);
+		roll = RAD2DEG * Gil::arcTangent2(-m[3], m[0]);
+		pitch = RAD2DEG * Gil::arcTangent2(-m[7], m[8]);
 	}
 
 	return Vector3(pitch, yaw, roll);
@@ -207,20 +188,6 @@ Vector3 Matrix3::getAngle() const
 //======================================================================================================
 
 
-///////////////////////////////////////////////////////////////////////////////
-//transpose 4x4 matrix
-///////////////////////////////////////////////////////////////////////////////
-Matrix4& Matrix4::transpose()
-{
-	std::swap(m[1], m[4]);
-	std::swap(m[2], m[8]);
-	std::swap(m[3], m[12]);
-	std::swap(m[6], m[9]);
-	std::swap(m[7], m[13]);
-	std::swap(m[11], m[14]);
-	return *this;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 //inverse of 4x4 matrix
 ///////////////////////////////////////////////////////////////////////////////
@@ -401,90 +368,231 @@ Matrix4& Matrix4::invertProjective()
 	return *this;
 }
 
+#ifdef GIL_SSE
 ///////////////////////////////////////////////////////////////////////////////
-// compute the inverse of a general 4x4 matrix using Cramer's Rule(克莱姆规则)
-// If cannot find inverse, return indentity matrix
-// M^-1 = adj(M) / det(M)
+// products of 2x2 matrices packed in a register as (a0 a1 a2 a3), used by the
+// block inverse below. A# is the adjugate of A, A*A# = |A|*I.
 ///////////////////////////////////////////////////////////////////////////////
-Matrix4& Matrix4::invertGeneral()
+static inline __m128 mul2x2(__m128 a, __m128 b)         // A * B
 {
-	// get cofactors of minor matrices
-	float cofactor0 = getCofactor(m[5], m[6], m[7], m[9], m[10], m[11], m[13], m[14], m[15]);
-	float cofactor1 = getCofactor(m[4], m[6], m[7], m[8], m[10], m[11], m[12], m[14], m[15]);
-	float cofactor2 = getCofactor(m[4], m[5], m[7], m[8], m[9], m[11], m[12], m[13], m[15]);
-	float cofactor3 = getCofactor(m[4], m[5], m[6], m[8], m[9], m[10], m[12], m[13], m[14]);
-
-	// get determinant
-	float determinant = m[0] * cofactor0 - m[1] * cofactor1 + m[2] * cofactor2 - m[3] * cofactor3;
-	if (fabs(determinant) <= EPSILON)
-	{
-		return identity();
-	}
-
-	// get rest of cofactors for adj(M)
-	float cofactor4 = getCofactor(m[1], m[2], m[3], m[9], m[10], m[11], m[13], m[14], m[15]);
-	float cofactor5 = getCofactor(m[0], m[2], m[3], m[8], m[10], m[11], m[12], m[14], m[15]);
-	float cofactor6 = getCofactor(m[0], m[1], m[3], m[8], m[9], m[11], m[12], m[13], m[15]);
-	float cofactor7 = getCofactor(m[0], m[1], m[2], m[8], m[9], m[10], m[12], m[13], m[14]);
+	return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
 
-	float cofactor8 = getCofactor(m[1], m[2], m[3], m[5], m[6], m[7], m[13], m[14], m[15]);
-	float cofactor9 = getCofactor(m[0], m[2], m[3], m[4], m[6], m[7], m[12], m[14], m[15]);
-	float cofactor10 = getCofactor(m[0], m[1], m[3], m[4], m[5], m[7], m[12], m[13], m[15]);
-	float cofactor11 = getCofactor(m[0], m[1], m[2], m[4], m[5], m[6], m[12], m[13], m[14]);
+static inline __m128 adjMul2x2(__m128 a, __m128 b)      // A# * B
+{
+	return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
 
-	float cofactor12 = getCofactor(m[1], m[2], m[3], m[5], m[6], m[7], m[9], m[10], m[11]);
-	float cofactor13 = getCofactor(m[0], m[2], m[3], m[4], m[6], m[7], m[8], m[10], m[11]);
-	float cofactor14 = getCofactor(m[0], m[1], m[3], m[4], m[5], m[7], m[8], m[9], m[11]);
-	float cofactor15 = getCofactor(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]);
+static inline __m128 mulAdj2x2(__m128 a, __m128 b)      // A * B#
+{
+	return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+		_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
 
-	// build inverse matrix = adj(M) / det(M)
-	// adjugate of M is the transpose of the cofactor matrix of M
-	float invDeterminant = 1.0f / determinant;
-	m[0] = invDeterminant * cofactor0;
-	m[1] = -invDeterminant * cofactor4;
-	m[2] = invDeterminant * cofactor8;
-	m[3] = -invDeterminant * cofactor12;
-
-	m[4] = -invDeterminant * cofactor1;
-	m[5] = invDeterminant * cofactor5;
-	m[6] = -invDeterminant * cofactor9;
-	m[7] = invDeterminant * cofactor13;
-
-	m[8] = invDeterminant * cofactor2;
-	m[9] = -invDeterminant * cofactor6;
-	m[10] = invDeterminant * cofactor10;
-	m[11] = -invDeterminant * cofactor14;
-
-	m[12] = -invDeterminant * cofactor3;
-	m[13] = invDeterminant * cofactor7;
-	m[14] = -invDeterminant * cofactor11;
-	m[15] = invDeterminant * cofactor15;
+///////////////////////////////////////////////////////////////////////////////
+// inverse of 4x4 matrix with 2x2 sub-determinants (Laplace expansion)
+// It returns the determinant of src, and writes the inverse to dst only if
+// |det| > EPSILON. dst may be the same as src.
+//
+// SSE: the matrix is split into 2x2 blocks, M = [A B; C D], and
+//   |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+//   M^-1 = 1/|M| * [ (|D|A - B(D#C))#   (|B|C - D(A#B)#)# ]
+//                  [ (|C|B - A(D#C)#)#  (|A|D - C(A#B))#  ]
+// The 16 floats are processed as the rows of the transposed matrix, which
+// does not matter because (M^T)^-1 = (M^-1)^T.
+//
+// scalar: 12 2x2 sub-determinants of the first and the last 2 columns are
+// shared by the determinant and all 16 cofactors, instead of 16 3x3
+// cofactors of getCofactor().
+///////////////////////////////////////////////////////////////////////////////
+static float invertMatrix4(const float* src, float* dst)
+{
+#ifdef GIL_SSE
+	__m128 r0 = _mm_loadu_ps(src);
+	__m128 r1 = _mm_loadu_ps(src + 4);
+	__m128 r2 = _mm_loadu_ps(src + 8);
+	__m128 r3 = _mm_loadu_ps(src + 12);
+
+	// 2x2 blocks
+	__m128 a = _mm_movelh_ps(r0, r1);
+	__m128 b = _mm_movehl_ps(r1, r0);
+	__m128 c = _mm_movelh_ps(r2, r3);
+	__m128 d = _mm_movehl_ps(r3, r2);
+
+	// determinants of the blocks (|A| |B| |C| |D|)
+	__m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+	__m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m128 dc = adjMul2x2(d, c);    // D#C
+	__m128 ab = adjMul2x2(a, b);    // A#B
+
+	// tr((A#B)(D#C)), horizontal sum without SSE3
+	__m128 tr = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+	tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+	tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+	__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+	float determinant = _mm_cvtss_f32(det);
+	if (fabs(determinant) <= EPSILON)
+		return determinant;
+
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mul2x2(b, dc));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mul2x2(c, ab));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mulAdj2x2(d, ab));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mulAdj2x2(a, dc));
+
+	// (1/|M|, -1/|M|, -1/|M|, 1/|M|) applies the signs of the adjugates
+	__m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, invDet);
+	y = _mm_mul_ps(y, invDet);
+	z = _mm_mul_ps(z, invDet);
+	w = _mm_mul_ps(w, invDet);
+
+	// adjugate shuffle and block assembly at once
+	_mm_storeu_ps(dst, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(dst + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	_mm_storeu_ps(dst + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(dst + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+	return determinant;
+#else
+	const float* m = src;
+
+	// 2x2 sub-determinants of the 1st/2nd columns and the 3rd/4th columns
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
+
+	float c5 = m[10] * m[15] - m[14] * m[11];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c0 = m[8] * m[13] - m[12] * m[9];
+
+	float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if (fabs(determinant) <= EPSILON)
+		return determinant;
+
+	float invDet = 1.0f / determinant;
+	float r[16];
+	r[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * invDet;
+	r[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * invDet;
+	r[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * invDet;
+	r[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * invDet;
+
+	r[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * invDet;
+	r[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * invDet;
+	r[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * invDet;
+	r[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * invDet;
+
+	r[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * invDet;
+	r[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * invDet;
+	r[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * invDet;
+	r[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * invDet;
+
+	r[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * invDet;
+	r[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * invDet;
+	r[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * invDet;
+	r[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * invDet;
+
+	for (int i = 0; i < 16; ++i)
+		dst[i] = r[i];
+	return determinant;
+#endif
+}
 
+///////////////////////////////////////////////////////////////////////////////
+// compute the inverse of a general 4x4 matrix, M^-1 = adj(M) / det(M)
+// If cannot find inverse, return indentity matrix.
+// If determinant is not NULL, the determinant of the original matrix is
+// stored, so the caller can check if it was singular.
+///////////////////////////////////////////////////////////////////////////////
+Matrix4& Matrix4::invertGeneral(float* determinant)
+{
+	float det = invertMatrix4(m, m);
+	if (determinant)
+		*determinant = det;
+	if (fabs(det) <= EPSILON)
+		identity();
 	return *this;
+}
 
+///////////////////////////////////////////////////////////////////////////////
+// inverse of array of general matrices
+// Singular matrices are set to identity and singular[i] is set to true if
+// singular is not NULL. The inverses may be the same array as the matrices.
+// It returns the number of singular matrices.
+///////////////////////////////////////////////////////////////////////////////
+int Matrix4::invert(const Matrix4* matrices, Matrix4* inverses, int count, bool* singular)
+{
+	// the kernel inverts a chunk with the lanes of the CPU, see simdKernels.h
+	const int CHUNK = 256;
+	const int stride = (int)(sizeof(Matrix4) / sizeof(float));
+	float determinants[CHUNK];
+	int failed = 0;
+	for (int first = 0; first < count; first += CHUNK)
+	{
+		int n = count - first < CHUNK ? count - first : CHUNK;
+		Gil::getKernels().invertMatrices(matrices[first].m, inverses[first].m, determinants, n, stride);
+		for (int i = 0; i < n; ++i)
+		{
+			bool result = fabs(determinants[i]) <= EPSILON;
+			if (result)
+			{
+				inverses[first + i].identity();
+				++failed;
+			}
+			if (singular)
+				singular[first + i] = result;
+		}
+	}
+	return failed;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// return determinant of 4x4 matrix
+// element-wise products of matrix arrays with the lanes of the CPU
+// (2 matrix columns per AVX2 register, 4 per AVX-512), see simdKernels.h
 ///////////////////////////////////////////////////////////////////////////////
-float Matrix4::getDeterminant() const
+void Matrix4::multiply(const Matrix4* a, const Matrix4* b, Matrix4* out, int count)
 {
-	return m[0] * getCofactor(m[5], m[6], m[7], m[9], m[10], m[11], m[13], m[14], m[15]) -
-		m[1] * getCofactor(m[4], m[6], m[7], m[8], m[10], m[11], m[12], m[14], m[15]) +
-		m[2] * getCofactor(m[4], m[5], m[7], m[8], m[9], m[11], m[12], m[13], m[15]) -
-		m[3] * getCofactor(m[4], m[5], m[6], m[8], m[9], m[10], m[12], m[13], m[14]);
+	if (count > 0)
+		Gil::getKernels().multiplyMatrices(a[0].m, b[0].m, out[0].m, count, (int)(sizeof(Matrix4) / sizeof(float)));
 }
 
+
+
 ///////////////////////////////////////////////////////////////////////////////
-// compute cofactor of 3x3 minor matrix without sign
-// input params are 9 elements of the minor matrix
-// NOTE: The caller must know its sign.
+// return determinant of 4x4 matrix
+// same 2x2 sub-determinants as invertMatrix4()
 ///////////////////////////////////////////////////////////////////////////////
-float Matrix4::getCofactor(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8) const
+float Matrix4::getDeterminant() const
 {
-	return m0 * (m4 * m8 - m5 * m7) -
-		m1 * (m3 * m8 - m5 * m6) +
-		m2 * (m3 * m7 - m4 * m6);
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
+
+	float c5 = m[10] * m[15] - m[14] * m[11];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c0 = m[8] * m[13] - m[12] * m[9];
+
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -530,8 +638,8 @@ Matrix4& Matrix4::rotate(float angle, const Vector3& axis)
 
 Matrix4& Matrix4::rotate(float angle, float x, float y, float z)
 {
-	float c = cosf(angle * DEG2RAD);    // cosine
-	float s = sinf(angle * DEG2RAD);    // sine
+	float s, c;                         // sine, cosine
+	Gil::sinCos(angle * DEG2RAD, s, c);
 	float c1 = 1.0f - c;                // 1 - c
 	float m0 = m[0], m4 = m[4], m8 = m[8], m12 = m[12],
 		m1 = m[1], m5 = m[5], m9 = m[9], m13 = m[13],
@@ -567,8 +675,8 @@ Matrix4& Matrix4::rotate(float angle, float x, float y, float z)
 
 Matrix4& Matrix4::rotateX(float angle)
 {
-	float c = cosf(angle * DEG2RAD);
-	float s = sinf(angle * DEG2RAD);
+	float s, c;
+	Gil::sinCos(angle * DEG2RAD, s, c);
 	float m1 = m[1], m2 = m[2],
 		m5 = m[5], m6 = m[6],
 		m9 = m[9], m10 = m[10],
@@ -588,8 +696,8 @@ Matrix4& Matrix4::rotateX(float angle)
 
 Matrix4& Matrix4::rotateY(float angle)
 {
-	float c = cosf(angle * DEG2RAD);
-	float s = sinf(angle * DEG2RAD);
+	float s, c;
+	Gil::sinCos(angle * DEG2RAD, s, c);
 	float m0 = m[0], m2 = m[2],
 		m4 = m[4], m6 = m[6],
 		m8 = m[8], m10 = m[10],
@@ -609,8 +717,8 @@ Matrix4& Matrix4::rotateY(float angle)
 
 Matrix4& Matrix4::rotateZ(float angle)
 {
-	float c = cosf(angle * DEG2RAD);
-	float s = sinf(angle * DEG2RAD);
+	float s, c;
+	Gil::sinCos(angle * DEG2RAD, s, c);
 	float m0 = m[0], m1 = m[1],
 		m4 = m[4], m5 = m[5],
 		m8 = m[8], m9 = m[9],
@@ -732,7 +840,7 @@ Vector3 Matrix4::getAngle() const
 	// find yaw (around y-axis) first
 	// NOTE: asin() returns -90~+90, so correct the angle range -180~+180
 	// using z value of forward vector
-	yaw = RAD2DEG * asinf(m[8]);
+	yaw = RAD2DEG * Gil::arcSine(m[8]);
 	if (m[10] < 0)
 	{
 		if (yaw >= 0) yaw = 180.0f - yaw;
@@ -744,14 +852,288 @@ Vector3 Matrix4::getAngle() const
 	if (m[0] > -EPSILON && m[0] < EPSILON)
 	{
 		roll = 0;  //@@ assume roll=0
-		pitch = RAD2DEG * atan2f(m[1], m[5]);
+		pitch = RAD2DEG * Gil::arcTangent2(m[1], m[5]);
 	}
 	else
 	{
-		roll = RAD2DEG * atan2f(-m[4], m[0]);
-		pitch = RAD2DEG * atan2f(-m[9], m[10]);
+		roll = RAD2DEG * Gil::arcTangent2(-m[4], m[0]);
+		pitch = RAD2DEG * Gil::arcTangent2(-m[9], m[10]);
 	}
 
 	return Vector3(pitch, yaw, roll);
 
-}
\ No newline at end of file
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// write T*R*S of the given translation, unit quaternion and scale to dst
+// (16 floats, column-major). It is the same as
+// Matrix4().scale(S) -> (quaternion matrix) -> translate(T), but every element
+// is written only once.
+//
+//         | R00*Sx  R01*Sy  R02*Sz  Tx |
+// T*R*S = | R10*Sx  R11*Sy  R12*Sz  Ty |
+//         | R20*Sx  R21*Sy  R22*Sz  Tz |
+//         |   0       0       0     1  |
+///////////////////////////////////////////////////////////////////////////////
+static inline void composeTRS(const Vector3& t, const Quaternion& q, const Vector3& s, float* dst)
+{
+	// same terms as Quaternion::getMatrix()
+	float x2 = q.x + q.x;
+	float y2 = q.y + q.y;
+	float z2 = q.z + q.z;
+	float xx2 = q.x * x2;
+	float xy2 = q.x * y2;
+	float xz2 = q.x * z2;
+	float yy2 = q.y * y2;
+	float yz2 = q.y * z2;
+	float zz2 = q.z * z2;
+	float sx2 = q.s * x2;
+	float sy2 = q.s * y2;
+	float sz2 = q.s * z2;
+
+	dst[0] = (1 - (yy2 + zz2)) * s.x;
+	dst[1] = (xy2 + sz2) * s.x;
+	dst[2] = (xz2 - sy2) * s.x;
+	dst[3] = 0;
+	dst[4] = (xy2 - sz2) * s.y;
+	dst[5] = (1 - (xx2 + zz2)) * s.y;
+	dst[6] = (yz2 + sx2) * s.y;
+	dst[7] = 0;
+	dst[8] = (xz2 + sy2) * s.z;
+	dst[9] = (yz2 - sx2) * s.z;
+	dst[10] = (1 - (xx2 + yy2)) * s.z;
+	dst[11] = 0;
+	dst[12] = t.x;
+	dst[13] = t.y;
+	dst[14] = t.z;
+	dst[15] = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// build transform matrix, M = T*R*S
+// NOTE: assume the quaternion is unit length
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 Matrix4::fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	Matrix4 mat;
+	composeTRS(translation, rotation, scale, mat.m);
+	return mat;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// build the inverse of T*R*S directly without general inverse
+// (T*R*S)^-1 = S^-1 * R^T * T^-1
+//
+//  [ R^T/S | -(R^T/S) * T ]    (R^T/S denotes the i-th row of R^T divided by Si)
+//  [ ------+------------- ]
+//  [   0   |      1       ]
+//
+// If any scale factor is 0, the inverse cannot be found and it returns identity.
+// NOTE: assume the quaternion is unit length
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 Matrix4::fromInverseTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	Matrix4 mat;
+	if (fabs(scale.x) <= EPSILON || fabs(scale.y) <= EPSILON || fabs(scale.z) <= EPSILON)
+	{
+		return mat; // cannot inverse, return identity matrix
+	}
+
+	const Quaternion& q = rotation;
+	float x2 = q.x + q.x;
+	float y2 = q.y + q.y;
+	float z2 = q.z + q.z;
+	float xx2 = q.x * x2;
+	float xy2 = q.x * y2;
+	float xz2 = q.x * z2;
+	float yy2 = q.y * y2;
+	float yz2 = q.y * z2;
+	float zz2 = q.z * z2;
+	float sx2 = q.s * x2;
+	float sy2 = q.s * y2;
+	float sz2 = q.s * z2;
+
+	float invX = 1.0f / scale.x;
+	float invY = 1.0f / scale.y;
+	float invZ = 1.0f / scale.z;
+
+	// S^-1 * R^T (row i of R^T is column i of R)
+	float* m = mat.m;
+	m[0] = (1 - (yy2 + zz2)) * invX;
+	m[1] = (xy2 - sz2) * invY;
+	m[2] = (xz2 + sy2) * invZ;
+	m[4] = (xy2 + sz2) * invX;
+	m[5] = (1 - (xx2 + zz2)) * invY;
+	m[6] = (yz2 - sx2) * invZ;
+	m[8] = (xz2 - sy2) * invX;
+	m[9] = (yz2 + sx2) * invY;
+	m[10] = (1 - (xx2 + yy2)) * invZ;
+
+	// -(S^-1 * R^T) * T
+	float x = translation.x;
+	float y = translation.y;
+	float z = translation.z;
+	m[12] = -(m[0] * x + m[4] * y + m[8] * z);
+	m[13] = -(m[1] * x + m[5] * y + m[9] * z);
+	m[14] = -(m[2] * x + m[6] * y + m[10] * z);
+
+	// last row is (0,0,0,1) from identity
+	return mat;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// build a matrix palette from SoA arrays of translations, rotations and scales
+// Each matrix is written as 16 floats (column-major) to palette, so the result
+// can be passed to glLoadMatrixf() or glUniformMatrix4fv() as is.
+// palette must have room for count * 16 floats.
+// The matrices are built in the lanes of the CPU, see simdKernels.h.
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::fromTRS(const Vector3* translations, const Quaternion* rotations, const Vector3* scales,
+	float* palette, int count)
+{
+	if (count > 0)
+		Gil::getKernels().composeTRS(&translations->x, &rotations->s, &scales->x, palette, count, 16);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// same as above, to an array of Matrix4
+///////////////////////////////////////////////////////////////////////////////
+void Matrix4::fromTRS(const Vector3* translations, const Quaternion* rotations, const Vector3* scales,
+	Matrix4* matrices, int count)
+{
+	if (count > 0)
+		Gil::getKernels().composeTRS(&translations->x, &rotations->s, &scales->x, matrices[0].m, count,
+			(int)(sizeof(Matrix4) / sizeof(float)));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// convert orthonormal rotation matrix to unit quaternion
+// The input is 3 columns of the rotation matrix. It uses the largest of the
+// diagonal terms (or trace) as the divisor to avoid precision loss.
+// (Shepperd's method)
+///////////////////////////////////////////////////////////////////////////////
+static Quaternion rotationToQuaternion(const Vector3& c0, const Vector3& c1, const Vector3& c2)
+{
+	// Rij: row i, column j
+	float r00 = c0.x, r10 = c0.y, r20 = c0.z;
+	float r01 = c1.x, r11 = c1.y, r21 = c1.z;
+	float r02 = c2.x, r12 = c2.y, r22 = c2.z;
+
+	float trace = r00 + r11 + r22;
+	if (trace > 0)
+	{
+		float d = sqrtf(trace + 1.0f) * 2.0f;  // d = 4s
+		float invD = 1.0f / d;
+		return Quaternion(0.25f * d, (r21 - r12) * invD, (r02 - r20) * invD, (r10 - r01) * invD);
+	}
+	else if (r00 > r11 && r00 > r22)
+	{
+		float d = sqrtf(1.0f + r00 - r11 - r22) * 2.0f;  // d = 4x
+		float invD = 1.0f / d;
+		return Quaternion((r21 - r12) * invD, 0.25f * d, (r01 + r10) * invD, (r02 + r20) * invD);
+	}
+	else if (r11 > r22)
+	{
+		float d = sqrtf(1.0f + r11 - r00 - r22) * 2.0f;  // d = 4y
+		float invD = 1.0f / d;
+		return Quaternion((r02 - r20) * invD, (r01 + r10) * invD, 0.25f * d, (r12 + r21) * invD);
+	}
+	else
+	{
+		float d = sqrtf(1.0f + r22 - r00 - r11) * 2.0f;  // d = 4z
+		float invD = 1.0f / d;
+		return Quaternion((r10 - r01) * invD, (r02 + r20) * invD, (r12 + r21) * invD, 0.25f * d);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// decompose affine matrix into translation, rotation and scale, M = T*R*S
+// Translation is the 4th column, and the scale factors are the lengths of
+// the first 3 columns. If the determinant is negative (reflection), the sign
+// of X scale is flipped, so the rotation part stays a proper rotation.
+//
+// It returns false if the matrix cannot be represented with T*R*S exactly;
+// - the 4th row is not (0,0,0,1) (projection)
+// - a scale factor is 0 (rotation cannot be found, set to identity)
+// - the columns are not orthogonal each other (shear)
+// In case of shear, the columns are orthonormalized (Gram-Schmidt) and the
+// outputs are the closest T*R*S.
+///////////////////////////////////////////////////////////////////////////////
+bool Matrix4::decompose(Vector3& translation, Quaternion& rotation, Vector3& scale) const
+{
+	const float SHEAR_EPSILON = 0.0001f;  // tolerance of cosine between axes
+
+	translation.Set(m[12], m[13], m[14]);
+	bool affine = (m[3] == 0 && m[7] == 0 && m[11] == 0 && m[15] == 1);
+
+	Vector3 c0(m[0], m[1], m[2]);
+	Vector3 c1(m[4], m[5], m[6]);
+	Vector3 c2(m[8], m[9], m[10]);
+	scale.Set(c0.Length(), c1.Length(), c2.Length());
+	if (scale.x <= EPSILON || scale.y <= EPSILON || scale.z <= EPSILON)
+	{
+		rotation.Set(1, 0, 0, 0);
+		return false;
+	}
+
+	// flip X axis if it is reflection, det(M) = c0 . (c1 x c2)
+	if (c0.dot(c1.cross(c2)) < 0)
+		scale.x = -scale.x;
+
+	c0 *= 1.0f / scale.x;
+	c1 *= 1.0f / scale.y;
+	c2 *= 1.0f / scale.z;
+
+	// check shear with the cosines between axes
+	float d01 = c0.dot(c1);
+	float d02 = c0.dot(c2);
+	float d12 = c1.dot(c2);
+	bool sheared = fabs(d01) > SHEAR_EPSILON || fabs(d02) > SHEAR_EPSILON || fabs(d12) > SHEAR_EPSILON;
+	if (sheared)
+	{
+		// remove shear from the axes (Gram-Schmidt)
+		c1 -= c0 * d01;
+		c1.Normalize();
+		c2 -= c0 * c0.dot(c2) + c1 * c1.dot(c2);
+		c2.Normalize();
+	}
+
+	rotation = rotationToQuaternion(c0, c1, c2);
+	return affine && !sheared;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// decompose array of matrices into SoA arrays of translations, rotations and
+// scales. If valid is not NULL, valid[i] is set to the result of decompose()
+// of each matrix.
+// It returns the number of matrices that cannot be decomposed exactly.
+///////////////////////////////////////////////////////////////////////////////
+int Matrix4::decompose(const Matrix4* matrices, Vector3* translations, Quaternion* rotations, Vector3* scales,
+	int count, bool* valid)
+{
+	int failed = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		bool result = matrices[i].decompose(translations[i], rotations[i], scales[i]);
+		if (!result)
+			++failed;
+		if (valid)
+			valid[i] = result;
+	}
+	return failed;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// double instantiations of the generic templates (see MatrixN.h)
+///////////////////////////////////////////////////////////////////////////////
+template struct Vector<double, 2>;
+template struct Vector<double, 3>;
+template struct Vector<double, 4>;
+template class Matrix<double, 2, 2>;
+template class Matrix<double, 3, 3>;
+template class Matrix<double, 4, 4>;
@@ -20,60 +20,116 @@
 
 #include "Vectors.h"
 #include <iomanip>
+#include <utility>
+#include <type_traits>
+
+struct Quaternion; // defined in Quaternion.h
+
+// Matrix<T, R, C> is the generic RxC matrix (MatrixN.h). Matrix2, Matrix3 and
+// Matrix4 are its hand-written float specializations below.
+template <class T, int R, int C> class Matrix;
+typedef Matrix<float, 2, 2> Matrix2;
+typedef Matrix<float, 3, 3> Matrix3;
+typedef Matrix<float, 4, 4> Matrix4;
+
+#ifdef GIL_SSE
+namespace Gil
+{
+	///////////////////////////////////////////////////////////////////////////
+	// SSE products of column-major matrices, dst = a * b
+	// Each column of dst is the sum of the columns of a, scaled by the
+	// elements of the same column of b. dst must not overlap a or b.
+	///////////////////////////////////////////////////////////////////////////
+	inline void multiplyMatrix4(const float* a, const float* b, float* dst)
+	{
+		__m128 a0 = _mm_loadu_ps(a);
+		__m128 a1 = _mm_loadu_ps(a + 4);
+		__m128 a2 = _mm_loadu_ps(a + 8);
+		__m128 a3 = _mm_loadu_ps(a + 12);
+		for (int i = 0; i < 16; i += 4)
+		{
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[i]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[i + 1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[i + 2])));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[i + 3])));
+			_mm_storeu_ps(dst + i, r);
+		}
+	}
+
+	// dst needs 12 floats; the 4th lane of each column is overwritten by the
+	// next column, and dst[9..11] are garbage.
+	inline void multiplyMatrix3(const float* a, const float* b, float* dst)
+	{
+		__m128 a0 = _mm_loadu_ps(a);                    // a0 a1 a2 (a3)
+		__m128 a1 = _mm_loadu_ps(a + 3);                // a3 a4 a5 (a6)
+		__m128 a2 = _mm_setr_ps(a[6], a[7], a[8], 0);   // do not read past a[8]
+		for (int i = 0; i < 9; i += 3)
+		{
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[i]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[i + 1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[i + 2])));
+			_mm_storeu_ps(dst + i, r);
+		}
+	}
+} //end of namespace Gil
+#endif
 
 ///////////////////////////////////////////////////////////////////////////
 // 2x2 matrix
 ///////////////////////////////////////////////////////////////////////////
 
-class Matrix2
+template <>
+class Matrix<float, 2, 2>
 {
 public:
 	//constructors
-	Matrix2();  //init with identity
-	Matrix2(const float src[4]);
-	Matrix2(float m0, float m1, float m2, float m3);
-
-	void        set(const float src[4]);
-	void        set(float m0, float m1, float m2, float m3);
-	void        setRow(int index, const float row[2]);
-	void        setRow(int index, const Vector2& v);
-	void        setColumn(int index, const float col[2]);
-	void        setColumn(int index, const Vector2& v);
-
-	const float* get() const;
-	const float* getTranspose(); //return transposed matrix
-	Vector2		getRow(int index) const;
-	Vector2		getColumn(int index) const;
+	constexpr Matrix();  //init with identity
+	constexpr Matrix(const float src[4]);
+	constexpr Matrix(float m0, float m1, float m2, float m3);
+
+	constexpr void        set(const float src[4]);
+	constexpr void        set(float m0, float m1, float m2, float m3);
+	constexpr void        setRow(int index, const float row[2]);
+	constexpr void        setRow(int index, const Vector2& v);
+	constexpr void        setColumn(int index, const float col[2]);
+	constexpr void        setColumn(int index, const Vector2& v);
+
+	constexpr const float* get() const;
+	constexpr const float* getTranspose(); //return transposed matrix
+	constexpr Vector2		getRow(int index) const;
+	constexpr Vector2		getColumn(int index) const;
 	float       getDeterminant() const;
 	float		getAngle() const;   //retrieve angle(degree) from matrix
 
-	Matrix2& identity();
-	Matrix2& transpose();           //transpose itself and return reference
+	constexpr Matrix2& identity();
+	constexpr Matrix2& transpose();           //transpose itself and return reference
 	Matrix2& invert();
 
 	//operators
-	Matrix2     operator+(const Matrix2& rhs) const;   //add rhs
-	Matrix2     operator-(const Matrix2& rhs) const;   //subtract rhs
-	Matrix2&	operator+=(const Matrix2& rhs);  //add rhs and update this matrix
-	Matrix2&	operator-=(const Matrix2& rhs);  //subtract rhs and update this matrix
-	Vector2     operator*(const Vector2& rhs) const;   // multiplication: v' = M * v
-	Matrix2     operator*(const Matrix2& rhs) const;  // multiplication: M3 = M1 * M2
-	Matrix2&	operator*=(const Matrix2& rhs); // multiplication: M1' = M1 * M2
-
-	bool		operator == (const Matrix2& rhs) const;   // exact compare, no epsilon
-	bool		operator != (const Matrix2& rhs) const;   // exact compare, no epsilon
-	float		operator[](int index) const;			// subscript operator v[0], v[1]
-	float&		operator[](int index);					// subscript operator v[0], v[1]
+	constexpr Matrix2     operator+(const Matrix2& rhs) const;   //add rhs
+	constexpr Matrix2     operator-(const Matrix2& rhs) const;   //subtract rhs
+	constexpr Matrix2&	operator+=(const Matrix2& rhs);  //add rhs and update this matrix
+	constexpr Matrix2&	operator-=(const Matrix2& rhs);  //subtract rhs and update this matrix
+	constexpr Vector2     operator*(const Vector2& rhs) const;   // multiplication: v' = M * v
+	constexpr Matrix2     operator*(const Matrix2& rhs) const;  // multiplication: M3 = M1 * M2
+	constexpr Matrix2&	operator*=(const Matrix2& rhs); // multiplication: M1' = M1 * M2
+
+	constexpr bool		operator == (const Matrix2& rhs) const;   // exact compare, no epsilon
+	constexpr bool		operator != (const Matrix2& rhs) const;   // exact compare, no epsilon
+	constexpr float		operator[](int index) const;			// subscript operator v[0], v[1]
+	constexpr float&		operator[](int index);					// subscript operator v[0], v[1]
 
 	//friends functions
-	friend Matrix2 operator-(const Matrix2& m);                        // unary operator (-)
-	friend Matrix2 operator*(float scalar, const Matrix2& m);          // pre-multiplication
-	friend Vector2 operator*(const Vector2& vec, const Matrix2& m);    // v' = v * M
+	friend constexpr Matrix2 operator-(const Matrix2& m);                        // unary operator (-)
+	friend constexpr Matrix2 operator*(float scalar, const Matrix2& m);          // pre-multiplication
+	friend constexpr Vector2 operator*(const Vector2& vec, const Matrix2& m);    // v' = v * M
 	friend std::ostream& operator<<(std::ostream& os, const Matrix2& m);
 
 protected:
 
 private:
+	constexpr void clearTranspose(); //init tm in constant expressions
+
 	float m[4];
 	float tm[4]; //transpose matrix
 };
@@ -83,59 +139,62 @@ private:
 // 3x3 matrix
 ///////////////////////////////////////////////////////////////////////////
 
-class Matrix3
+template <>
+class Matrix<float, 3, 3>
 {
 public:
 	//constructors
-	Matrix3();  //init with identity
-	Matrix3(const float src[9]);
-	Matrix3(float m0, float m1, float m2,   //1st column
+	constexpr Matrix();  //init with identity
+	constexpr Matrix(const float src[9]);
+	constexpr Matrix(float m0, float m1, float m2,   //1st column
 		float m3, float m4, float m5,	//2nd column
 		float m6, float m7, float m8);  //3rd column
 
-	void        set(const float src[9]);
-	void        set(float m0, float m1, float m2,   //1st column
+	constexpr void        set(const float src[9]);
+	constexpr void        set(float m0, float m1, float m2,   //1st column
 		float m3, float m4, float m5,	//2nd column
 		float m6, float m7, float m8);  //3rd column
 
-	void        setRow(int index, const float row[3]);
-	void        setRow(int index, const Vector3& v);
-	void        setColumn(int index, const float col[3]);
-	void        setColumn(int index, const Vector3& v);
+	constexpr void        setRow(int index, const float row[3]);
+	constexpr void        setRow(int index, const Vector3& v);
+	constexpr void        setColumn(int index, const float col[3]);
+	constexpr void        setColumn(int index, const Vector3& v);
 
-	const float* get() const;
-	const float* getTranspose(); //return transposed matrix
-	Vector3    getRow(int index) const;
-	Vector3    getColumn(int index) const;
+	constexpr const float* get() const;
+	constexpr const float* getTranspose(); //return transposed matrix
+	constexpr Vector3    getRow(int index) const;
+	constexpr Vector3    getColumn(int index) const;
 	float       getDeterminant() const;
 	Vector3 getAngle() const;  //return (pitch, yaw, roll) in degree
-	Matrix3& identity();
-	Matrix3& transpose();           //transpose itself and return reference
+	constexpr Matrix3& identity();
+	constexpr Matrix3& transpose();           //transpose itself and return reference
 	Matrix3& invert();
 
 	//operators
-	Matrix3     operator+(const Matrix3& rhs) const;   //add rhs
-	Matrix3     operator-(const Matrix3& rhs) const;   //subtract rhs
-	Matrix3&	operator+=(const Matrix3& rhs);  //add rhs and update this matrix
-	Matrix3&	operator-=(const Matrix3& rhs);  //subtract rhs and update this matrix
-	Vector3		operator*(const Vector3& rhs) const;   // multiplication: v' = M * v
-	Matrix3     operator*(const Matrix3& rhs) const;  // multiplication: M3 = M1 * M2
-	Matrix3&	operator*=(const Matrix3& rhs); // multiplication: M1' = M1 * M2
-
-	bool		operator == (const Matrix3& rhs) const;   // exact compare, no epsilon
-	bool		operator != (const Matrix3& rhs) const;   // exact compare, no epsilon
-	float		operator[](int index) const;			// subscript operator v[0], v[1], v[2]
-	float&		operator[](int index);					// subscript operator v[0], v[1], v[2]
+	constexpr Matrix3     operator+(const Matrix3& rhs) const;   //add rhs
+	constexpr Matrix3     operator-(const Matrix3& rhs) const;   //subtract rhs
+	constexpr Matrix3&	operator+=(const Matrix3& rhs);  //add rhs and update this matrix
+	constexpr Matrix3&	operator-=(const Matrix3& rhs);  //subtract rhs and update this matrix
+	constexpr Vector3		operator*(const Vector3& rhs) const;   // multiplication: v' = M * v
+	constexpr Matrix3     operator*(const Matrix3& rhs) const;  // multiplication: M3 = M1 * M2
+	constexpr Matrix3&	operator*=(const Matrix3& rhs); // multiplication: M1' = M1 * M2
+
+	constexpr bool		operator == (const Matrix3& rhs) const;   // exact compare, no epsilon
+	constexpr bool		operator != (const Matrix3& rhs) const;   // exact compare, no epsilon
+	constexpr float		operator[](int index) const;			// subscript operator v[0], v[1], v[2]
+	constexpr float&		operator[](int index);					// subscript operator v[0], v[1], v[2]
 
 	//friends functions
-	friend Matrix3 operator-(const Matrix3& m);                        // unary operator (-)
-	friend Matrix3 operator*(float scalar, const Matrix3& m);          // pre-multiplication
-	friend Vector3 operator*(const Vector3& vec, const Matrix3& m);    // v' = v * M
+	friend constexpr Matrix3 operator-(const Matrix3& m);                        // unary operator (-)
+	friend constexpr Matrix3 operator*(float scalar, const Matrix3& m);          // pre-multiplication
+	friend constexpr Vector3 operator*(const Vector3& vec, const Matrix3& m);    // v' = v * M
 	friend std::ostream& operator<<(std::ostream& os, const Matrix3& m);
 
 protected:
 
 private:
+	constexpr void clearTranspose(); //init tm in constant expressions
+
 	float m[9];
 	float tm[9]; //transpose matrix
 };
@@ -145,47 +204,48 @@ private:
 // 4x4 matrix
 ///////////////////////////////////////////////////////////////////////////
 
-class Matrix4
+template <>
+class Matrix<float, 4, 4>
 {
 public:
 	//constructors
-	Matrix4();  //init with identity
-	Matrix4(const float src[16]);
-	Matrix4(float m0, float m1, float m2, float m3,   //1st column
+	constexpr Matrix();  //init with identity
+	constexpr Matrix(const float src[16]);
+	constexpr Matrix(float m0, float m1, float m2, float m3,   //1st column
 		float m4, float m5, float m6, float m7,	//2nd column
 		float m8, float m9, float m10, float m11,  //3rd column
 		float m12, float m13, float m14, float m15); //4th column
 
-	void        set(const float src[16]);
-	void        set(float m0, float m1, float m2, float m3,   //1st column
+	constexpr void        set(const float src[16]);
+	constexpr void        set(float m0, float m1, float m2, float m3,   //1st column
 		float m4, float m5, float m6, float m7,	//2nd column
 		float m8, float m9, float m10, float m11,  //3rd column
 		float m12, float m13, float m14, float m15); //4th column
-	void        setRow(int index, const float row[4]);
-	void        setRow(int index, const Vector4& v);
-	void	    setRow(int index, const Vector3& v);
-	void        setColumn(int index, const float col[4]);
-	void        setColumn(int index, const Vector4& v);
-	void		setColumn(int index, const Vector3& v);
-
-
-	const float* get() const;
-	const float* getTranspose(); //return transposed matrix
-	Vector4    getRow(int index) const; //return the selected row vector
-	Vector4    getColumn(int index) const; //return the selected column vector
+	constexpr void        setRow(int index, const float row[4]);
+	constexpr void        setRow(int index, const Vector4& v);
+	constexpr void	    setRow(int index, const Vector3& v);
+	constexpr void        setColumn(int index, const float col[4]);
+	constexpr void        setColumn(int index, const Vector4& v);
+	constexpr void		setColumn(int index, const Vector3& v);
+
+
+	constexpr const float* get() const;
+	constexpr const float* getTranspose(); //return transposed matrix
+	constexpr Vector4    getRow(int index) const; //return the selected row vector
+	constexpr Vector4    getColumn(int index) const; //return the selected column vector
 	float       getDeterminant() const;
 	Vector3 getAngle()  const;  //return (pitch, yaw, roll) in degree
-	Vector3 getLeftAxis() const; //return the left axis
-	Vector3 getUpAxis() const; //return the up axis
-	Vector3 getForwardAxis() const; //return the forward axis
+	constexpr Vector3 getLeftAxis() const; //return the left axis
+	constexpr Vector3 getUpAxis() const; //return the up axis
+	constexpr Vector3 getForwardAxis() const; //return the forward axis
 
-	Matrix4& identity();
-	Matrix4& transpose();           //transpose itself and return reference
+	constexpr Matrix4& identity();
+	constexpr Matrix4& transpose();           //transpose itself and return reference
 	Matrix4& invert();   	//check best inverse method before inverse
 	Matrix4& invertEuclidean(); //inverse of Euclidean transform matrix //ŷñ任
 	Matrix4& invertAffine();    //inverse of affine transform matrix    //任
 	Matrix4& invertProjective(); //inverse of projective matrix          //ͶӰ
-	Matrix4& invertGeneral();    //inverse of generic matrix             //ͨþ
+	Matrix4& invertGeneral(float* determinant = 0); //inverse of generic matrix, optionally return the determinant             //ͨþ
 
 	//transform matrix
 	Matrix4& translate(float x, float y, float z); //translation by (x, y, z)
@@ -202,33 +262,52 @@ public:
 	Matrix4& lookAt(const Vector3& target);
 	Matrix4& lookAt(const Vector3& target, const Vector3& up);
 
+	//build transform matrix from translation, rotation(unit quaternion) and scale in a single pass
+	static Matrix4 fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale); //M = T*R*S
+	static Matrix4 fromInverseTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale); //M^-1 = S^-1*R^T*T^-1
+	static void fromTRS(const Vector3* translations, const Quaternion* rotations, const Vector3* scales,
+		float* palette, int count); //write count column-major matrices (16 floats each) to palette
+	static void fromTRS(const Vector3* translations, const Quaternion* rotations, const Vector3* scales,
+		Matrix4* matrices, int count); //same, to an array of Matrix4
+
+	//split affine matrix into translation, rotation(unit quaternion) and scale, M = T*R*S
+	//return false if the matrix has shear, projection or zero scale
+	bool decompose(Vector3& translation, Quaternion& rotation, Vector3& scale) const;
+	static int decompose(const Matrix4* matrices, Vector3* translations, Quaternion* rotations, Vector3* scales,
+		int count, bool* valid = 0); //return the number of matrices that cannot be decomposed exactly
+
+	//general inverse of array of matrices, singular[i] is true if matrices[i] has no inverse (then identity)
+	static int invert(const Matrix4* matrices, Matrix4* inverses, int count, bool* singular = 0); //return the number of singular matrices
+
+	//products of arrays of matrices, out[i] = a[i] * b[i], out may be a or b
+	static void multiply(const Matrix4* a, const Matrix4* b, Matrix4* out, int count);
+
 	//operators
-	Matrix4     operator+(const Matrix4& rhs) const;   //add rhs
-	Matrix4     operator-(const Matrix4& rhs) const;   //subtract rhs
-	Matrix4&	operator+=(const Matrix4& rhs);  //add rhs and update this matrix
-	Matrix4&	operator-=(const Matrix4& rhs);  //subtract rhs and update this matrix
-	Vector4		operator*(const Vector4& rhs) const;   // multiplication: v' = M * v
-	Vector3		operator*(const Vector3& rhs) const;   // multiplication: v' = M * v
-	Matrix4     operator*(const Matrix4& rhs) const;  // multiplication: M3 = M1 * M2
-	Matrix4&	operator*=(const Matrix4& rhs); // multiplication: M1' = M1 * M2
-
-	bool		operator == (const Matrix4& rhs) const;   // exact compare, no epsilon
-	bool		operator != (const Matrix4& rhs) const;   // exact compare, no epsilon
-	float		operator[](int index) const;			// subscript operator v[0], v[1], v[2], v[3]
-	float&		operator[](int index);					// subscript operator v[0], v[1], v[2], v[3]
+	constexpr Matrix4     operator+(const Matrix4& rhs) const;   //add rhs
+	constexpr Matrix4     operator-(const Matrix4& rhs) const;   //subtract rhs
+	constexpr Matrix4&	operator+=(const Matrix4& rhs);  //add rhs and update this matrix
+	constexpr Matrix4&	operator-=(const Matrix4& rhs);  //subtract rhs and update this matrix
+	constexpr Vector4		operator*(const Vector4& rhs) const;   // multiplication: v' = M * v
+	constexpr Vector3		operator*(const Vector3& rhs) const;   // multiplication: v' = M * v
+	constexpr Matrix4     operator*(const Matrix4& rhs) const;  // multiplication: M3 = M1 * M2
+	constexpr Matrix4&	operator*=(const Matrix4& rhs); // multiplication: M1' = M1 * M2
+
+	constexpr bool		operator == (const Matrix4& rhs) const;   // exact compare, no epsilon
+	constexpr bool		operator != (const Matrix4& rhs) const;   // exact compare, no epsilon
+	constexpr float		operator[](int index) const;			// subscript operator v[0], v[1], v[2], v[3]
+	constexpr float&		operator[](int index);					// subscript operator v[0], v[1], v[2], v[3]
 	//friends functions
-	friend Matrix4 operator-(const Matrix4& m);                        // unary operator (-)
-	friend Matrix4 operator*(float scalar, const Matrix4& m);          // pre-multiplication
-	friend Vector4 operator*(const Vector4& vec, const Matrix4& m);    // v' = v * M
-	friend Vector3 operator*(const Vector3& vec, const Matrix4& m);    // v' = v * M
+	friend constexpr Matrix4 operator-(const Matrix4& m);                        // unary operator (-)
+	friend constexpr Matrix4 operator*(float scalar, const Matrix4& m);          // pre-multiplication
+	friend constexpr Vector4 operator*(const Vector4& vec, const Matrix4& m);    // v' = v * M
+	friend constexpr Vector3 operator*(const Vector3& vec, const Matrix4& m);    // v' = v * M
 	friend std::ostream& operator<<(std::ostream& os, const Matrix4& m);
 protected:
 private:
-	float getCofactor(float m0, float m1, float m2,
-		float m3, float m4, float m5,
-		float m6, float m7, float m8) const;
 
 
+	constexpr void clearTranspose(); //init tm in constant expressions
+
 	float m[16];
 	float tm[16]; //transpose matrix
 };
@@ -237,150 +316,170 @@ private:
 // inline functions for Matrix2
 ///////////////////////////////////////////////////////////////////////////
 
-inline Matrix2::Matrix2()
+constexpr Matrix2::Matrix()
 {
+	clearTranspose();
 	identity();
 }
 
-inline Matrix2::Matrix2(const float src[4])
+constexpr Matrix2::Matrix(const float src[4])
 {
+	clearTranspose();
 	set(src);
 }
 
-inline Matrix2::Matrix2(float m0, float m1, float m2, float m3)
+constexpr Matrix2::Matrix(float m0, float m1, float m2, float m3)
 {
+	clearTranspose();
 	set(m0, m1, m2, m3);
 }
 
-inline void Matrix2::set(const float src[4])
+constexpr void Matrix2::set(const float src[4])
 {
 	m[0] = src[0]; m[1] = src[1]; m[2] = src[2]; m[3] = src[3];
 }
 
-inline void Matrix2::set(float m0, float m1, float m2, float m3)
+constexpr void Matrix2::set(float m0, float m1, float m2, float m3)
 {
 	m[0] = m0; m[1] = m1; m[2] = m2; m[3] = m3;
 }
 
-inline void Matrix2::setRow(int index, const float row[2])
+constexpr void Matrix2::setRow(int index, const float row[2])
 {
 	m[index] = row[0]; m[index + 2] = row[1];
 }
 
-inline void Matrix2::setRow(int index, const Vector2& v)
+constexpr void Matrix2::setRow(int index, const Vector2& v)
 {
 	m[index] = v.x; m[index + 2] = v.y;
 }
 
-inline void Matrix2::setColumn(int index, const float col[2])
+constexpr void Matrix2::setColumn(int index, const float col[2])
 {
 	m[index * 2] = col[0];  m[index * 2 + 1] = col[1];
 }
 
-inline void Matrix2::setColumn(int index, const Vector2& v)
+constexpr void Matrix2::setColumn(int index, const Vector2& v)
 {
 	m[index * 2] = v.x;  m[index * 2 + 1] = v.y;
 }
 
-inline const float* Matrix2::get() const
+constexpr const float* Matrix2::get() const
 {
 	return m;
 }
 
-inline const float* Matrix2::getTranspose()
+constexpr const float* Matrix2::getTranspose()
 {
 	tm[0] = m[0];   tm[2] = m[1];
 	tm[1] = m[2];   tm[3] = m[3];
 	return tm;
 }
 
-inline Vector2 Matrix2::getRow(int index) const
+constexpr Vector2 Matrix2::getRow(int index) const
 {
 	return Vector2(m[index], m[index + 2]);
 }
 
-inline Vector2 Matrix2::getColumn(int index) const
+constexpr Vector2 Matrix2::getColumn(int index) const
 {
 	return Vector2(m[index * 2], m[index * 2 + 1]);
 }
 
-inline Matrix2& Matrix2::identity()
+constexpr Matrix2& Matrix2::identity()
 {
 	m[0] = m[3] = 1.0f;
 	m[1] = m[2] = 0.0f;
 	return *this;
 }
 
-inline Matrix2 Matrix2::operator +(const Matrix2& rhs) const
+constexpr Matrix2& Matrix2::transpose()
+{
+	std::swap(m[1], m[2]);
+	return *this;
+}
+
+// tm is only the buffer of getTranspose(), so it is left uninitialized at run
+// time, but all members must be initialized in a constant expression.
+constexpr void Matrix2::clearTranspose()
+{
+	if (std::is_constant_evaluated())
+	{
+		for (int i = 0; i < 4; ++i)
+			tm[i] = 0;
+	}
+}
+
+constexpr Matrix2 Matrix2::operator +(const Matrix2& rhs) const
 {
 	return Matrix2(m[0] + rhs[0], m[1] + rhs[1], m[2] + rhs[2], m[3] + rhs[3]);
 }
 
-inline Matrix2 Matrix2::operator -(const Matrix2& rhs) const
+constexpr Matrix2 Matrix2::operator -(const Matrix2& rhs) const
 {
 	return Matrix2(m[0] - rhs[0], m[1] - rhs[1], m[2] - rhs[2], m[3] - rhs[3]);
 }
 
-inline Matrix2& Matrix2::operator +=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator +=(const Matrix2& rhs)
 {
 	m[0] += rhs[0]; m[1] += rhs[1]; m[2] += rhs[2]; m[3] += rhs[3];
 	return *this;
 }
 
-inline Matrix2& Matrix2::operator -=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator -=(const Matrix2& rhs)
 {
 	m[0] -= rhs[0]; m[1] -= rhs[1]; m[2] -= rhs[2]; m[3] -= rhs[3];
 	return *this;
 }
 
-inline Vector2 Matrix2::operator *(const Vector2& rhs) const
+constexpr Vector2 Matrix2::operator *(const Vector2& rhs) const
 {
 	return Vector2(m[0] * rhs.x + m[2] * rhs.y, m[1] * rhs.x + m[3] * rhs.y);
 }
 
-inline Matrix2 Matrix2::operator *(const Matrix2& rhs) const
+constexpr Matrix2 Matrix2::operator *(const Matrix2& rhs) const
 {
 	return Matrix2(m[0] * rhs[0] + m[2] * rhs[1], m[1] * rhs[0] + m[3] * rhs[1],
 		m[0] * rhs[2] + m[2] * rhs[3], m[1] * rhs[2] + m[3] * rhs[3]);
 }
 
-inline Matrix2& Matrix2::operator *=(const Matrix2& rhs)
+constexpr Matrix2& Matrix2::operator *=(const Matrix2& rhs)
 {
 	*this = *this * rhs;
 	return *this;
 }
 
-inline bool Matrix2::operator == (const Matrix2& rhs) const
+constexpr bool Matrix2::operator == (const Matrix2& rhs) const
 {
 	return (m[0] == rhs[0]) && (m[1] == rhs[1]) && (m[2] == rhs[2]) && (m[3] == rhs[3]);
 }
 
-inline bool Matrix2::operator != (const Matrix2& rhs) const
+constexpr bool Matrix2::operator != (const Matrix2& rhs) const
 {
 	return (m[0] != rhs[0]) || (m[1] != rhs[1]) || (m[2] != rhs[2]) || (m[3] != rhs[3]);
 }
 
-inline float Matrix2::operator[](int index) const
+constexpr float Matrix2::operator[](int index) const
 {
 	return m[index];
 }
 
-inline float& Matrix2::operator[](int index)
+constexpr float& Matrix2::operator[](int index)
 {
 	return m[index];
 }
 
-inline Matrix2 operator -(const Matrix2& rhs)
+constexpr Matrix2 operator -(const Matrix2& rhs)
 {
 	return Matrix2(-rhs[0], -rhs[1], -rhs[2], -rhs[3]);
 }
 
-inline Matrix2 operator *(float scalar, const Matrix2& rhs)
+constexpr Matrix2 operator *(float scalar, const Matrix2& rhs)
 {
 	return Matrix2(scalar * rhs[0], scalar * rhs[1], scalar * rhs[2], scalar * rhs[3]);
 }
 
-inline Vector2 operator *(const Vector2& vec, const Matrix2& rhs)
+constexpr Vector2 operator *(const Vector2& vec, const Matrix2& rhs)
 {
 	return Vector2(vec.x * rhs[0] + vec.y * rhs[1], vec.x * rhs[2] + vec.y * rhs[3]);
 }
@@ -400,61 +499,64 @@ inline std::ostream& operator<<(std::ostream& os, const Matrix2& m)
 ///////////////////////////////////////////////////////////////////////////
 // inline functions for Matrix3
 ///////////////////////////////////////////////////////////////////////////
-inline Matrix3::Matrix3()
+constexpr Matrix3::Matrix()
 {
+	clearTranspose();
 	identity();
 }
 
-inline Matrix3::Matrix3(const float src[9])
+constexpr Matrix3::Matrix(const float src[9])
 {
+	clearTranspose();
 	set(src);
 }
 
-inline Matrix3::Matrix3(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8)
+constexpr Matrix3::Matrix(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8)
 {
+	clearTranspose();
 	set(m0, m1, m2, m3, m4, m5, m6, m7, m8);
 }
 
-inline void Matrix3::set(const float src[9])
+constexpr void Matrix3::set(const float src[9])
 {
 	m[0] = src[0]; m[1] = src[1]; m[2] = src[2];
 	m[3] = src[3]; m[4] = src[4]; m[5] = src[5];
 	m[6] = src[6]; m[7] = src[7]; m[8] = src[8];
 }
 
-inline void Matrix3::set(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8)
+constexpr void Matrix3::set(float m0, float m1, float m2, float m3, float m4, float m5, float m6, float m7, float m8)
 {
 	m[0] = m0; m[1] = m1; m[2] = m2;
 	m[3] = m3; m[4] = m4; m[5] = m5;
 	m[6] = m6; m[7] = m7; m[8] = m8;
 }
 
-inline void Matrix3::setRow(int index, const float row[3])
+constexpr void Matrix3::setRow(int index, const float row[3])
 {
 	m[index] = row[0]; m[index + 3] = row[1]; m[index + 6] = row[2];
 }
 
-inline void Matrix3::setRow(int index, const Vector3& v)
+constexpr void Matrix3::setRow(int index, const Vector3& v)
 {
 	m[index] = v.x; m[index + 3] = v.y; m[index + 6] = v.z;
 }
 
-inline void Matrix3::setColumn(int index, const float col[3])
+constexpr void Matrix3::setColumn(int index, const float col[3])
 {
 	m[index * 3] = col[0];  m[index * 3 + 1] = col[1];  m[index * 3 + 2] = col[2];
 }
 
-inline void Matrix3::setColumn(int index, const Vector3& v)
+constexpr void Matrix3::setColumn(int index, const Vector3& v)
 {
 	m[index * 3] = v.x;  m[index * 3 + 1] = v.y;  m[index * 3 + 2] = v.z;
 }
 
-inline const float* Matrix3::get() const
+constexpr const float* Matrix3::get() const
 {
 	return m;
 }
 
-inline const float* Matrix3::getTranspose()
+constexpr const float* Matrix3::getTranspose()
 {
 	tm[0] = m[0]; tm[1] = m[3]; tm[2] = m[6];
 	tm[3] = m[1]; tm[4] = m[4]; tm[5] = m[7];
@@ -462,38 +564,57 @@ inline const float* Matrix3::getTranspose()
 	return tm;
 }
 
-inline Vector3 Matrix3::getRow(int index) const
+constexpr Vector3 Matrix3::getRow(int index) const
 {
 	return Vector3(m[index], m[index + 3], m[index + 6]);
 }
 
-inline Vector3 Matrix3::getColumn(int index) const
+constexpr Vector3 Matrix3::getColumn(int index) const
 {
 	return Vector3(m[index * 3], m[index * 3 + 1], m[index * 3 + 2]);
 }
 
-inline Matrix3& Matrix3::identity()
+constexpr Matrix3& Matrix3::identity()
 {
 	m[0] = m[4] = m[8] = 1.0f;
 	m[1] = m[2] = m[3] = m[5] = m[6] = m[7] = 0.0f;
 	return *this;
 }
 
-inline Matrix3 Matrix3::operator +(const Matrix3& rhs) const
+constexpr Matrix3& Matrix3::transpose()
+{
+	std::swap(m[1], m[3]);
+	std::swap(m[2], m[6]);
+	std::swap(m[5], m[7]);
+	return *this;
+}
+
+// tm is only the buffer of getTranspose(), so it is left uninitialized at run
+// time, but all members must be initialized in a constant expression.
+constexpr void Matrix3::clearTranspose()
+{
+	if (std::is_constant_evaluated())
+	{
+		for (int i = 0; i < 9; ++i)
+			tm[i] = 0;
+	}
+}
+
+constexpr Matrix3 Matrix3::operator +(const Matrix3& rhs) const
 {
 	return Matrix3(m[0] + rhs[0], m[1] + rhs[1], m[2] + rhs[2],
 		m[3] + rhs[3], m[4] + rhs[4], m[5] + rhs[5],
 		m[6] + rhs[6], m[7] + rhs[7], m[8] + rhs[8]);
 }
 
-inline Matrix3 Matrix3::operator -(const Matrix3& rhs) const
+constexpr Matrix3 Matrix3::operator -(const Matrix3& rhs) const
 {
 	return Matrix3(m[0] - rhs[0], m[1] - rhs[1], m[2] - rhs[2],
 		m[3] - rhs[3], m[4] - rhs[4], m[5] - rhs[5],
 		m[6] - rhs[6], m[7] - rhs[7], m[8] - rhs[8]);
 }
 
-inline Matrix3& Matrix3::operator +=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator +=(const Matrix3& rhs)
 {
 	m[0] += rhs[0]; m[1] += rhs[1]; m[2] += rhs[2];
 	m[3] += rhs[3]; m[4] += rhs[4]; m[5] += rhs[5];
@@ -501,7 +622,7 @@ inline Matrix3& Matrix3::operator +=(const Matrix3& rhs)
 	return *this;
 }
 
-inline Matrix3& Matrix3::operator -=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator -=(const Matrix3& rhs)
 {
 	m[0] -= rhs[0]; m[1] -= rhs[1]; m[2] -= rhs[2];
 	m[3] -= rhs[3]; m[4] -= rhs[4]; m[5] -= rhs[5];
@@ -509,15 +630,23 @@ inline Matrix3& Matrix3::operator -=(const Matrix3& rhs)
 	return *this;
 }
 
-inline Vector3 Matrix3::operator *(const Vector3& rhs) const
+constexpr Vector3 Matrix3::operator *(const Vector3& rhs) const
 {
 	return Vector3(m[0] * rhs.x + m[3] * rhs.y + m[6] * rhs.z,
 		m[1] * rhs.x + m[4] * rhs.y + m[7] * rhs.z,
 		m[2] * rhs.x + m[5] * rhs.y + m[8] * rhs.z);
 }
 
-inline Matrix3 Matrix3::operator *(const Matrix3& rhs) const
+constexpr Matrix3 Matrix3::operator *(const Matrix3& rhs) const
 {
+#ifdef GIL_SSE
+	if (!std::is_constant_evaluated())
+	{
+		float dst[12];
+		Gil::multiplyMatrix3(m, rhs.m, dst);
+		return Matrix3(dst);
+	}
+#endif
 	return Matrix3(m[0] * rhs[0] + m[3] * rhs[1] + m[6] * rhs[2], 
 		m[1] * rhs[0] + m[4] * rhs[1] + m[7] * rhs[2], 
 		m[2] * rhs[0] + m[5] * rhs[1] + m[8] * rhs[2],
@@ -529,51 +658,51 @@ inline Matrix3 Matrix3::operator *(const Matrix3& rhs) const
 		m[2] * rhs[6] + m[5] * rhs[7] + m[8] * rhs[8]);
 }
 
-inline Matrix3& Matrix3::operator *=(const Matrix3& rhs)
+constexpr Matrix3& Matrix3::operator *=(const Matrix3& rhs)
 {
 	*this = *this * rhs;
 	return *this;
 }
 
-inline bool Matrix3::operator == (const Matrix3& rhs) const
+constexpr bool Matrix3::operator == (const Matrix3& rhs) const
 {
 	return (m[0] == rhs[0]) && (m[1] == rhs[1]) && (m[2] == rhs[2]) &&
 		(m[3] == rhs[3]) && (m[4] == rhs[4]) && (m[5] == rhs[5]) &&
 		(m[6] == rhs[6]) && (m[7] == rhs[7]) && (m[8] == rhs[8]);
 }
 
-inline bool Matrix3::operator != (const Matrix3& rhs) const
+constexpr bool Matrix3::operator != (const Matrix3& rhs) const
 {
 	return (m[0] != rhs[0]) || (m[1] != rhs[1]) || (m[2] != rhs[2]) ||
 		(m[3] != rhs[3]) || (m[4] != rhs[4]) || (m[5] != rhs[5]) ||
 		(m[6] != rhs[6]) || (m[7] != rhs[7]) || (m[8] != rhs[8]);
 }
 
-inline float Matrix3::operator[](int index) const
+constexpr float Matrix3::operator[](int index) const
 {
 	return m[index];
 }
 
-inline float& Matrix3::operator[](int index)
+constexpr float& Matrix3::operator[](int index)
 {
 	return m[index];
 }
 
-inline Matrix3 operator -(const Matrix3& rhs)
+constexpr Matrix3 operator -(const Matrix3& rhs)
 {
 	return Matrix3(-rhs[0], -rhs[1], -rhs[2],
 		-rhs[3], -rhs[4], -rhs[5],
 		-rhs[6], -rhs[7], -rhs[8]);
 }
 
-inline Matrix3 operator *(float scalar, const Matrix3& rhs)
+constexpr Matrix3 operator *(float scalar, const Matrix3& rhs)
 {
 	return Matrix3(scalar * rhs[0], scalar * rhs[1], scalar * rhs[2],
 		scalar * rhs[3], scalar * rhs[4], scalar * rhs[5],
 		scalar * rhs[6], scalar * rhs[7], scalar * rhs[8]);
 }
 
-inline Vector3 operator *(const Vector3& vec, const Matrix3& rhs)
+constexpr Vector3 operator *(const Vector3& vec, const Matrix3& rhs)
 {
 	return Vector3(vec.x * rhs[0] + vec.y * rhs[3] + vec.z * rhs[6],
 		vec.x * rhs[1] + vec.y * rhs[4] + vec.z * rhs[7],
@@ -595,25 +724,28 @@ inline std::ostream& operator<<(std::ostream& os, const Matrix3& m)
 ///////////////////////////////////////////////////////////////////////////
 // inline functions for Matrix4
 ///////////////////////////////////////////////////////////////////////////
-inline Matrix4::Matrix4()
+constexpr Matrix4::Matrix()
 {
+	clearTranspose();
 	identity();
 }
 
-inline Matrix4::Matrix4(const float src[16])
+constexpr Matrix4::Matrix(const float src[16])
 {
+	clearTranspose();
 	set(src);
 }
 
-inline Matrix4::Matrix4(float m0, float m1, float m2, float m3,
+constexpr Matrix4::Matrix(float m0, float m1, float m2, float m3,
 	float m4, float m5, float m6, float m7,
 	float m8, float m9, float m10, float m11,
 	float m12, float m13, float m14, float m15)
 {
+	clearTranspose();
 	set(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15);
 }
 
-inline void Matrix4::set(const float src[16])
+constexpr void Matrix4::set(const float src[16])
 {
 	m[0] = src[0]; m[1] = src[1]; m[2] = src[2]; m[3] = src[3];
 	m[4] = src[4]; m[5] = src[5]; m[6] = src[6]; m[7] = src[7];
@@ -621,7 +753,7 @@ inline void Matrix4::set(const float src[16])
 	m[12] = src[12]; m[13] = src[13]; m[14] = src[14]; m[15] = src[15];
 }
 
-inline void Matrix4::set(float m0, float m1, float m2, float m3,
+constexpr void Matrix4::set(float m0, float m1, float m2, float m3,
 	float m4, float m5, float m6, float m7,
 	float m8, float m9, float m10, float m11,
 	float m12, float m13, float m14, float m15)
@@ -632,42 +764,42 @@ inline void Matrix4::set(float m0, float m1, float m2, float m3,
 	m[12] = m12; m[13] = m13; m[14] = m14; m[15] = m15;
 }
 
-inline void Matrix4::setRow(int index, const float row[4])
+constexpr void Matrix4::setRow(int index, const float row[4])
 {
 	m[index] = row[0]; m[index + 4] = row[1]; m[index + 8] = row[2]; m[index + 12] = row[3];
 }
 
-inline void Matrix4::setRow(int index, const Vector4& v)
+constexpr void Matrix4::setRow(int index, const Vector4& v)
 {
 	m[index] = v.x; m[index + 4] = v.y; m[index + 8] = v.z; m[index + 12] = v.w;
 }
 
-inline void Matrix4::setRow(int index, const Vector3& v)
+constexpr void Matrix4::setRow(int index, const Vector3& v)
 {
 	m[index] = v.x; m[index + 4] = v.y; m[index + 8] = v.z;
 }
 
-inline void Matrix4::setColumn(int index, const float col[4])
+constexpr void Matrix4::setColumn(int index, const float col[4])
 {
 	m[index * 4] = col[0];  m[index * 4 + 1] = col[1];  m[index * 4 + 2] = col[2];  m[index * 4 + 3] = col[3];
 }
 
-inline void Matrix4::setColumn(int index, const Vector4& v)
+constexpr void Matrix4::setColumn(int index, const Vector4& v)
 {
 	m[index * 4] = v.x;  m[index * 4 + 1] = v.y;  m[index * 4 + 2] = v.z;  m[index * 4 + 3] = v.w;
 }
 
-inline void Matrix4::setColumn(int index, const Vector3& v)
+constexpr void Matrix4::setColumn(int index, const Vector3& v)
 {
 	m[index * 4] = v.x;  m[index * 4 + 1] = v.y;  m[index * 4 + 2] = v.z;
 }
 
-inline const float* Matrix4::get() const
+constexpr const float* Matrix4::get() const
 {
 	return m;
 }
 
-inline const float* Matrix4::getTranspose()
+constexpr const float* Matrix4::getTranspose()
 {
 	tm[0] = m[0]; tm[1] = m[4]; tm[2] = m[8]; tm[3] = m[12];
 	tm[4] = m[1]; tm[5] = m[5]; tm[6] = m[9]; tm[7] = m[13];
@@ -676,39 +808,61 @@ inline const float* Matrix4::getTranspose()
 	return tm;
 }
 
-inline Vector4 Matrix4::getRow(int index) const
+constexpr Vector4 Matrix4::getRow(int index) const
 {
 	return Vector4(m[index], m[index + 4], m[index + 8], m[index + 12]);
 }
 
-inline Vector4 Matrix4::getColumn(int index) const
+constexpr Vector4 Matrix4::getColumn(int index) const
 {
 	return Vector4(m[index * 4], m[index * 4 + 1], m[index * 4 + 2], m[index * 4 + 3]);
 }
 
-inline Vector3 Matrix4::getLeftAxis() const
+constexpr Vector3 Matrix4::getLeftAxis() const
 {
 	return Vector3(m[0], m[1], m[2]);
 }
 
-inline Vector3 Matrix4::getUpAxis() const
+constexpr Vector3 Matrix4::getUpAxis() const
 {
 	return Vector3(m[4], m[5], m[6]);
 }
 
-inline Vector3 Matrix4::getForwardAxis() const
+constexpr Vector3 Matrix4::getForwardAxis() const
 {
 	return Vector3(m[8], m[9], m[10]);
 }
 
-inline Matrix4& Matrix4::identity()
+constexpr Matrix4& Matrix4::identity()
 {
 	m[0] = m[5] = m[10] = m[15] = 1.0f;
 	m[1] = m[2] = m[3] = m[4] = m[6] = m[7] = m[8] = m[9] = m[11] = m[12] = m[13] = m[14] = 0.0f;
 	return *this;
 }
 
-inline Matrix4 Matrix4::operator +(const Matrix4& rhs) const
+constexpr Matrix4& Matrix4::transpose()
+{
+	std::swap(m[1], m[4]);
+	std::swap(m[2], m[8]);
+	std::swap(m[3], m[12]);
+	std::swap(m[6], m[9]);
+	std::swap(m[7], m[13]);
+	std::swap(m[11], m[14]);
+	return *this;
+}
+
+// tm is only the buffer of getTranspose(), so it is left uninitialized at run
+// time, but all members must be initialized in a constant expression.
+constexpr void Matrix4::clearTranspose()
+{
+	if (std::is_constant_evaluated())
+	{
+		for (int i = 0; i < 16; ++i)
+			tm[i] = 0;
+	}
+}
+
+constexpr Matrix4 Matrix4::operator +(const Matrix4& rhs) const
 {
 	return Matrix4(m[0] + rhs[0], m[1] + rhs[1], m[2] + rhs[2], m[3] + rhs[3],
 		m[4] + rhs[4], m[5] + rhs[5], m[6] + rhs[6], m[7] + rhs[7],
@@ -716,7 +870,7 @@ inline Matrix4 Matrix4::operator +(const Matrix4& rhs) const
 		m[12] + rhs[12], m[13] + rhs[13], m[14] + rhs[14], m[15] + rhs[15]);
 }
 
-inline Matrix4 Matrix4::operator -(const Matrix4& rhs) const
+constexpr Matrix4 Matrix4::operator -(const Matrix4& rhs) const
 {
 	return Matrix4(m[0] - rhs[0], m[1] - rhs[1], m[2] - rhs[2], m[3] - rhs[3],
 		m[4] - rhs[4], m[5] - rhs[5], m[6] - rhs[6], m[7] - rhs[7],
@@ -724,7 +878,7 @@ inline Matrix4 Matrix4::operator -(const Matrix4& rhs) const
 		m[12] - rhs[12], m[13] - rhs[13], m[14] - rhs[14], m[15] - rhs[15]);
 }
 
-inline Matrix4& Matrix4::operator +=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator +=(const Matrix4& rhs)
 {
 	m[0] += rhs[0]; m[1] += rhs[1]; m[2] += rhs[2]; m[3] += rhs[3];
 	m[4] += rhs[4]; m[5] += rhs[5]; m[6] += rhs[6]; m[7] += rhs[7];
@@ -733,7 +887,7 @@ inline Matrix4& Matrix4::operator +=(const Matrix4& rhs)
 	return *this;
 }
 
-inline Matrix4& Matrix4::operator -=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator -=(const Matrix4& rhs)
 {
 	m[0] -= rhs[0]; m[1] -= rhs[1]; m[2] -= rhs[2]; m[3] -= rhs[3];
 	m[4] -= rhs[4]; m[5] -= rhs[5]; m[6] -= rhs[6]; m[7] -= rhs[7];
@@ -742,7 +896,7 @@ inline Matrix4& Matrix4::operator -=(const Matrix4& rhs)
 	return *this;
 }
 
-inline Vector4 Matrix4::operator *(const Vector4& rhs) const
+constexpr Vector4 Matrix4::operator *(const Vector4& rhs) const
 {
 	return Vector4(m[0] * rhs.x + m[4] * rhs.y + m[8] * rhs.z + m[12] * rhs.w,
 		m[1] * rhs.x + m[5] * rhs.y + m[9] * rhs.z + m[13] * rhs.w,
@@ -750,15 +904,23 @@ inline Vector4 Matrix4::operator *(const Vector4& rhs) const
 		m[3] * rhs.x + m[7] * rhs.y + m[11] * rhs.z + m[15] * rhs.w);
 }
 
-inline Vector3 Matrix4::operator *(const Vector3& rhs) const
+constexpr Vector3 Matrix4::operator *(const Vector3& rhs) const
 {
 	return Vector3(m[0] * rhs.x + m[4] * rhs.y + m[8] * rhs.z + m[12],
 		m[1] * rhs.x + m[5] * rhs.y + m[9] * rhs.z + m[13],
 		m[2] * rhs.x + m[6] * rhs.y + m[10] * rhs.z + m[14]);
 }
 
-inline Matrix4 Matrix4::operator *(const Matrix4& rhs) const
+constexpr Matrix4 Matrix4::operator *(const Matrix4& rhs) const
 {
+#ifdef GIL_SSE
+	if (!std::is_constant_evaluated())
+	{
+		float dst[16];
+		Gil::multiplyMatrix4(m, rhs.m, dst);
+		return Matrix4(dst);
+	}
+#endif
 	return Matrix4(m[0] * rhs[0] + m[4] * rhs[1] + m[8] * rhs[2] + m[12] * rhs[3], 
 		m[1] * rhs[0] + m[5] * rhs[1] + m[9] * rhs[2] + m[13] * rhs[3], 
 		m[2] * rhs[0] + m[6] * rhs[1] + m[10] * rhs[2] + m[14] * rhs[3], 
@@ -777,13 +939,13 @@ inline Matrix4 Matrix4::operator *(const Matrix4& rhs) const
 		m[3] * rhs[12] + m[7] * rhs[13] + m[11] * rhs[14] + m[15] * rhs[15]);
 }
 
-inline Matrix4& Matrix4::operator *=(const Matrix4& rhs)
+constexpr Matrix4& Matrix4::operator *=(const Matrix4& rhs)
 {
 	*this = *this * rhs;
 	return *this;
 }
 
-inline bool Matrix4::operator == (const Matrix4& rhs) const
+constexpr bool Matrix4::operator == (const Matrix4& rhs) const
 {
 	return (m[0] == rhs[0]) && (m[1] == rhs[1]) && (m[2] == rhs[2]) && (m[3] == rhs[3]) &&
 		(m[4] == rhs[4]) && (m[5] == rhs[5]) && (m[6] == rhs[6]) && (m[7] == rhs[7]) &&
@@ -791,7 +953,7 @@ inline bool Matrix4::operator == (const Matrix4& rhs) const
 		(m[12] == rhs[12]) && (m[13] == rhs[13]) && (m[14] == rhs[14]) && (m[15] == rhs[15]);
 }
 
-inline bool Matrix4::operator != (const Matrix4& rhs) const
+constexpr bool Matrix4::operator != (const Matrix4& rhs) const
 {
 	return (m[0] != rhs[0]) || (m[1] != rhs[1]) || (m[2] != rhs[2]) || (m[3] != rhs[3]) ||
 		(m[4] != rhs[4]) || (m[5] != rhs[5]) || (m[6] != rhs[6]) || (m[7] != rhs[7]) ||
@@ -799,17 +961,17 @@ inline bool Matrix4::operator != (const Matrix4& rhs) const
 		(m[12] != rhs[12]) || (m[13] != rhs[13]) || (m[14] != rhs[14]) || (m[15] != rhs[15]);
 }
 
-inline float Matrix4::operator[](int index) const
+constexpr float Matrix4::operator[](int index) const
 {
 	return m[index];
 }
 
-inline float& Matrix4::operator[](int index)
+constexpr float& Matrix4::operator[](int index)
 {
 	return m[index];
 }
 
-inline Matrix4 operator -(const Matrix4& rhs)
+constexpr Matrix4 operator -(const Matrix4& rhs)
 {
 	return Matrix4(-rhs[0], -rhs[1], -rhs[2], -rhs[3],
 		-rhs[4], -rhs[5], -rhs[6], -rhs[7],
@@ -817,7 +979,7 @@ inline Matrix4 operator -(const Matrix4& rhs)
 		-rhs[12], -rhs[13], -rhs[14], -rhs[15]);
 }
 
-inline Matrix4 operator *(float scalar, const Matrix4& rhs)
+constexpr Matrix4 operator *(float scalar, const Matrix4& rhs)
 {
 	return Matrix4(scalar * rhs[0], scalar * rhs[1], scalar * rhs[2], scalar * rhs[3],
 		scalar * rhs[4], scalar * rhs[5], scalar * rhs[6], scalar * rhs[7],
@@ -825,7 +987,7 @@ inline Matrix4 operator *(float scalar, const Matrix4& rhs)
 		scalar * rhs[12], scalar * rhs[13], scalar * rhs[14], scalar * rhs[15]);
 }
 
-inline Vector4 operator *(const Vector4& vec, const Matrix4& rhs)
+constexpr Vector4 operator *(const Vector4& vec, const Matrix4& rhs)
 {
 	return Vector4(vec.x * rhs[0] + vec.y * rhs[4] + vec.z * rhs[8] + vec.w * rhs[12],
 		vec.x * rhs[1] + vec.y * rhs[5] + vec.z * rhs[9] + vec.w * rhs[13],
@@ -833,7 +995,7 @@ inline Vector4 operator *(const Vector4& vec, const Matrix4& rhs)
 		vec.x * rhs[3] + vec.y * rhs[7] + vec.z * rhs[11] + vec.w * rhs[15]);
 }
 
-inline Vector3 operator *(const Vector3& vec, const Matrix4& rhs)
+constexpr Vector3 operator *(const Vector3& vec, const Matrix4& rhs)
 {
 	return Vector3(vec.x * rhs[0] + vec.y * rhs[4] + vec.z * rhs[8] + rhs[12],
 		vec.x * rhs[1] + vec.y * rhs[5] + vec.z * rhs[9] + rhs[13],
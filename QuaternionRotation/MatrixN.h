@@ -0,0 +1,371 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// MatrixN.h
+// =========
+// Generic vector and matrix templates; Vector<T, N> and Matrix<T, R, C>
+//
+// Vector2/3/4 and Matrix2/3/4 are the float specializations of these
+// templates (Vectors.h, Matrices.h), so they keep their own API. The other
+// sizes and scalar types, for example Matrix<double, 4, 4> for long chains of
+// transform accumulation, use the generic versions here.
+// All operations are unrolled at compile time with Gil::unroll().
+//
+// The elements of the matrix are stored as column major order, same as
+// Matrix2/3/4. Element (row r, column c) is m[c * R + r].
+//
+// usage:
+//   Matrix<double, 4, 4> world;                   // identity
+//   for (...)
+//       world *= Matrix<double, 4, 4>(local[i]);  // accumulate in double
+//   Matrix4 m = world.cast<float>();              // back to float
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <utility>
+#include <iostream>
+#include <iomanip>
+#include "Vectors.h"
+#include "Matrices.h"
+
+namespace Gil
+{
+	///////////////////////////////////////////////////////////////////////////
+	// call f(0), f(1), ..., f(N-1) without loop
+	///////////////////////////////////////////////////////////////////////////
+	template <int N, class F>
+	constexpr void unroll(F f)
+	{
+		[&]<int... I>(std::integer_sequence<int, I...>) { (f(I), ...); }(std::make_integer_sequence<int, N>());
+	}
+} //end of namespace Gil
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// N-D vector
+///////////////////////////////////////////////////////////////////////////////
+template <class T, int N>
+struct Vector
+{
+	T v[N];
+
+	constexpr Vector() : v() {}
+	template <class... A>
+		requires (sizeof...(A) == N)
+	constexpr Vector(A... a) : v{ T(a)... } {}
+	template <class U>
+	constexpr explicit Vector(const Vector<U, N>& rhs) : v()    // convert scalar type
+	{
+		Gil::unroll<N>([&](int i) { v[i] = T(rhs[i]); });
+	}
+
+	template <class U>
+	constexpr Vector<U, N> cast() const                         // convert to other scalar type
+	{
+		Vector<U, N> r;
+		Gil::unroll<N>([&](int i) { r[i] = U(v[i]); });
+		return r;
+	}
+
+	//Utility functions
+	T				length() const								{ return std::sqrt(dot(*this)); }
+	Vector&			normalize()									//normalize, do nothing if 0 length
+	{
+		T d = dot(*this);
+		if (d > 0)
+			*this *= T(1) / std::sqrt(d);
+		return *this;
+	}
+	constexpr T		dot(const Vector& rhs) const				//dot product
+	{
+		T sum = 0;
+		Gil::unroll<N>([&](int i) { sum += v[i] * rhs.v[i]; });
+		return sum;
+	}
+	constexpr Vector cross(const Vector& rhs) const				//cross product, 3D only
+		requires (N == 3)
+	{
+		return Vector(v[1] * rhs.v[2] - v[2] * rhs.v[1],
+			v[2] * rhs.v[0] - v[0] * rhs.v[2],
+			v[0] * rhs.v[1] - v[1] * rhs.v[0]);
+	}
+
+	//operators
+	constexpr Vector operator-() const							{ Vector r; Gil::unroll<N>([&](int i) { r.v[i] = -v[i]; }); return r; }
+	constexpr Vector operator+(const Vector& rhs) const			{ Vector r(*this); return r += rhs; }
+	constexpr Vector operator-(const Vector& rhs) const			{ Vector r(*this); return r -= rhs; }
+	constexpr Vector operator*(T scale) const					{ Vector r(*this); return r *= scale; }
+	constexpr Vector operator*(const Vector& rhs) const			{ Vector r(*this); return r *= rhs; }
+	constexpr Vector operator/(T scale) const					{ Vector r(*this); return r *= T(1) / scale; }
+	constexpr Vector& operator+=(const Vector& rhs)				{ Gil::unroll<N>([&](int i) { v[i] += rhs.v[i]; }); return *this; }
+	constexpr Vector& operator-=(const Vector& rhs)				{ Gil::unroll<N>([&](int i) { v[i] -= rhs.v[i]; }); return *this; }
+	constexpr Vector& operator*=(T scale)						{ Gil::unroll<N>([&](int i) { v[i] *= scale; }); return *this; }
+	constexpr Vector& operator*=(const Vector& rhs)				{ Gil::unroll<N>([&](int i) { v[i] *= rhs.v[i]; }); return *this; }
+	constexpr Vector& operator/=(T scale)						{ return *this *= T(1) / scale; }
+	constexpr bool	operator==(const Vector& rhs) const			// exact compare, no epsilon
+	{
+		bool equal = true;
+		Gil::unroll<N>([&](int i) { equal = equal && v[i] == rhs.v[i]; });
+		return equal;
+	}
+	constexpr bool	operator!=(const Vector& rhs) const			{ return !(*this == rhs); }
+	constexpr T		operator[](int index) const					{ return v[index]; }
+	constexpr T&	operator[](int index)						{ return v[index]; }
+
+	friend constexpr Vector operator*(T scale, const Vector& vec) { return vec * scale; }
+	friend std::ostream& operator<<(std::ostream& os, const Vector& vec)
+	{
+		os << "(";
+		for (int i = 0; i < N; ++i)
+			os << (i ? ", " : "") << vec.v[i];
+		return os << ")";
+	}
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RxC matrix (column major)
+///////////////////////////////////////////////////////////////////////////////
+template <class T, int R, int C>
+class Matrix
+{
+public:
+	static const int ROWS = R;
+	static const int COLUMNS = C;
+
+	//constructors
+	constexpr Matrix() : m()									//init with identity (zero if not square)
+	{
+		if constexpr (R == C)
+			identity();
+	}
+	constexpr Matrix(const T src[R * C]) : m()					{ set(src); }
+	template <class... A>
+		requires (sizeof...(A) == R * C && R * C > 1)
+	constexpr Matrix(A... a) : m{ T(a)... } {}					//elements in column major order
+	template <class U>
+	constexpr explicit Matrix(const Matrix<U, R, C>& rhs) : m()	//convert scalar type, also from Matrix2/3/4
+	{
+		Gil::unroll<R * C>([&](int i) { m[i] = T(rhs[i]); });
+	}
+
+	template <class U>
+	constexpr Matrix<U, R, C> cast() const						//convert to other scalar type, e.g. Matrix4
+	{
+		Matrix<U, R, C> r;
+		Gil::unroll<R * C>([&](int i) { r[i] = U(m[i]); });
+		return r;
+	}
+
+	constexpr void	set(const T src[R * C])						{ Gil::unroll<R * C>([&](int i) { m[i] = src[i]; }); }
+	constexpr void	setRow(int index, const Vector<T, C>& v)	{ Gil::unroll<C>([&](int c) { m[c * R + index] = v[c]; }); }
+	constexpr void	setColumn(int index, const Vector<T, R>& v)	{ Gil::unroll<R>([&](int r) { m[index * R + r] = v[r]; }); }
+
+	constexpr const T* get() const								{ return m; }
+	constexpr Vector<T, C> getRow(int index) const
+	{
+		Vector<T, C> v;
+		Gil::unroll<C>([&](int c) { v[c] = m[c * R + index]; });
+		return v;
+	}
+	constexpr Vector<T, R> getColumn(int index) const
+	{
+		Vector<T, R> v;
+		Gil::unroll<R>([&](int r) { v[r] = m[index * R + r]; });
+		return v;
+	}
+	constexpr Matrix<T, C, R> getTransposed() const			//return transposed matrix
+	{
+		Matrix<T, C, R> t;
+		Gil::unroll<R * C>([&](int i) { t[(i % R) * C + i / R] = m[i]; });
+		return t;
+	}
+
+	constexpr Matrix& identity() requires (R == C)
+	{
+		Gil::unroll<R * C>([&](int i) { m[i] = (i % (R + 1) == 0) ? T(1) : T(0); });
+		return *this;
+	}
+	constexpr Matrix& transpose() requires (R == C)				//transpose itself and return reference
+	{
+		*this = getTransposed();
+		return *this;
+	}
+	constexpr T		getDeterminant() const requires (R == C);
+	constexpr Matrix& invert() requires (R == C);				//identity if singular
+
+	//operators
+	constexpr Matrix operator+(const Matrix& rhs) const			{ Matrix r(*this); return r += rhs; }
+	constexpr Matrix operator-(const Matrix& rhs) const			{ Matrix r(*this); return r -= rhs; }
+	constexpr Matrix& operator+=(const Matrix& rhs)				{ Gil::unroll<R * C>([&](int i) { m[i] += rhs.m[i]; }); return *this; }
+	constexpr Matrix& operator-=(const Matrix& rhs)				{ Gil::unroll<R * C>([&](int i) { m[i] -= rhs.m[i]; }); return *this; }
+	constexpr Vector<T, R> operator*(const Vector<T, C>& rhs) const	// multiplication: v' = M * v
+	{
+		Vector<T, R> v;
+		Gil::unroll<R>([&](int r) {
+			T sum = 0;
+			Gil::unroll<C>([&](int c) { sum += m[c * R + r] * rhs[c]; });
+			v[r] = sum;
+		});
+		return v;
+	}
+	template <int K>
+	constexpr Matrix<T, R, K> operator*(const Matrix<T, C, K>& rhs) const	// multiplication: M3 = M1 * M2
+	{
+		Matrix<T, R, K> p;
+		Gil::unroll<K>([&](int k) {
+			Gil::unroll<R>([&](int r) {
+				T sum = 0;
+				Gil::unroll<C>([&](int c) { sum += m[c * R + r] * rhs[k * C + c]; });
+				p[k * R + r] = sum;
+			});
+		});
+		return p;
+	}
+	constexpr Matrix& operator*=(const Matrix& rhs) requires (R == C)	{ *this = *this * rhs; return *this; }
+	constexpr Matrix operator*(T scale) const
+	{
+		Matrix r(*this);
+		Gil::unroll<R * C>([&](int i) { r.m[i] *= scale; });
+		return r;
+	}
+	constexpr Matrix operator-() const							{ return *this * T(-1); }
+
+	constexpr bool	operator==(const Matrix& rhs) const			// exact compare, no epsilon
+	{
+		bool equal = true;
+		Gil::unroll<R * C>([&](int i) { equal = equal && m[i] == rhs.m[i]; });
+		return equal;
+	}
+	constexpr bool	operator!=(const Matrix& rhs) const			{ return !(*this == rhs); }
+	constexpr T		operator[](int index) const					{ return m[index]; }
+	constexpr T&	operator[](int index)						{ return m[index]; }
+
+	friend constexpr Matrix operator*(T scale, const Matrix& rhs) { return rhs * scale; }
+	friend std::ostream& operator<<(std::ostream& os, const Matrix& mat)
+	{
+		os << std::fixed << std::setprecision(5);
+		for (int r = 0; r < R; ++r)
+		{
+			os << "[";
+			for (int c = 0; c < C; ++c)
+				os << (c ? " " : "") << std::setw(10) << mat.m[c * R + r];
+			os << "]\n";
+		}
+		os << std::resetiosflags(std::ios_base::fixed | std::ios_base::floatfield);
+		return os;
+	}
+
+private:
+	T m[R * C];
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// determinant with Gaussian elimination (partial pivoting)
+///////////////////////////////////////////////////////////////////////////////
+template <class T, int R, int C>
+constexpr T Matrix<T, R, C>::getDeterminant() const requires (R == C)
+{
+	T a[R * C];
+	Gil::unroll<R * C>([&](int i) { a[i] = m[i]; });
+
+	T det = 1;
+	for (int k = 0; k < R; ++k)
+	{
+		// pick the largest pivot in column k
+		int pivot = k;
+		for (int r = k + 1; r < R; ++r)
+			if ((a[k * R + r] < 0 ? -a[k * R + r] : a[k * R + r]) > (a[k * R + pivot] < 0 ? -a[k * R + pivot] : a[k * R + pivot]))
+				pivot = r;
+		if (a[k * R + pivot] == 0)
+			return 0;
+		if (pivot != k)
+		{
+			for (int c = 0; c < C; ++c)
+				std::swap(a[c * R + k], a[c * R + pivot]);
+			det = -det;
+		}
+
+		det *= a[k * R + k];
+		for (int r = k + 1; r < R; ++r)
+		{
+			T f = a[k * R + r] / a[k * R + k];
+			for (int c = k; c < C; ++c)
+				a[c * R + r] -= f * a[c * R + k];
+		}
+	}
+	return det;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse with Gauss-Jordan elimination (partial pivoting)
+// If the matrix is singular, it becomes identity, same as Matrix2/3/4.
+///////////////////////////////////////////////////////////////////////////////
+template <class T, int R, int C>
+constexpr Matrix<T, R, C>& Matrix<T, R, C>::invert() requires (R == C)
+{
+	const T EPSILON = T(0.00001);
+	T a[R * C];
+	Matrix inv;
+	Gil::unroll<R * C>([&](int i) { a[i] = m[i]; });
+
+	for (int k = 0; k < R; ++k)
+	{
+		int pivot = k;
+		for (int r = k + 1; r < R; ++r)
+			if ((a[k * R + r] < 0 ? -a[k * R + r] : a[k * R + r]) > (a[k * R + pivot] < 0 ? -a[k * R + pivot] : a[k * R + pivot]))
+				pivot = r;
+		T p = a[k * R + pivot];
+		if ((p < 0 ? -p : p) <= EPSILON)
+			return identity();
+		if (pivot != k)
+		{
+			for (int c = 0; c < C; ++c)
+			{
+				std::swap(a[c * R + k], a[c * R + pivot]);
+				std::swap(inv.m[c * R + k], inv.m[c * R + pivot]);
+			}
+		}
+
+		// scale row k to make the pivot 1, then eliminate column k of other rows
+		T invPivot = T(1) / p;
+		for (int c = 0; c < C; ++c)
+		{
+			a[c * R + k] *= invPivot;
+			inv.m[c * R + k] *= invPivot;
+		}
+		for (int r = 0; r < R; ++r)
+		{
+			if (r == k)
+				continue;
+			T f = a[k * R + r];
+			for (int c = 0; c < C; ++c)
+			{
+				a[c * R + r] -= f * a[c * R + k];
+				inv.m[c * R + r] -= f * inv.m[c * R + k];
+			}
+		}
+	}
+	*this = inv;
+	return *this;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// double instantiations are compiled once in Matrices.cpp
+///////////////////////////////////////////////////////////////////////////////
+extern template struct Vector<double, 2>;
+extern template struct Vector<double, 3>;
+extern template struct Vector<double, 4>;
+extern template class Matrix<double, 2, 2>;
+extern template class Matrix<double, 3, 3>;
+extern template class Matrix<double, 4, 4>;
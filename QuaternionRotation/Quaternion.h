@@ -22,6 +22,39 @@
 #include "Vectors.h"
 #include "Matrices.h"
 
+#ifdef GIL_SSE
+namespace Gil
+{
+	///////////////////////////////////////////////////////////////////////////
+	// SSE product of quaternions stored as (s, x, y, z), dst = a * b
+	// Each lane of a is broadcast and multiplied by a shuffle of b with signs;
+	//   dst = a.s*( s, x, y, z) + a.x*(-x, s,-z, y)
+	//       + a.y*(-y, z, s,-x) + a.z*(-z,-y, x, s)   (components of b)
+	// dst may be the same as a or b.
+	///////////////////////////////////////////////////////////////////////////
+	inline __m128 multiplyQuaternion(__m128 a, __m128 b)
+	{
+		const __m128 SIGN_X = _mm_castsi128_ps(_mm_setr_epi32(0x80000000, 0, 0x80000000, 0));
+		const __m128 SIGN_Y = _mm_castsi128_ps(_mm_setr_epi32(0x80000000, 0, 0, 0x80000000));
+		const __m128 SIGN_Z = _mm_castsi128_ps(_mm_setr_epi32(0x80000000, 0x80000000, 0, 0));
+
+		__m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)),
+			_mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), SIGN_X)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)),
+			_mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), SIGN_Y)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)),
+			_mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), SIGN_Z)));
+		return r;
+	}
+
+	inline void multiplyQuaternion(const float* a, const float* b, float* dst)
+	{
+		_mm_storeu_ps(dst, multiplyQuaternion(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+} //end of namespace Gil
+#endif
+
 
 struct Quaternion
 {
@@ -29,38 +62,38 @@ struct Quaternion
 	float x, y, z; //vector part
 
 	//constructors
-	Quaternion() : s(0), x(0), y(0), z(0) {}
-	Quaternion(float s, float x, float y, float z) : s(s), x(x), y(y), z(z) {}
-	Quaternion(const Vector3& axis, float angle); // rot axis & angle (radian)
+	constexpr Quaternion() : s(0), x(0), y(0), z(0) {}
+	constexpr Quaternion(float s, float x, float y, float z) : s(s), x(x), y(y), z(z) {}
+	constexpr Quaternion(const Vector3& axis, float angle); // rot axis & angle (radian)
 
 	//Uti functions
-	void	Set(float s, float x, float y, float z);
-	void	Set(const Vector3& axis, float angle); // half angle (radian)
-	float	length() const;
-	Quaternion& normalize();
-	Quaternion& conjugate(); //conjugate of quaternion //
-	Quaternion& invert(); //inverse of quaternion //
-	Matrix4 getMatrix() const;
-	Vector3 getVector() const;
+	constexpr void	Set(float s, float x, float y, float z);
+	constexpr void	Set(const Vector3& axis, float angle); // half angle (radian)
+	constexpr float	length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
+	constexpr Quaternion& normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT); //normalize with the given precision
+	constexpr Quaternion& conjugate(); //conjugate of quaternion //
+	constexpr Quaternion& invert(); //inverse of quaternion //
+	constexpr Matrix4 getMatrix() const;
+	constexpr Vector3 getVector() const;
 
 	//operators
-	Quaternion operator-() const; //unary operator (negate)
-	Quaternion operator+(const Quaternion& rhs) const; //addition
-	Quaternion operator-(const Quaternion& rhs) const; //subtraction
-	Quaternion operator*(float a) const; //scalar multiplication
-	Quaternion operator*(const Quaternion& rhs) const; //multiplication
-	Quaternion operator*(const Vector3& v) const;      // conjugation for rotation
+	constexpr Quaternion operator-() const; //unary operator (negate)
+	constexpr Quaternion operator+(const Quaternion& rhs) const; //addition
+	constexpr Quaternion operator-(const Quaternion& rhs) const; //subtraction
+	constexpr Quaternion operator*(float a) const; //scalar multiplication
+	constexpr Quaternion operator*(const Quaternion& rhs) const; //multiplication
+	constexpr Quaternion operator*(const Vector3& v) const;      // conjugation for rotation
 
-	Quaternion& operator+=(const Quaternion& rhs); //addition and update
-	Quaternion& operator-=(const Quaternion& rhs); //subtraction and update
-	Quaternion& operator*=(float a); //scalar multiplication and update
-	Quaternion& operator*=(const Quaternion& rhs); //quaternion multiplication and update
+	constexpr Quaternion& operator+=(const Quaternion& rhs); //addition and update
+	constexpr Quaternion& operator-=(const Quaternion& rhs); //subtraction and update
+	constexpr Quaternion& operator*=(float a); //scalar multiplication and update
+	constexpr Quaternion& operator*=(const Quaternion& rhs); //quaternion multiplication and update
 
-	bool operator==(const Quaternion& rhs) const; // exact compare, no epsilon
-	bool operator!=(const Quaternion& rhs) const; // exact compare, no epsilon
+	constexpr bool operator==(const Quaternion& rhs) const; // exact compare, no epsilon
+	constexpr bool operator!=(const Quaternion& rhs) const; // exact compare, no epsilon
 
 	// friend functions
-	friend Quaternion operator*(float a, const Quaternion& q); //pre-multiplication
+	friend constexpr Quaternion operator*(float a, const Quaternion& q); //pre-multiplication
 	friend std::ostream& operator<<(std::ostream& os, const Quaternion& q);
 
 	// static functions
@@ -69,8 +102,8 @@ struct Quaternion
 
 	// return quaternion from Euler angles (x,y) or (x,y,z) //ŷתԪ
 	// The rotation order is x->y->z  
-	static Quaternion getQuaternion(const Vector2& angles);
-	static Quaternion getQuaternion(const Vector3& angles);
+	static constexpr Quaternion getQuaternion(const Vector2& angles);
+	static constexpr Quaternion getQuaternion(const Vector3& angles);
 };
 
 
@@ -79,13 +112,13 @@ struct Quaternion
 // inline functions for Quaternion
 ///////////////////////////////////////////////////////////////////////////////
 
-inline Quaternion::Quaternion(const Vector3& axis, float angle)
+constexpr Quaternion::Quaternion(const Vector3& axis, float angle) : s(0), x(0), y(0), z(0)
 {
 	//angle is radian
 	Set(axis, angle);
 }
 
-inline void Quaternion::Set(float s, float x, float y, float z)
+constexpr void Quaternion::Set(float s, float x, float y, float z)
 {
 	this->s = s;
 	this->x = x;
@@ -93,43 +126,44 @@ inline void Quaternion::Set(float s, float x, float y, float z)
 	this->z = z;
 }
 
-inline void Quaternion::Set(const Vector3& axis, float angle)
+constexpr void Quaternion::Set(const Vector3& axis, float angle)
 {
 	// use only half angle because of double multiplication, qpq*,
 	// q at the front and its conjugate at the back
 	Vector3 v = axis;
 	v.Normalize();
-	float sine = sinf(angle);
-	s = cosf(angle);
+	float sine, cosine;
+	Gil::sinCos(angle, sine, cosine);
+	s = cosine;
 	x = v.x * sine;
 	y = v.y * sine;
 	z = v.z * sine;
 }
 
-inline float Quaternion::length() const
+constexpr float Quaternion::length(Gil::NormalizeMode mode) const
 {
-	return sqrt(s * s + x * x + y * y + z * z);
+	return Gil::squareRoot(s * s + x * x + y * y + z * z, mode);
 }
 
-inline Quaternion& Quaternion::normalize()
+constexpr Quaternion& Quaternion::normalize(Gil::NormalizeMode mode)
 {
 	const float EPSILON = 0.00001f;
 	float d = s * s + x * x + y * y + z * z;
 	if (d < EPSILON)
 		return *this; // do nothing if it is zero
 
-	float invLength = 1.0f / sqrtf(d);
+	float invLength = Gil::invSqrt(d, mode);
 	s *= invLength;  x *= invLength;  y *= invLength;  z *= invLength;
 	return *this;
 }
 
-inline Quaternion& Quaternion::conjugate()
+constexpr Quaternion& Quaternion::conjugate()
 {
 	x = -x;  y = -y;  z = -z;
 	return *this;
 }
 
-inline Quaternion& Quaternion::invert()
+constexpr Quaternion& Quaternion::invert()
 {
 	const float EPSILON = 0.00001f;
 	float d = s * s + x * x + y * y + z * z;
@@ -141,7 +175,7 @@ inline Quaternion& Quaternion::invert()
 	return *this;
 }
 
-inline Matrix4 Quaternion::getMatrix() const 
+constexpr Matrix4 Quaternion::getMatrix() const 
 {
 	// NOTE: assume the quaternion is unit length
 	// compute common values
@@ -172,82 +206,87 @@ inline Matrix4 Quaternion::getMatrix() const
 }
 
 
-inline Vector3 Quaternion::getVector() const 
+constexpr Vector3 Quaternion::getVector() const 
 {
 	return Vector3(x, y, z);
 }
 
-inline Quaternion Quaternion::operator-() const
+constexpr Quaternion Quaternion::operator-() const
 {
 	return Quaternion(-s, -x, -y, -z);
 }
 
-inline Quaternion Quaternion::operator+(const Quaternion& rhs) const
+constexpr Quaternion Quaternion::operator+(const Quaternion& rhs) const
 {
 	return Quaternion(s + rhs.s, x + rhs.x, y + rhs.y, z + rhs.z);
 }
 
-inline Quaternion Quaternion::operator-(const Quaternion& rhs) const
+constexpr Quaternion Quaternion::operator-(const Quaternion& rhs) const
 {
 	return Quaternion(s - rhs.s, x - rhs.x, y - rhs.y, z - rhs.z);
 }
 
-inline Quaternion Quaternion::operator*(float a) const
+constexpr Quaternion Quaternion::operator*(float a) const
 {
 	return Quaternion(s * a, x * a, y * a, z * a);
 }
 
-inline Quaternion Quaternion::operator*(const Quaternion& rhs) const
+constexpr Quaternion Quaternion::operator*(const Quaternion& rhs) const
 {
 	// qq' = [s,v] * [s',v'] = [(ss' - v . v'), v x v' + sv' + s'v]
 	//NOTE: quaternion multiplication is not commutative
-	Vector3 v1(x, y, z);                            // vector part of q
-	Vector3 v2(rhs.x, rhs.y, rhs.z);                // vector part of q'
-
-	Vector3 cross = v1.cross(v2);                   // v x v' (cross product)
-	float dot = v1.dot(v2);                         // v . v' (inner product)
-	Vector3 v3 = cross + (s * v2) + (rhs.s * v1);   // v x v' + sv' + s'v
-
-	return Quaternion(s * rhs.s - dot, v3.x, v3.y, v3.z);
+#ifdef GIL_SSE
+	if (!std::is_constant_evaluated())
+	{
+		Quaternion q;
+		Gil::multiplyQuaternion(&s, &rhs.s, &q.s);
+		return q;
+	}
+#endif
+	// expanded to 16 multiply-adds without Vector3 temporaries
+	return Quaternion(s * rhs.s - x * rhs.x - y * rhs.y - z * rhs.z,
+		s * rhs.x + x * rhs.s + y * rhs.z - z * rhs.y,
+		s * rhs.y - x * rhs.z + y * rhs.s + z * rhs.x,
+		s * rhs.z + x * rhs.y - y * rhs.x + z * rhs.s);
 }
 
-inline Quaternion Quaternion::operator*(const Vector3& v) const
+constexpr Quaternion Quaternion::operator*(const Vector3& v) const
 {
 	Quaternion q(0, x, y, z);
 	return *this * q;
 }
 
-inline Quaternion& Quaternion::operator+=(const Quaternion& rhs)
+constexpr Quaternion& Quaternion::operator+=(const Quaternion& rhs)
 {
 	s += rhs.s;  x += rhs.x;  y += rhs.y;  z += rhs.z;
 	return *this;
 }
 
-inline Quaternion& Quaternion::operator-=(const Quaternion& rhs)
+constexpr Quaternion& Quaternion::operator-=(const Quaternion& rhs)
 {
 	s -= rhs.s;  x -= rhs.x;  y -= rhs.y;  z -= rhs.z;
 	return *this;
 }
 
-inline Quaternion& Quaternion::operator*=(float a)
+constexpr Quaternion& Quaternion::operator*=(float a)
 {
 	s *= a;  x *= a;  y *= a;  z *= a;
 	return *this;
 }
 
-inline Quaternion& Quaternion::operator*=(const Quaternion& rhs)
+constexpr Quaternion& Quaternion::operator*=(const Quaternion& rhs)
 {
 	*this = *this * rhs;
 	return *this;
 }
 
-inline bool Quaternion::operator==(const Quaternion& rhs) const
+constexpr bool Quaternion::operator==(const Quaternion& rhs) const
 {
 	// exact comparison
 	return (s == rhs.s) && (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
 }
 
-inline bool Quaternion::operator!=(const Quaternion& rhs) const
+constexpr bool Quaternion::operator!=(const Quaternion& rhs) const
 {
 	// exact comparison
 	return (s != rhs.s) || (x != rhs.x) || (y != rhs.y) || (z != rhs.z);
@@ -261,7 +300,7 @@ inline bool Quaternion::operator!=(const Quaternion& rhs) const
 inline  Quaternion Quaternion::getQuaternion(const Vector3& v1, const Vector3& v2)
 {
 	const float EPSILON = 0.001f;
-	const float HALF_PI = acosf(-1.0f) * 0.5f;
+	const float HALF_PI = 3.141593f * 0.5f;
 
 	// if two vectors are equal return the vector with 0 rotation
 	if (v1.equal(v2, EPSILON))
@@ -287,12 +326,12 @@ inline  Quaternion Quaternion::getQuaternion(const Vector3& v1, const Vector3& v
 	u2.Normalize();
 
 	Vector3 v = u1.cross(u2);           // compute rotation axis
-	float angle = acosf(u1.dot(u2));    // rotation angle
+	float angle = Gil::arcCosine(u1.dot(u2)); // rotation angle
 	return Quaternion(v, angle * 0.5f); // half angle
 }
 
 // find quaternion from 2D rotation angle (ax, ay)
-inline Quaternion Quaternion::getQuaternion(const Vector2& angles)
+constexpr Quaternion Quaternion::getQuaternion(const Vector2& angles)
 {
 	Quaternion qx = Quaternion(Vector3(1, 0, 0), angles.x);   // rotate along X
 	Quaternion qy = Quaternion(Vector3(0, 1, 0), angles.y);   // rotate along Y
@@ -300,7 +339,7 @@ inline Quaternion Quaternion::getQuaternion(const Vector2& angles)
 }
 
 // find quaternion from 3D rotation angles (ax, ay, az)
-inline Quaternion Quaternion::getQuaternion(const Vector3& angles)
+constexpr Quaternion Quaternion::getQuaternion(const Vector3& angles)
 {
 	Quaternion qx = Quaternion(Vector3(1, 0, 0), angles.x);   // rotate along X
 	Quaternion qy = Quaternion(Vector3(0, 1, 0), angles.y);   // rotate along Y
@@ -314,7 +353,7 @@ inline Quaternion Quaternion::getQuaternion(const Vector3& angles)
 ///////////////////////////////////////////////////////////////////////////////
 
 // a * q (scalar * quat)
-inline Quaternion operator*(float a, const Quaternion& q)
+constexpr Quaternion operator*(float a, const Quaternion& q)
 {
 	return Quaternion(a * q.s, a * q.x, a * q.y, a * q.z);
 }
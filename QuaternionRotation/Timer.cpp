@@ -22,20 +22,91 @@
 
 
 #include "Timer.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(TIMER_TSC) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+	const int64_t CALIBRATION_NS = 20000000;	// 20 ms of CLOCK per TSC calibration
+
+	double clockNanoSecPerTick()
+	{
+#ifdef _WIN32
+		LARGE_INTEGER frequency;				// ticks per second
+		QueryPerformanceFrequency(&frequency);
+		return 1000000000.0 / frequency.QuadPart;
+#else
+		return 1.0;								// CLOCK_MONOTONIC_RAW is in nano-second
+#endif
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// CPUID 0x80000007 EDX bit 8: the TSC runs at a constant rate in all power
+	// states, so it can be converted to time
+	///////////////////////////////////////////////////////////////////////////
+	bool readInvariantTsc()
+	{
+#ifdef TIMER_TSC
+		unsigned int r[4] = { 0, 0, 0, 0 };
+#ifdef _MSC_VER
+		int regs[4];
+		__cpuid(regs, (int)0x80000000);
+		if ((unsigned int)regs[0] < 0x80000007)
+			return false;
+		__cpuid(regs, (int)0x80000007);
+		r[3] = (unsigned int)regs[3];
+#else
+		if (__get_cpuid_max(0x80000000, 0) < 0x80000007)
+			return false;
+		__cpuid(0x80000007, r[0], r[1], r[2], r[3]);
+#endif
+		return (r[3] & (1u << 8)) != 0;
+#else
+		return false;
+#endif
+	}
+
+#ifdef TIMER_TSC
+	///////////////////////////////////////////////////////////////////////////
+	// count TSC ticks over CALIBRATION_NS of the clock
+	///////////////////////////////////////////////////////////////////////////
+	double calibrateCycles()
+	{
+		double clockNs = Timer::getNanoSecPerTick(Timer::CLOCK);
+		int64_t clock0 = Timer::getTicks(Timer::CLOCK);
+		int64_t cycles0 = Timer::getTicks(Timer::CYCLES);
+		int64_t clock1, cycles1;
+		do
+		{
+			clock1 = Timer::getTicks(Timer::CLOCK);
+			cycles1 = Timer::getTicks(Timer::CYCLES);
+		} while ((clock1 - clock0) * clockNs < CALIBRATION_NS);
+		return (clock1 - clock0) * clockNs / (cycles1 - cycles0);
+	}
+#endif
+}
+
 
 
 //////////////////////////////////////////////////////////////////////////
 //constructor
+//CYCLES falls back to CLOCK if the TSC is not invariant
 //////////////////////////////////////////////////////////////////////////
-Timer::Timer()
+Timer::Timer(Mode mode) : mode(mode)
 {
-	QueryPerformanceFrequency(&frequency);
-	startCount.QuadPart = 0;
-	endCount.QuadPart = 0;
-
+	if (mode == CYCLES && !hasInvariantTsc())
+		this->mode = CLOCK;
+	nanoSecPerTick = getNanoSecPerTick(this->mode);
+	startCount = 0;
+	endCount = 0;
 	stopped = 0;
-	startTimeInMicroSec = 0;
-	endTimeInMicroSec = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -48,40 +119,30 @@ Timer::~Timer()
 
 
 ///////////////////////////////////////////////////////////////////////////////
-// start timer.
-// startCount will be set at this point.
+// ticks between start() and stop(), or now if the timer is running.
+// other getElapsedTime will call this first, then convert to correspond resolution. //
 ///////////////////////////////////////////////////////////////////////////////
-void Timer::start()
+int64_t Timer::getElapsedTicks()
 {
-	stopped = 0; // reset stop flag
-	QueryPerformanceCounter(&startCount);
+	if (!stopped)
+		endCount = readStop();
+	return endCount - startCount;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// stop the timer.
-// endCount will be set at this point.
+// multiply elapsed ticks by the precomputed factor
 ///////////////////////////////////////////////////////////////////////////////
-void Timer::stop()
+double Timer::getElapsedTimeInNanoSec()
 {
-	stopped = 1; //set timer stopped flag
-	QueryPerformanceCounter(&endCount);
+	return getElapsedTicks() * nanoSecPerTick;
 }
 
-
 ///////////////////////////////////////////////////////////////////////////////
 // compute elapsed time in micro-second resolution. //΢㾭ʱ
-// other getElapsedTime will call this first, then convert to correspond resolution. //
 ///////////////////////////////////////////////////////////////////////////////
 double Timer::getElapsedTimeInMicroSec()
 {
-	if (!stopped)
-		QueryPerformanceCounter(&endCount);
-
-	startTimeInMicroSec = startCount.QuadPart * (1000000.0 / frequency.QuadPart);
-	endTimeInMicroSec = endCount.QuadPart * (1000000.0 / frequency.QuadPart);
-
-
-	return endTimeInMicroSec - startTimeInMicroSec;
+	return getElapsedTicks() * (nanoSecPerTick * 0.001);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -108,3 +169,60 @@ double Timer::getElapsedTime()
 {
 	return this->getElapsedTimeInSec();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// ticks of the OS clock; QueryPerformanceCounter() is a call into the OS on
+// Windows anyway, and clock_gettime() a vDSO call elsewhere
+///////////////////////////////////////////////////////////////////////////////
+int64_t Timer::readClock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+	return count.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// current ticks without serialization, for time stamps
+// CYCLES falls back to CLOCK like the constructor, so the ticks always match
+// getNanoSecPerTick() of the same mode
+///////////////////////////////////////////////////////////////////////////////
+int64_t Timer::getTicks(Mode mode)
+{
+#ifdef TIMER_TSC
+	if (mode == CYCLES && hasInvariantTsc())
+		return (int64_t)__rdtsc();
+#endif
+	return readClock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the clock factor is read from the OS, the TSC factor is measured at the
+// first call; both are kept for the process
+///////////////////////////////////////////////////////////////////////////////
+double Timer::getNanoSecPerTick(Mode mode)
+{
+	static const double clockNs = clockNanoSecPerTick();
+#ifdef TIMER_TSC
+	if (mode == CYCLES && hasInvariantTsc())
+	{
+		static const double cyclesNs = calibrateCycles();
+		return cyclesNs;
+	}
+#endif
+	return clockNs;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// read once, CPUID is slow in virtual machines
+///////////////////////////////////////////////////////////////////////////////
+bool Timer::hasInvariantTsc()
+{
+	static const bool invariant = readInvariantTsc();
+	return invariant;
+}
@@ -5,18 +5,43 @@
 // High Resolution Timer.
 // This timer is able to measure the elapsed time with 1 micro-second accuracy in both Windows, Linux and Unix system 
 // ˼ʱܹ WindowsLinux  Unix ϵͳ 1 ΢ľȲʱ 
+//
+// Two tick sources:
+// CLOCK : the monotonic clock of the OS, QueryPerformanceCounter() on Windows,
+//         clock_gettime(CLOCK_MONOTONIC_RAW) elsewhere (1 tick = 1 ns)
+// CYCLES: the time stamp counter of x86 CPUs (rdtsc/rdtscp), calibrated once
+//         against CLOCK; for sub-microsecond code. It falls back to CLOCK if
+//         the TSC is not invariant or the CPU is not x86.
+// The nanoseconds per tick are computed once, so an elapsed time is one
+// subtraction and one multiply; getElapsedTicks() returns the raw ticks.
+//
 //  AUTHOR: Yao xiao dong
 // CREATED: 2025-02-12
 //
 // Copyright (c) 2025 yao xiao dong
 //////////////////////////////////////////////////////////////////////////////
 
-#include <windows.h>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TIMER_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
 
 class Timer
 {
 public:
-	Timer();									// default constructor
+	enum Mode
+	{
+		CLOCK,									// monotonic clock of the OS
+		CYCLES									// calibrated time stamp counter
+	};
+
+	Timer(Mode mode = CLOCK);					// default constructor
 	~Timer();									// default destructor	
 
 	void start();								// start timer
@@ -26,19 +51,73 @@ public:
 	double getElapsedTimeInSec();				// get elapsed time in second (same as getElapsedTime)
 	double getElapsedTimeInMilliSec();			// get elapsed time in milli-second
 	double getElapsedTimeInMicroSec();			// get elapsed time in micro-second
+	double getElapsedTimeInNanoSec();			// get elapsed time in nano-second
+	int64_t getElapsedTicks();					// get elapsed raw ticks of the mode
+
+	Mode getMode() const						{ return mode; }    // CLOCK if CYCLES is not available
+	double getNanoSecPerTick() const			{ return nanoSecPerTick; }
+
+	static int64_t getTicks(Mode mode);			// current raw ticks, of CLOCK if CYCLES is not available
+	static double getNanoSecPerTick(Mode mode);	// computed once per process
+	static bool hasInvariantTsc();				// CYCLES is available
 
 protected:
 
 
 private:
+	static int64_t readClock();					// CLOCK ticks, in Timer.cpp to keep <windows.h> out of this header
+	int64_t readStart() const;					// serialized before the timed code
+	int64_t readStop() const;					// serialized after the timed code
 
-	double startTimeInMicroSec;				// starting time in micro-second
-	double endTimeInMicroSec;				// ending time in micro-second
+	Mode mode;
+	double nanoSecPerTick;					// precomputed tick to nano-second factor
+	int64_t startCount;						// starting ticks
+	int64_t endCount;						// ending ticks
 	int stopped;							// stop flag
+};
+
+
 
-	//LARGE_INTEGER  Windows ڱʾ 64 λзͣڸ߾ȼʱļʹȳ
-	// ͨ LowPartHighPart  QuadPartط 64 λĲͬ֡
-	LARGE_INTEGER frequency;				// ticks per second
-	LARGE_INTEGER startCount;				// starting count
-	LARGE_INTEGER endCount;					// ending count
-};
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// inline functions, kept in the header so start() and stop() add only the
+// cost of reading the counter to the timed code
+///////////////////////////////////////////////////////////////////////////////
+inline int64_t Timer::readStart() const
+{
+#ifdef TIMER_TSC
+	if (mode == CYCLES)
+	{
+		// earlier instructions finish before the counter is read
+		_mm_lfence();
+		return (int64_t)__rdtsc();
+	}
+#endif
+	return readClock();
+}
+
+inline int64_t Timer::readStop() const
+{
+#ifdef TIMER_TSC
+	if (mode == CYCLES)
+	{
+		// rdtscp waits for the timed code, lfence keeps later code out
+		unsigned int aux;
+		int64_t count = (int64_t)__rdtscp(&aux);
+		_mm_lfence();
+		return count;
+	}
+#endif
+	return readClock();
+}
+
+inline void Timer::start()
+{
+	stopped = 0; // reset stop flag
+	startCount = readStart();
+}
+
+inline void Timer::stop()
+{
+	endCount = readStop();
+	stopped = 1; //set timer stopped flag
+}
@@ -0,0 +1,224 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// Transform.h
+// ===========
+// Transform types tagged with the structure of the matrix, so the inverse,
+// composition and normal matrix use the cheapest correct method at compile
+// time, instead of checking the bottom row at run time like Matrix4::invert().
+//
+//   RigidTransform       rotation + translation, inverse is transpose
+//   AffinePartTransform  rotation/scale/shear + translation, inverse of 3x3
+//   ProjectiveTransform  any 4x4 matrix, general inverse
+//
+// Rigid and affine kinds are stored as AffineTransform (3x4), projective is
+// stored as Matrix4. Composing two kinds returns the more general kind,
+// e.g. RigidTransform * AffinePartTransform = AffinePartTransform.
+// A kind converts implicitly to a more general kind, but not the other way.
+//
+// NOTE: the factories trust the caller; fromMatrix() of RigidTransform does
+// not check if the matrix is orthonormal.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <type_traits>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+#include "AffineTransform.h"
+
+// kinds of transform, ordered from the most specific to the most general
+enum TransformKind
+{
+	TRANSFORM_RIGID = 0,        // rotation + translation
+	TRANSFORM_AFFINE,           // linear + translation, bottom row is (0,0,0,1)
+	TRANSFORM_PROJECTIVE        // general 4x4
+};
+
+template <TransformKind K>
+class Transform
+{
+public:
+	// 3x4 for rigid and affine, 4x4 for projective
+	typedef typename std::conditional<K == TRANSFORM_PROJECTIVE, Matrix4, AffineTransform>::type Storage;
+	static const TransformKind KIND = K;
+
+	//constructors
+	constexpr Transform() : mat() {}                    //init with identity
+	constexpr explicit Transform(const Storage& m) : mat(m) {}
+	template <TransformKind K2, class = typename std::enable_if<(K2 < K)>::type>
+	constexpr Transform(const Transform<K2>& rhs);      //widen from more specific kind
+
+	// factories
+	static constexpr Transform fromMatrix(const Matrix4& m);    //assume m is of kind K
+	static Transform fromRotation(const Quaternion& q, const Vector3& translation = Vector3(0, 0, 0));
+	static Transform fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+
+	constexpr const Storage& getStorage() const         { return mat; }
+	constexpr Matrix4   getMatrix() const;              //4x4 matrix for OpenGL
+	constexpr Matrix3   getNormalMatrix() const;        //transpose of inverse of 3x3 part, for normals
+
+	constexpr Transform getInverse() const;
+	constexpr Transform& invert()                       { *this = getInverse(); return *this; }
+
+	//transform vectors
+	constexpr Vector3   transformPoint(const Vector3& p) const;      //divided by w for projective
+	constexpr Vector3   transformDirection(const Vector3& d) const;  //3x3 part only, no translation
+
+	constexpr Transform& operator*=(const Transform& rhs)  { *this = *this * rhs; return *this; }
+	constexpr Vector3   operator*(const Vector3& p) const   { return transformPoint(p); }
+
+private:
+	Storage mat;
+};
+
+typedef Transform<TRANSFORM_RIGID>      RigidTransform;
+typedef Transform<TRANSFORM_AFFINE>     AffinePartTransform;
+typedef Transform<TRANSFORM_PROJECTIVE> ProjectiveTransform;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Transform
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K>
+template <TransformKind K2, class>
+constexpr Transform<K>::Transform(const Transform<K2>& rhs) : mat()
+{
+	if constexpr (K == TRANSFORM_PROJECTIVE)
+		mat = rhs.getMatrix();
+	else
+		mat = rhs.getStorage();
+}
+
+template <TransformKind K>
+constexpr Transform<K> Transform<K>::fromMatrix(const Matrix4& m)
+{
+	return Transform(Storage(m));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rotation (unit quaternion) + translation, valid for all kinds
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K>
+Transform<K> Transform<K>::fromRotation(const Quaternion& q, const Vector3& translation)
+{
+	return fromMatrix(Matrix4::fromTRS(translation, q, Vector3(1, 1, 1)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// M = T*R*S, not available for RigidTransform because of the scale
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K>
+Transform<K> Transform<K>::fromTRS(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	static_assert(K != TRANSFORM_RIGID, "rigid transform cannot have scale");
+	return fromMatrix(Matrix4::fromTRS(translation, rotation, scale));
+}
+
+template <TransformKind K>
+constexpr Matrix4 Transform<K>::getMatrix() const
+{
+	if constexpr (K == TRANSFORM_PROJECTIVE)
+		return mat;
+	else
+		return mat.toMatrix4();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// normal matrix = (L^-1)^T of the upper-left 3x3 L
+// For rigid transform, L is orthonormal, so (L^-1)^T = L.
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K>
+constexpr Matrix3 Transform<K>::getNormalMatrix() const
+{
+	if constexpr (K == TRANSFORM_RIGID)
+	{
+		return mat.getLinear();
+	}
+	else
+	{
+		Matrix3 n;
+		if constexpr (K == TRANSFORM_AFFINE)
+			n = mat.getLinear();
+		else
+			n.set(mat[0], mat[1], mat[2], mat[4], mat[5], mat[6], mat[8], mat[9], mat[10]);
+		n.invert();
+		n.transpose();
+		return n;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse by the kind
+// rigid:      [ R^T | -R^T * T ], no division
+// affine:     [ L^-1 | -L^-1 * T ], same as AffineTransform::invert()
+// projective: Matrix4::invertGeneral()
+// Singular transforms become identity, same as Matrix4::invert().
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K>
+constexpr Transform<K> Transform<K>::getInverse() const
+{
+	Storage m = mat;
+	if constexpr (K == TRANSFORM_RIGID)
+	{
+		Matrix3 r = mat.getLinear();
+		r.transpose();
+		m.setLinear(r);
+		m.setTranslation(-(r * mat.getTranslation()));
+	}
+	else if constexpr (K == TRANSFORM_AFFINE)
+	{
+		m.invert();
+	}
+	else
+	{
+		m.invertGeneral();
+	}
+	return Transform(m);
+}
+
+template <TransformKind K>
+constexpr Vector3 Transform<K>::transformPoint(const Vector3& p) const
+{
+	if constexpr (K == TRANSFORM_PROJECTIVE)
+	{
+		Vector4 v = mat * Vector4(p.x, p.y, p.z, 1);
+		float invW = 1.0f / v.w;
+		return Vector3(v.x * invW, v.y * invW, v.z * invW);
+	}
+	else
+	{
+		return mat.transformPoint(p);
+	}
+}
+
+template <TransformKind K>
+constexpr Vector3 Transform<K>::transformDirection(const Vector3& d) const
+{
+	if constexpr (K == TRANSFORM_PROJECTIVE)
+	{
+		return Vector3(mat[0] * d.x + mat[4] * d.y + mat[8] * d.z,
+			mat[1] * d.x + mat[5] * d.y + mat[9] * d.z,
+			mat[2] * d.x + mat[6] * d.y + mat[10] * d.z);
+	}
+	else
+	{
+		return mat.transformDirection(d);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// composition, the result is the more general kind of the two
+// rigid/affine use the 3x4 product (36 multiply-adds), projective uses the
+// 4x4 product. Both operands are widened to the result kind first.
+///////////////////////////////////////////////////////////////////////////////
+template <TransformKind K1, TransformKind K2>
+constexpr Transform<(K1 > K2 ? K1 : K2)> operator*(const Transform<K1>& lhs, const Transform<K2>& rhs)
+{
+	typedef Transform<(K1 > K2 ? K1 : K2)> Result;
+	return Result(Result(lhs).getStorage() * Result(rhs).getStorage());
+}
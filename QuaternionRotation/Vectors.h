@@ -12,45 +12,55 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include "fastMath.h"
+
+// Vector<T, N> is the generic N-D vector (MatrixN.h). Vector2, Vector3 and
+// Vector4 are its hand-written float specializations below.
+template <class T, int N> struct Vector;
+typedef Vector<float, 2> Vector2;
+typedef Vector<float, 3> Vector3;
+typedef Vector<float, 4> Vector4;
+
 ///////////////////////////////////////////////////////////////////////////////
 // 2D vector
 ///////////////////////////////////////////////////////////////////////////////
 
-struct Vector2
+template <>
+struct Vector<float, 2>
 {
 	float x, y;
-	Vector2() : x(0), y(0) {}
-	Vector2(float x, float y) : x(x), y(y) {}
+	constexpr Vector() : x(0), y(0) {}
+	constexpr Vector(float x, float y) : x(x), y(y) {}
 
 	//Utility functions
-	Vector2& Set(float x, float y);
-	float		Length() const;
+	constexpr Vector2& Set(float x, float y);
+	constexpr float		Length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
 	float		distance(const Vector2& vec) const;			//distance between two vectors
-	Vector2& Normalize();
-	float		dot(const Vector2& vec) const;				//dot product
+	constexpr Vector2& Normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT);	//normalize with the given precision
+	constexpr float		dot(const Vector2& vec) const;				//dot product
 	float		equal(const Vector2& vec, float e) const;	//compare with epsilon
 
 	//operators
-	Vector2		operator-() const;							//unary operator (negate)
-	Vector2		operator+(const Vector2& rhs) const;		//add rhs
-	Vector2		operator-(const Vector2& rhs) const;		//subtract rhs
-	Vector2& operator+=(const Vector2& rhs);		//add rhs and update this object
-	Vector2& operator-=(const Vector2& rhs);		//subtract rhs and update this object
-
-	Vector2		operator*(const float scale) const;			//scale
-	Vector2		operator*(const Vector2& rhs) const;		//multiply each elements
-	Vector2& operator*=(const float scale);				//scale and update this object
-	Vector2& operator*=(const Vector2& rhs);				//multiply each element and update this object
-	Vector2		operator/(const float scale) const;			//inverse scale
-	Vector2& operator/=(const float scale);				//scale and update this object
-
-	bool		operator==(const Vector2& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
-	bool		operator!=(const Vector2& rhs) const;		// exact compare, no epsilon 
-	bool		operator<(const Vector2& rhs) const;		// comparison for sort
+	constexpr Vector2		operator-() const;							//unary operator (negate)
+	constexpr Vector2		operator+(const Vector2& rhs) const;		//add rhs
+	constexpr Vector2		operator-(const Vector2& rhs) const;		//subtract rhs
+	constexpr Vector2& operator+=(const Vector2& rhs);		//add rhs and update this object
+	constexpr Vector2& operator-=(const Vector2& rhs);		//subtract rhs and update this object
+
+	constexpr Vector2		operator*(const float scale) const;			//scale
+	constexpr Vector2		operator*(const Vector2& rhs) const;		//multiply each elements
+	constexpr Vector2& operator*=(const float scale);				//scale and update this object
+	constexpr Vector2& operator*=(const Vector2& rhs);				//multiply each element and update this object
+	constexpr Vector2		operator/(const float scale) const;			//inverse scale
+	constexpr Vector2& operator/=(const float scale);				//scale and update this object
+
+	constexpr bool		operator==(const Vector2& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
+	constexpr bool		operator!=(const Vector2& rhs) const;		// exact compare, no epsilon 
+	constexpr bool		operator<(const Vector2& rhs) const;		// comparison for sort
 	float		operator[](int index) const;				// subscript operator v[0], v[1]
 	float& operator[](int index);						// subscript operator v[0], v[1]
 
-	friend Vector2 operator*(const float a, const Vector2 vec);
+	friend constexpr Vector2 operator*(const float a, const Vector2 vec);
 	friend std::ostream& operator<<(std::ostream& os, const Vector2& vec);
 };
 
@@ -59,76 +69,78 @@ struct Vector2
 // 3D vector
 ///////////////////////////////////////////////////////////////////////////////
 
-struct  Vector3
+template <>
+struct Vector<float, 3>
 {
 	float x, y, z;
-	Vector3() : x(0), y(0), z(0) {}
-	Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+	constexpr Vector() : x(0), y(0), z(0) {}
+	constexpr Vector(float x, float y, float z) : x(x), y(y), z(z) {}
 	//Utility functions
-	Vector3& Set(float x, float y, float z);
-	float		Length() const;
+	constexpr Vector3& Set(float x, float y, float z);
+	constexpr float		Length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
 	float		distance(const Vector3& vec) const;			//distance between two vectors
-	float		angle(const Vector3& vec) const;			//angle between two vectors
-	Vector3& Normalize();
-	float		dot(const Vector3& vec) const;				//dot product
-	Vector3		cross(const Vector3& vec) const;			//cross product
+	constexpr float		angle(const Vector3& vec) const;			//angle between two vectors
+	constexpr Vector3& Normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT);	//normalize with the given precision
+	constexpr float		dot(const Vector3& vec) const;				//dot product
+	constexpr Vector3		cross(const Vector3& vec) const;			//cross product
 	float		equal(const Vector3& vec, float e) const;	//compare with epsilon
 	//operators
-	Vector3		operator-() const;							//unary operator (negate)
-	Vector3		operator+(const Vector3& rhs) const;		//add rhs
-	Vector3		operator-(const Vector3& rhs) const;		//subtract rhs
-	Vector3& operator+=(const Vector3& rhs);		//add rhs and update this object
-	Vector3& operator-=(const Vector3& rhs);		//subtract rhs and update this object
-	Vector3		operator*(const float scale) const;			//scale
-	Vector3		operator*(const Vector3& rhs) const;		//multiply each elements
-	Vector3& operator*=(const float scale);				//scale and update this object
-	Vector3& operator*=(const Vector3& rhs);				//multiply each element and update this object
-	Vector3		operator/(const float scale) const;			//inverse scale
-	Vector3& operator/=(const float scale);				//scale and update this object
-	bool		operator==(const Vector3& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
-	bool		operator!=(const Vector3& rhs) const;		// exact compare, no epsilon 
-	bool		operator<(const Vector3& rhs) const;		// comparison for sort
+	constexpr Vector3		operator-() const;							//unary operator (negate)
+	constexpr Vector3		operator+(const Vector3& rhs) const;		//add rhs
+	constexpr Vector3		operator-(const Vector3& rhs) const;		//subtract rhs
+	constexpr Vector3& operator+=(const Vector3& rhs);		//add rhs and update this object
+	constexpr Vector3& operator-=(const Vector3& rhs);		//subtract rhs and update this object
+	constexpr Vector3		operator*(const float scale) const;			//scale
+	constexpr Vector3		operator*(const Vector3& rhs) const;		//multiply each elements
+	constexpr Vector3& operator*=(const float scale);				//scale and update this object
+	constexpr Vector3& operator*=(const Vector3& rhs);				//multiply each element and update this object
+	constexpr Vector3		operator/(const float scale) const;			//inverse scale
+	constexpr Vector3& operator/=(const float scale);				//scale and update this object
+	constexpr bool		operator==(const Vector3& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
+	constexpr bool		operator!=(const Vector3& rhs) const;		// exact compare, no epsilon 
+	constexpr bool		operator<(const Vector3& rhs) const;		// comparison for sort
 	float		operator[](int index) const;				// subscript operator v[0], v[1], v[2]
 	float& operator[](int index);						// subscript operator v[0], v[1], v[2]
 
-	friend Vector3 operator*(const float a, const Vector3 vec);
+	friend constexpr Vector3 operator*(const float a, const Vector3 vec);
 	friend std::ostream& operator<<(std::ostream& os, const Vector3& vec);
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 // 4D vector
 ///////////////////////////////////////////////////////////////////////////////
-struct Vector4
+template <>
+struct Vector<float, 4>
 {
 	float x, y, z, w;
-	Vector4() : x(0), y(0), z(0), w(0) {}
-	Vector4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+	constexpr Vector() : x(0), y(0), z(0), w(0) {}
+	constexpr Vector(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
 	//Utility functions
-	Vector4& Set(float x, float y, float z, float w);
-	float		Length() const;
+	constexpr Vector4& Set(float x, float y, float z, float w);
+	constexpr float		Length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
 	float		distance(const Vector4& vec) const;			//distance between two vectors
-	Vector4& Normalize();
-	float		dot(const Vector4& vec) const;				//dot product
+	constexpr Vector4& Normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT);	//normalize with the given precision
+	constexpr float		dot(const Vector4& vec) const;				//dot product
 	float		equal(const Vector4& vec, float e) const;	//compare with epsilon
 	//operators
-	Vector4		operator-() const;							//unary operator (negate)
-	Vector4		operator+(const Vector4& rhs) const;		//add rhs
-	Vector4		operator-(const Vector4& rhs) const;		//subtract rhs
-	Vector4& operator+=(const Vector4& rhs);		//add rhs and update this object
-	Vector4& operator-=(const Vector4& rhs);		//subtract rhs and update this object
-	Vector4		operator*(const float scale) const;			//scale
-	Vector4		operator*(const Vector4& rhs) const;		//multiply each elements
-	Vector4& operator*=(const float scale);				//scale and update this object
-	Vector4& operator*=(const Vector4& rhs);				//multiply each element and update this object
-	Vector4		operator/(const float scale) const;			//inverse scale
-	Vector4& operator/=(const float scale);				//scale and update this object
-	bool		operator==(const Vector4& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
-	bool		operator!=(const Vector4& rhs) const;		// exact compare, no epsilon 
-	bool		operator<(const Vector4& rhs) const;		// comparison for sort
+	constexpr Vector4		operator-() const;							//unary operator (negate)
+	constexpr Vector4		operator+(const Vector4& rhs) const;		//add rhs
+	constexpr Vector4		operator-(const Vector4& rhs) const;		//subtract rhs
+	constexpr Vector4& operator+=(const Vector4& rhs);		//add rhs and update this object
+	constexpr Vector4& operator-=(const Vector4& rhs);		//subtract rhs and update this object
+	constexpr Vector4		operator*(const float scale) const;			//scale
+	constexpr Vector4		operator*(const Vector4& rhs) const;		//multiply each elements
+	constexpr Vector4& operator*=(const float scale);				//scale and update this object
+	constexpr Vector4& operator*=(const Vector4& rhs);				//multiply each element and update this object
+	constexpr Vector4		operator/(const float scale) const;			//inverse scale
+	constexpr Vector4& operator/=(const float scale);				//scale and update this object
+	constexpr bool		operator==(const Vector4& rhs) const;		// exact compare, no epsilon //ȷȽϣûepsilon
+	constexpr bool		operator!=(const Vector4& rhs) const;		// exact compare, no epsilon 
+	constexpr bool		operator<(const Vector4& rhs) const;		// comparison for sort
 	float		operator[](int index) const;				// subscript operator v[0], v[1], v[2], v[3]
 	float& operator[](int index);						// subscript operator v[0], v[1],v[2], v[3]
 
-	friend Vector4 operator*(const float a, const Vector4 vec);
+	friend constexpr Vector4 operator*(const float a, const Vector4 vec);
 	friend std::ostream& operator<<(std::ostream& os, const Vector4& vec);
 };
 
@@ -147,82 +159,82 @@ inline float InvSqrt(float x)
 ///////////////////////////////////////////////////////////////////////////////
 // inline functions for Vector2
 ///////////////////////////////////////////////////////////////////////////////
-inline Vector2 Vector2::operator-() const
+constexpr Vector2 Vector2::operator-() const
 {
 	return Vector2(-x, -y);
 }
 
-inline Vector2 Vector2::operator+(const Vector2& rhs) const
+constexpr Vector2 Vector2::operator+(const Vector2& rhs) const
 {
 	return Vector2(x + rhs.x, y + rhs.y);
 }
 
-inline Vector2 Vector2::operator-(const Vector2& rhs) const
+constexpr Vector2 Vector2::operator-(const Vector2& rhs) const
 {
 	return Vector2(x - rhs.x, y - rhs.y);
 }
 
-inline Vector2& Vector2::operator+=(const Vector2& rhs)
+constexpr Vector2& Vector2::operator+=(const Vector2& rhs)
 {
 	x += rhs.x;
 	y += rhs.y;
 	return *this;
 }
 
-inline Vector2& Vector2::operator-=(const Vector2& rhs)
+constexpr Vector2& Vector2::operator-=(const Vector2& rhs)
 {
 	x -= rhs.x;
 	y -= rhs.y;
 	return *this;
 }
 
-inline Vector2 Vector2::operator*(const float a) const
+constexpr Vector2 Vector2::operator*(const float a) const
 {
 	return Vector2(x * a, y * a);
 }
 
-inline Vector2 Vector2::operator*(const Vector2& rhs) const
+constexpr Vector2 Vector2::operator*(const Vector2& rhs) const
 {
 	return Vector2(x * rhs.x, y * rhs.y);
 }
 
-inline Vector2& Vector2::operator*=(const float a)
+constexpr Vector2& Vector2::operator*=(const float a)
 {
 	x *= a;
 	y *= a;
 	return *this;
 }
 
-inline Vector2& Vector2::operator*=(const Vector2& rhs)
+constexpr Vector2& Vector2::operator*=(const Vector2& rhs)
 {
 	x *= rhs.x;
 	y *= rhs.y;
 	return *this;
 }
 
-inline Vector2 Vector2::operator/(const float a) const
+constexpr Vector2 Vector2::operator/(const float a) const
 {
 	return Vector2(x / a, y / a);
 }
 
-inline Vector2& Vector2::operator/=(const float a)
+constexpr Vector2& Vector2::operator/=(const float a)
 {
 	x /= a;
 	y /= a;
 	return *this;
 }
 
-inline bool Vector2::operator==(const Vector2& rhs) const
+constexpr bool Vector2::operator==(const Vector2& rhs) const
 {
 	return (x == rhs.x) && (y == rhs.y);
 }
 
-inline bool Vector2::operator!=(const Vector2& rhs) const
+constexpr bool Vector2::operator!=(const Vector2& rhs) const
 {
 	return (x != rhs.x) || (y != rhs.y);
 }
 
-inline bool Vector2::operator<(const Vector2& rhs) const
+constexpr bool Vector2::operator<(const Vector2& rhs) const
 {
 	if (x < rhs.x) return true;
 	if (x > rhs.x) return false;
@@ -241,16 +253,16 @@ inline float& Vector2::operator[](int index)
 	return (&x)[index];
 }
 
-inline Vector2& Vector2::Set(float x, float y)
+constexpr Vector2& Vector2::Set(float x, float y)
 {
 	this->x = x;
 	this->y = y;
 	return *this;
 }
 
-inline float Vector2::Length() const
+constexpr float Vector2::Length(Gil::NormalizeMode mode) const
 {
-	return sqrtf(x * x + y * y);
+	return Gil::squareRoot(x * x + y * y, mode);
 }
 
 inline float Vector2::distance(const Vector2& vec) const
@@ -260,21 +272,20 @@ inline float Vector2::distance(const Vector2& vec) const
 	return sqrtf(dx * dx + dy * dy);
 }
 
-inline Vector2& Vector2::Normalize()
+constexpr Vector2& Vector2::Normalize(Gil::NormalizeMode mode)
 {
 	//const float EPSILON = 0.000001f;
 	//if (x * x + y * y < EPSILON)
 	//{
 		//return *this;
 	//}
-	float inv = 1.0f / sqrtf(x * x + y * y);
-	//float inv = InvSqrt(x * x + y * y);
+	float inv = Gil::invSqrt(x * x + y * y, mode);
 	x *= inv;
 	y *= inv;
 	return *this;
 }
 
-inline float Vector2::dot(const Vector2& rhs) const
+constexpr float Vector2::dot(const Vector2& rhs) const
 {
 	return x * rhs.x + y * rhs.y;
 }
@@ -284,7 +295,7 @@ inline float Vector2::equal(const Vector2& rhs, float epsilon) const
 	return fabs(x - rhs.x) < epsilon && fabs(y - rhs.y) < epsilon;
 }
 
-inline Vector2 operator*(const float a, const Vector2 vec)
+constexpr Vector2 operator*(const float a, const Vector2 vec)
 {
 	return Vector2(a * vec.x, a * vec.y);
 }
@@ -301,22 +312,22 @@ inline std::ostream& operator<<(std::ostream& os, const Vector2& vec)
 // inline functions for Vector3
 ///////////////////////////////////////////////////////////////////////////////
 
-inline Vector3 Vector3::operator-() const
+constexpr Vector3 Vector3::operator-() const
 {
 	return Vector3(-x, -y, -z);
 }
 
-inline Vector3 Vector3::operator+(const Vector3& rhs) const
+constexpr Vector3 Vector3::operator+(const Vector3& rhs) const
 {
 	return Vector3(x + rhs.x, y + rhs.y, z + rhs.z);
 }
 
-inline Vector3 Vector3::operator-(const Vector3& rhs) const
+constexpr Vector3 Vector3::operator-(const Vector3& rhs) const
 {
 	return Vector3(x - rhs.x, y - rhs.y, z - rhs.z);
 }
 
-inline Vector3& Vector3::operator+=(const Vector3& rhs)
+constexpr Vector3& Vector3::operator+=(const Vector3& rhs)
 {
 	x += rhs.x;
 	y += rhs.y;
@@ -324,7 +335,7 @@ inline Vector3& Vector3::operator+=(const Vector3& rhs)
 	return *this;
 }
 
-inline Vector3& Vector3::operator-=(const Vector3& rhs)
+constexpr Vector3& Vector3::operator-=(const Vector3& rhs)
 {
 	x -= rhs.x;
 	y -= rhs.y;
@@ -332,17 +343,17 @@ inline Vector3& Vector3::operator-=(const Vector3& rhs)
 	return *this;
 }
 
-inline Vector3 Vector3::operator*(const float a) const
+constexpr Vector3 Vector3::operator*(const float a) const
 {
 	return Vector3(x * a, y * a, z * a);
 }
 
-inline Vector3 Vector3::operator*(const Vector3& rhs) const
+constexpr Vector3 Vector3::operator*(const Vector3& rhs) const
 {
 	return Vector3(x * rhs.x, y * rhs.y, z * rhs.z);
 }
 
-inline Vector3& Vector3::operator*=(const float a)
+constexpr Vector3& Vector3::operator*=(const float a)
 {
 	x *= a;
 	y *= a;
@@ -350,7 +361,7 @@ inline Vector3& Vector3::operator*=(const float a)
 	return *this;
 }
 
-inline Vector3& Vector3::operator*=(const Vector3& rhs)
+constexpr Vector3& Vector3::operator*=(const Vector3& rhs)
 {
 	x *= rhs.x;
 	y *= rhs.y;
@@ -358,12 +369,12 @@ inline Vector3& Vector3::operator*=(const Vector3& rhs)
 	return *this;
 }
 
-inline Vector3 Vector3::operator/(const float a) const
+constexpr Vector3 Vector3::operator/(const float a) const
 {
 	return Vector3(x / a, y / a, z / a);
 }
 
-inline Vector3& Vector3::operator/=(const float a)
+constexpr Vector3& Vector3::operator/=(const float a)
 {
 	x /= a;
 	y /= a;
@@ -371,17 +382,17 @@ inline Vector3& Vector3::operator/=(const float a)
 	return *this;
 }
 
-inline bool Vector3::operator==(const Vector3& rhs) const
+constexpr bool Vector3::operator==(const Vector3& rhs) const
 {
 	return (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
 }
 
-inline bool Vector3::operator!=(const Vector3& rhs) const
+constexpr bool Vector3::operator!=(const Vector3& rhs) const
 {
 	return (x != rhs.x) || (y != rhs.y) || (z != rhs.z);
 }
 
-inline bool Vector3::operator<(const Vector3& rhs) const
+constexpr bool Vector3::operator<(const Vector3& rhs) const
 {
 	if (x < rhs.x) return true;
 	if (x > rhs.x) return false;
@@ -402,7 +413,7 @@ inline float& Vector3::operator[](int index)
 	return (&x)[index];
 }
 
-inline Vector3& Vector3::Set(float x, float y, float z)
+constexpr Vector3& Vector3::Set(float x, float y, float z)
 {
 	this->x = x;
 	this->y = y;
@@ -410,9 +421,9 @@ inline Vector3& Vector3::Set(float x, float y, float z)
 	return *this;
 }
 
-inline float Vector3::Length() const
+constexpr float Vector3::Length(Gil::NormalizeMode mode) const
 {
-	return sqrtf(x * x + y * y + z * z);
+	return Gil::squareRoot(x * x + y * y + z * z, mode);
 }
 
 inline float Vector3::distance(const Vector3& vec) const
@@ -423,7 +434,7 @@ inline float Vector3::distance(const Vector3& vec) const
 	return sqrtf(dx * dx + dy * dy + dz * dz);
 }
 
-inline float Vector3::angle(const Vector3& vec) const
+constexpr float Vector3::angle(const Vector3& vec) const
 {
 	// return angle between [0, 180]
 	//float l1 = this->Length();
@@ -439,30 +450,29 @@ inline float Vector3::angle(const Vector3& vec) const
 		lenProduct = 1e-6f;
 	float f = dot(vec) / lenProduct;
 	f = f < -1.0f ? -1.0f : (f > 1.0f ? 1.0f : f);
-	return acosf(f);
+	return Gil::arcCosine(f);
 }
 
-inline Vector3& Vector3::Normalize()
+constexpr Vector3& Vector3::Normalize(Gil::NormalizeMode mode)
 {
 	//const float EPSILON = 0.000001f;
 	//if (x * x + y * y + z * z < EPSILON)
 	//{
 		//return *this;
 	//}
-	float inv = 1.0f / sqrtf(x * x + y * y + z * z);
-	//float inv = InvSqrt(x * x + y * y + z * z);
+	float inv = Gil::invSqrt(x * x + y * y + z * z, mode);
 	x *= inv;
 	y *= inv;
 	z *= inv;
 	return *this;
 }
 
-inline float Vector3::dot(const Vector3& rhs) const
+constexpr float Vector3::dot(const Vector3& rhs) const
 {
 	return x * rhs.x + y * rhs.y + z * rhs.z;
 }
 
-inline Vector3 Vector3::cross(const Vector3& rhs) const
+constexpr Vector3 Vector3::cross(const Vector3& rhs) const
 {
 	return Vector3(
 		y * rhs.z - z * rhs.y,
@@ -475,7 +485,7 @@ inline float Vector3::equal(const Vector3& rhs, float epsilon) const
 	return fabs(x - rhs.x) < epsilon && fabs(y - rhs.y) < epsilon && fabs(z - rhs.z) < epsilon;
 }
 
-inline Vector3 operator*(const float a, const Vector3 vec)
+constexpr Vector3 operator*(const float a, const Vector3 vec)
 {
 	return Vector3(a * vec.x, a * vec.y, a * vec.z);
 }
@@ -491,22 +501,22 @@ inline std::ostream& operator<<(std::ostream& os, const Vector3& vec)
 ///////////////////////////////////////////////////////////////////////////////
 // inline functions for Vector4
 ///////////////////////////////////////////////////////////////////////////////
-inline Vector4 Vector4::operator-() const
+constexpr Vector4 Vector4::operator-() const
 {
 	return Vector4(-x, -y, -z, -w);
 }
 
-inline Vector4 Vector4::operator+(const Vector4& rhs) const
+constexpr Vector4 Vector4::operator+(const Vector4& rhs) const
 {
 	return Vector4(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w);
 }
 
-inline Vector4 Vector4::operator-(const Vector4& rhs) const
+constexpr Vector4 Vector4::operator-(const Vector4& rhs) const
 {
 	return Vector4(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w);
 }
 
-inline Vector4& Vector4::operator+=(const Vector4& rhs)
+constexpr Vector4& Vector4::operator+=(const Vector4& rhs)
 {
 	x += rhs.x;
 	y += rhs.y;
@@ -515,7 +525,7 @@ inline Vector4& Vector4::operator+=(const Vector4& rhs)
 	return *this;
 }
 
-inline Vector4& Vector4::operator-=(const Vector4& rhs)
+constexpr Vector4& Vector4::operator-=(const Vector4& rhs)
 {
 	x -= rhs.x;
 	y -= rhs.y;
@@ -524,17 +534,17 @@ inline Vector4& Vector4::operator-=(const Vector4& rhs)
 	return *this;
 }
 
-inline Vector4 Vector4::operator*(const float a) const
+constexpr Vector4 Vector4::operator*(const float a) const
 {
 	return Vector4(x * a, y * a, z * a, w * a);
 }
 
-inline Vector4 Vector4::operator*(const Vector4& rhs) const
+constexpr Vector4 Vector4::operator*(const Vector4& rhs) const
 {
 	return Vector4(x * rhs.x, y * rhs.y, z * rhs.z, w * rhs.w);
 }
 
-inline Vector4& Vector4::operator*=(const float a)
+constexpr Vector4& Vector4::operator*=(const float a)
 {
 	x *= a;
 	y *= a;
@@ -543,7 +553,7 @@ inline Vector4& Vector4::operator*=(const float a)
 	return *this;
 }
 
-inline Vector4& Vector4::operator*=(const Vector4& rhs)
+constexpr Vector4& Vector4::operator*=(const Vector4& rhs)
 {
 	x *= rhs.x;
 	y *= rhs.y;
@@ -552,12 +562,12 @@ inline Vector4& Vector4::operator*=(const Vector4& rhs)
 	return *this;
 }
 
-inline Vector4 Vector4::operator/(const float a) const
+constexpr Vector4 Vector4::operator/(const float a) const
 {
 	return Vector4(x / a, y / a, z / a, w / a);
 }
 
-inline Vector4& Vector4::operator/=(const float a)
+constexpr Vector4& Vector4::operator/=(const float a)
 {
 	x /= a;
 	y /= a;
@@ -566,17 +576,17 @@ inline Vector4& Vector4::operator/=(const float a)
 	return *this;
 }
 
-inline bool Vector4::operator==(const Vector4& rhs) const
+constexpr bool Vector4::operator==(const Vector4& rhs) const
 {
 	return (x == rhs.x) && (y == rhs.y) && (z == rhs.z) && (w == rhs.w);
 }
 
-inline bool Vector4::operator!=(const Vector4& rhs) const
+constexpr bool Vector4::operator!=(const Vector4& rhs) const
 {
 	return (x != rhs.x) || (y != rhs.y) || (z != rhs.z) || (w != rhs.w);
 }
 
-inline bool Vector4::operator<(const Vector4& rhs) const
+constexpr bool Vector4::operator<(const Vector4& rhs) const
 {
 	if (x < rhs.x) return true;
 	if (x > rhs.x) return false;
@@ -599,7 +609,7 @@ inline float& Vector4::operator[](int index)
 	return (&x)[index];
 }
 
-inline Vector4& Vector4::Set(float x, float y, float z, float w)
+constexpr Vector4& Vector4::Set(float x, float y, float z, float w)
 {
 	this->x = x;
 	this->y = y;
@@ -608,9 +618,9 @@ inline Vector4& Vector4::Set(float x, float y, float z, float w)
 	return *this;
 }
 
-inline float Vector4::Length() const
+constexpr float Vector4::Length(Gil::NormalizeMode mode) const
 {
-	return sqrtf(x * x + y * y + z * z + w * w);
+	return Gil::squareRoot(x * x + y * y + z * z + w * w, mode);
 }
 
 inline float Vector4::distance(const Vector4& vec) const
@@ -622,15 +632,14 @@ inline float Vector4::distance(const Vector4& vec) const
 	return sqrtf(dx * dx + dy * dy + dz * dz + dw * dw);
 }
 
-inline Vector4& Vector4::Normalize()
+constexpr Vector4& Vector4::Normalize(Gil::NormalizeMode mode)
 {
 	//const float EPSILON = 0.000001f;
 	//if (x * x + y * y + z * z + w * w < EPSILON)
 	//{
 		//return *this;
 	//}
-	float inv = 1.0f / sqrtf(x * x + y * y + z * z + w * w);
-	//float inv = InvSqrt(x * x + y * y + z * z + w * w);
+	float inv = Gil::invSqrt(x * x + y * y + z * z + w * w, mode);
 	x *= inv;
 	y *= inv;
 	z *= inv;
@@ -638,7 +647,7 @@ inline Vector4& Vector4::Normalize()
 	return *this;
 }
 
-inline float Vector4::dot(const Vector4& rhs) const
+constexpr float Vector4::dot(const Vector4& rhs) const
 {
 	return x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w;
 }
@@ -648,7 +657,7 @@ inline float Vector4::equal(const Vector4& rhs, float epsilon) const
 	return fabs(x - rhs.x) < epsilon && fabs(y - rhs.y) < epsilon && fabs(z - rhs.z) < epsilon && fabs(w - rhs.w) < epsilon;
 }
 
-inline Vector4 operator*(const float a, const Vector4 vec)
+constexpr Vector4 operator*(const float a, const Vector4 vec)
 {
 	return Vector4(a * vec.x, a * vec.y, a * vec.z, a * vec.w);
 }
@@ -0,0 +1,794 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// VectorsA.h
+// ==========
+// 16-byte aligned variants of the math types. The members are in a union
+// with a SSE register (__m128), so the operators compile to single vector
+// instructions and the values stay in registers between operations.
+// The member access is the same as Vector3, Vector4 and Quaternion (v.x,
+// q.s, ...). Without SSE, they fall back to the scalar members.
+//
+//   Vector3A     same API as Vector3, padded with w = 0 (16 bytes)
+//   Vector4A     same API as Vector4
+//   QuaternionA  same API as Quaternion
+//
+// They convert implicitly from Vector3/Vector4/Quaternion, and back
+// explicitly with toVector3()/toVector4()/toQuaternion(). Arrays of Vector3
+// are converted with Gil::toAligned()/fromAligned() of mathBatch.h.
+// The functions are not constexpr; use Vector3, Vector4 and Quaternion for
+// constant expressions.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+#ifdef GIL_SSE
+namespace Gil
+{
+	///////////////////////////////////////////////////////////////////////////
+	// dot product of 4 lanes, broadcast to all lanes
+	///////////////////////////////////////////////////////////////////////////
+	inline __m128 dot4(__m128 a, __m128 b)
+	{
+		__m128 r = _mm_mul_ps(a, b);
+		r = _mm_add_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 0, 3, 2)));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// column-major matrix * vector, m does not need to be aligned
+	///////////////////////////////////////////////////////////////////////////
+	inline __m128 multiplyMatrix4Vector(const float* m, __m128 v)
+	{
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(m), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 4), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 8), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+		return _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(m + 12), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+} //end of namespace Gil
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 3D vector in SSE register
+// w is padding and always 0, so it does not change dot() or Length().
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) Vector3A
+{
+	union
+	{
+#ifdef GIL_SSE
+		__m128 v;
+#endif
+		struct { float x, y, z, w; };
+	};
+
+	Vector3A() : x(0), y(0), z(0), w(0) {}
+	Vector3A(float x, float y, float z) : x(x), y(y), z(z), w(0) {}
+	Vector3A(const Vector3& vec) : x(vec.x), y(vec.y), z(vec.z), w(0) {}
+#ifdef GIL_SSE
+	explicit Vector3A(__m128 r) : v(r) {}   //w of r must be 0
+#endif
+	Vector3     toVector3() const { return Vector3(x, y, z); }
+
+	//Utility functions
+	Vector3A&   Set(float x, float y, float z);
+	float       Length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
+	float       distance(const Vector3A& vec) const;          //distance between two vectors
+	float       angle(const Vector3A& vec) const;             //angle between two vectors
+	Vector3A&   Normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT);    //normalize with the given precision, 0 stays 0
+	float       dot(const Vector3A& vec) const;               //dot product
+	Vector3A    cross(const Vector3A& vec) const;             //cross product
+	float       equal(const Vector3A& vec, float e) const;    //compare with epsilon
+	//operators
+	Vector3A    operator-() const;                            //unary operator (negate)
+	Vector3A    operator+(const Vector3A& rhs) const;         //add rhs
+	Vector3A    operator-(const Vector3A& rhs) const;         //subtract rhs
+	Vector3A&   operator+=(const Vector3A& rhs);              //add rhs and update this object
+	Vector3A&   operator-=(const Vector3A& rhs);              //subtract rhs and update this object
+	Vector3A    operator*(const float scale) const;           //scale
+	Vector3A    operator*(const Vector3A& rhs) const;         //multiply each elements
+	Vector3A&   operator*=(const float scale);                //scale and update this object
+	Vector3A&   operator*=(const Vector3A& rhs);              //multiply each element and update this object
+	Vector3A    operator/(const float scale) const;           //inverse scale
+	Vector3A&   operator/=(const float scale);                //scale and update this object
+	bool        operator==(const Vector3A& rhs) const;        // exact compare, no epsilon
+	bool        operator!=(const Vector3A& rhs) const;        // exact compare, no epsilon
+	bool        operator<(const Vector3A& rhs) const;         // comparison for sort
+	float       operator[](int index) const;                  // subscript operator v[0], v[1], v[2]
+	float&      operator[](int index);                        // subscript operator v[0], v[1], v[2]
+
+	friend Vector3A operator*(const float a, const Vector3A& vec);
+	friend Vector3A operator*(const Matrix4& m, const Vector3A& vec);   // v' = M * (v, 1), same as Matrix4 * Vector3
+	friend std::ostream& operator<<(std::ostream& os, const Vector3A& vec);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// 4D vector in SSE register
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) Vector4A
+{
+	union
+	{
+#ifdef GIL_SSE
+		__m128 v;
+#endif
+		struct { float x, y, z, w; };
+	};
+
+	Vector4A() : x(0), y(0), z(0), w(0) {}
+	Vector4A(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+	Vector4A(const Vector4& vec) : x(vec.x), y(vec.y), z(vec.z), w(vec.w) {}
+#ifdef GIL_SSE
+	explicit Vector4A(__m128 r) : v(r) {}
+#endif
+	Vector4     toVector4() const { return Vector4(x, y, z, w); }
+
+	//Utility functions
+	Vector4A&   Set(float x, float y, float z, float w);
+	float       Length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
+	float       distance(const Vector4A& vec) const;          //distance between two vectors
+	Vector4A&   Normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT);    //normalize with the given precision, 0 stays 0
+	float       dot(const Vector4A& vec) const;               //dot product
+	float       equal(const Vector4A& vec, float e) const;    //compare with epsilon
+	//operators
+	Vector4A    operator-() const;                            //unary operator (negate)
+	Vector4A    operator+(const Vector4A& rhs) const;         //add rhs
+	Vector4A    operator-(const Vector4A& rhs) const;         //subtract rhs
+	Vector4A&   operator+=(const Vector4A& rhs);              //add rhs and update this object
+	Vector4A&   operator-=(const Vector4A& rhs);              //subtract rhs and update this object
+	Vector4A    operator*(const float scale) const;           //scale
+	Vector4A    operator*(const Vector4A& rhs) const;         //multiply each elements
+	Vector4A&   operator*=(const float scale);                //scale and update this object
+	Vector4A&   operator*=(const Vector4A& rhs);              //multiply each element and update this object
+	Vector4A    operator/(const float scale) const;           //inverse scale
+	Vector4A&   operator/=(const float scale);                //scale and update this object
+	bool        operator==(const Vector4A& rhs) const;        // exact compare, no epsilon
+	bool        operator!=(const Vector4A& rhs) const;        // exact compare, no epsilon
+	bool        operator<(const Vector4A& rhs) const;         // comparison for sort
+	float       operator[](int index) const;                  // subscript operator v[0], v[1], v[2], v[3]
+	float&      operator[](int index);                        // subscript operator v[0], v[1], v[2], v[3]
+
+	friend Vector4A operator*(const float a, const Vector4A& vec);
+	friend Vector4A operator*(const Matrix4& m, const Vector4A& vec);   // v' = M * v
+	friend std::ostream& operator<<(std::ostream& os, const Vector4A& vec);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternion in SSE register, (s, x, y, z) in lane 0 to 3
+///////////////////////////////////////////////////////////////////////////////
+struct alignas(16) QuaternionA
+{
+	union
+	{
+#ifdef GIL_SSE
+		__m128 v;
+#endif
+		struct { float s, x, y, z; };
+	};
+
+	//constructors
+	QuaternionA() : s(0), x(0), y(0), z(0) {}
+	QuaternionA(float s, float x, float y, float z) : s(s), x(x), y(y), z(z) {}
+	QuaternionA(const Vector3& axis, float angle) : QuaternionA(Quaternion(axis, angle)) {} // rot axis & angle (radian)
+	QuaternionA(const Quaternion& q) : s(q.s), x(q.x), y(q.y), z(q.z) {}
+#ifdef GIL_SSE
+	explicit QuaternionA(__m128 r) : v(r) {}
+#endif
+	Quaternion  toQuaternion() const { return Quaternion(s, x, y, z); }
+
+	//Uti functions
+	void        Set(float s, float x, float y, float z);
+	void        Set(const Vector3& axis, float angle);      // half angle (radian)
+	float       length(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT) const;
+	QuaternionA& normalize(Gil::NormalizeMode mode = Gil::NORMALIZE_EXACT); //normalize with the given precision
+	QuaternionA& conjugate();                               //conjugate of quaternion
+	QuaternionA& invert();                                  //inverse of quaternion
+	Matrix4     getMatrix() const;
+	Vector3     getVector() const;
+
+	//operators
+	QuaternionA operator-() const;                          //unary operator (negate)
+	QuaternionA operator+(const QuaternionA& rhs) const;    //addition
+	QuaternionA operator-(const QuaternionA& rhs) const;    //subtraction
+	QuaternionA operator*(float a) const;                   //scalar multiplication
+	QuaternionA operator*(const QuaternionA& rhs) const;    //multiplication
+	QuaternionA operator*(const Vector3& v) const;          // conjugation for rotation
+	QuaternionA& operator+=(const QuaternionA& rhs);        //addition and update
+	QuaternionA& operator-=(const QuaternionA& rhs);        //subtraction and update
+	QuaternionA& operator*=(float a);                       //scalar multiplication and update
+	QuaternionA& operator*=(const QuaternionA& rhs);        //quaternion multiplication and update
+	bool        operator==(const QuaternionA& rhs) const;   //exact comparison
+	bool        operator!=(const QuaternionA& rhs) const;   //exact comparison
+
+	friend QuaternionA operator*(float a, const QuaternionA& q); //pre-multiplication
+	friend std::ostream& operator<<(std::ostream& os, const QuaternionA& q);
+};
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Vector3A
+///////////////////////////////////////////////////////////////////////////////
+inline Vector3A Vector3A::operator-() const
+{
+#ifdef GIL_SSE
+	return Vector3A(_mm_sub_ps(_mm_setzero_ps(), v));
+#else
+	return Vector3A(-x, -y, -z);
+#endif
+}
+
+inline Vector3A Vector3A::operator+(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector3A(_mm_add_ps(v, rhs.v));
+#else
+	return Vector3A(x + rhs.x, y + rhs.y, z + rhs.z);
+#endif
+}
+
+inline Vector3A Vector3A::operator-(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector3A(_mm_sub_ps(v, rhs.v));
+#else
+	return Vector3A(x - rhs.x, y - rhs.y, z - rhs.z);
+#endif
+}
+
+inline Vector3A& Vector3A::operator+=(const Vector3A& rhs)
+{
+	*this = *this + rhs;
+	return *this;
+}
+
+inline Vector3A& Vector3A::operator-=(const Vector3A& rhs)
+{
+	*this = *this - rhs;
+	return *this;
+}
+
+inline Vector3A Vector3A::operator*(const float a) const
+{
+#ifdef GIL_SSE
+	return Vector3A(_mm_mul_ps(v, _mm_set1_ps(a)));
+#else
+	return Vector3A(x * a, y * a, z * a);
+#endif
+}
+
+inline Vector3A Vector3A::operator*(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector3A(_mm_mul_ps(v, rhs.v));
+#else
+	return Vector3A(x * rhs.x, y * rhs.y, z * rhs.z);
+#endif
+}
+
+inline Vector3A& Vector3A::operator*=(const float a)
+{
+	*this = *this * a;
+	return *this;
+}
+
+inline Vector3A& Vector3A::operator*=(const Vector3A& rhs)
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+inline Vector3A Vector3A::operator/(const float a) const
+{
+#ifdef GIL_SSE
+	// clear w, 0/0 is NaN if a is 0
+	const __m128 MASK_XYZ = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	return Vector3A(_mm_and_ps(_mm_div_ps(v, _mm_set1_ps(a)), MASK_XYZ));
+#else
+	return Vector3A(x / a, y / a, z / a);
+#endif
+}
+
+inline Vector3A& Vector3A::operator/=(const float a)
+{
+	*this = *this / a;
+	return *this;
+}
+
+inline bool Vector3A::operator==(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	return (_mm_movemask_ps(_mm_cmpeq_ps(v, rhs.v)) & 0x7) == 0x7;
+#else
+	return (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
+#endif
+}
+
+inline bool Vector3A::operator!=(const Vector3A& rhs) const
+{
+	return !(*this == rhs);
+}
+
+inline bool Vector3A::operator<(const Vector3A& rhs) const
+{
+	return toVector3() < rhs.toVector3();
+}
+
+inline float Vector3A::operator[](int index) const
+{
+	return (&x)[index];
+}
+
+inline float& Vector3A::operator[](int index)
+{
+	return (&x)[index];
+}
+
+inline Vector3A& Vector3A::Set(float x, float y, float z)
+{
+	*this = Vector3A(x, y, z);
+	return *this;
+}
+
+inline float Vector3A::dot(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	return _mm_cvtss_f32(Gil::dot4(v, rhs.v));
+#else
+	return x * rhs.x + y * rhs.y + z * rhs.z;
+#endif
+}
+
+inline Vector3A Vector3A::cross(const Vector3A& rhs) const
+{
+#ifdef GIL_SSE
+	// (y z x) * (z' x' y') - (z x y) * (y' z' x'), w = 0*0 - 0*0
+	__m128 a1 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b1 = _mm_shuffle_ps(rhs.v, rhs.v, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 a2 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 b2 = _mm_shuffle_ps(rhs.v, rhs.v, _MM_SHUFFLE(3, 0, 2, 1));
+	return Vector3A(_mm_sub_ps(_mm_mul_ps(a1, b1), _mm_mul_ps(a2, b2)));
+#else
+	return Vector3A(toVector3().cross(rhs.toVector3()));
+#endif
+}
+
+inline float Vector3A::Length(Gil::NormalizeMode mode) const
+{
+	return Gil::squareRoot(dot(*this), mode);
+}
+
+inline float Vector3A::distance(const Vector3A& vec) const
+{
+	Vector3A d = *this - vec;
+	return sqrtf(d.dot(d));
+}
+
+inline float Vector3A::angle(const Vector3A& vec) const
+{
+	return toVector3().angle(vec.toVector3());
+}
+
+inline Vector3A& Vector3A::Normalize(Gil::NormalizeMode mode)
+{
+	// do nothing if it is zero, 0 * inf would put NaN in w
+#ifdef GIL_SSE
+	__m128 d = Gil::dot4(v, v);
+	if (_mm_cvtss_f32(d) < 0.00001f)
+		return *this;
+	v = _mm_mul_ps(v, Gil::invSqrt4(d, mode));
+#else
+	float d = dot(*this);
+	if (d < 0.00001f)
+		return *this;
+	*this *= Gil::invSqrt(d, mode);
+#endif
+	return *this;
+}
+
+inline float Vector3A::equal(const Vector3A& rhs, float epsilon) const
+{
+#ifdef GIL_SSE
+	const __m128 ABS = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 d = _mm_and_ps(_mm_sub_ps(v, rhs.v), ABS);
+	return (_mm_movemask_ps(_mm_cmplt_ps(d, _mm_set1_ps(epsilon))) & 0x7) == 0x7;
+#else
+	return toVector3().equal(rhs.toVector3(), epsilon);
+#endif
+}
+
+inline Vector3A operator*(const float a, const Vector3A& vec)
+{
+	return vec * a;
+}
+
+inline Vector3A operator*(const Matrix4& m, const Vector3A& vec)
+{
+#ifdef GIL_SSE
+	// w = 1 for the translation, then clear the 4th row
+	const __m128 MASK_XYZ = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	__m128 p = _mm_or_ps(vec.v, _mm_setr_ps(0, 0, 0, 1));
+	return Vector3A(_mm_and_ps(Gil::multiplyMatrix4Vector(m.get(), p), MASK_XYZ));
+#else
+	return Vector3A(m * vec.toVector3());
+#endif
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector3A& vec)
+{
+	return os << vec.toVector3();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for Vector4A
+///////////////////////////////////////////////////////////////////////////////
+inline Vector4A Vector4A::operator-() const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_sub_ps(_mm_setzero_ps(), v));
+#else
+	return Vector4A(-x, -y, -z, -w);
+#endif
+}
+
+inline Vector4A Vector4A::operator+(const Vector4A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_add_ps(v, rhs.v));
+#else
+	return Vector4A(x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w);
+#endif
+}
+
+inline Vector4A Vector4A::operator-(const Vector4A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_sub_ps(v, rhs.v));
+#else
+	return Vector4A(x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w);
+#endif
+}
+
+inline Vector4A& Vector4A::operator+=(const Vector4A& rhs)
+{
+	*this = *this + rhs;
+	return *this;
+}
+
+inline Vector4A& Vector4A::operator-=(const Vector4A& rhs)
+{
+	*this = *this - rhs;
+	return *this;
+}
+
+inline Vector4A Vector4A::operator*(const float a) const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_mul_ps(v, _mm_set1_ps(a)));
+#else
+	return Vector4A(x * a, y * a, z * a, w * a);
+#endif
+}
+
+inline Vector4A Vector4A::operator*(const Vector4A& rhs) const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_mul_ps(v, rhs.v));
+#else
+	return Vector4A(x * rhs.x, y * rhs.y, z * rhs.z, w * rhs.w);
+#endif
+}
+
+inline Vector4A& Vector4A::operator*=(const float a)
+{
+	*this = *this * a;
+	return *this;
+}
+
+inline Vector4A& Vector4A::operator*=(const Vector4A& rhs)
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+inline Vector4A Vector4A::operator/(const float a) const
+{
+#ifdef GIL_SSE
+	return Vector4A(_mm_div_ps(v, _mm_set1_ps(a)));
+#else
+	return Vector4A(x / a, y / a, z / a, w / a);
+#endif
+}
+
+inline Vector4A& Vector4A::operator/=(const float a)
+{
+	*this = *this / a;
+	return *this;
+}
+
+inline bool Vector4A::operator==(const Vector4A& rhs) const
+{
+#ifdef GIL_SSE
+	return _mm_movemask_ps(_mm_cmpeq_ps(v, rhs.v)) == 0xf;
+#else
+	return (x == rhs.x) && (y == rhs.y) && (z == rhs.z) && (w == rhs.w);
+#endif
+}
+
+inline bool Vector4A::operator!=(const Vector4A& rhs) const
+{
+	return !(*this == rhs);
+}
+
+inline bool Vector4A::operator<(const Vector4A& rhs) const
+{
+	return toVector4() < rhs.toVector4();
+}
+
+inline float Vector4A::operator[](int index) const
+{
+	return (&x)[index];
+}
+
+inline float& Vector4A::operator[](int index)
+{
+	return (&x)[index];
+}
+
+inline Vector4A& Vector4A::Set(float x, float y, float z, float w)
+{
+	*this = Vector4A(x, y, z, w);
+	return *this;
+}
+
+inline float Vector4A::dot(const Vector4A& rhs) const
+{
+#ifdef GIL_SSE
+	return _mm_cvtss_f32(Gil::dot4(v, rhs.v));
+#else
+	return x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w;
+#endif
+}
+
+inline float Vector4A::Length(Gil::NormalizeMode mode) const
+{
+	return Gil::squareRoot(dot(*this), mode);
+}
+
+inline float Vector4A::distance(const Vector4A& vec) const
+{
+	return sqrtf((*this - vec).dot(*this - vec));
+}
+
+inline Vector4A& Vector4A::Normalize(Gil::NormalizeMode mode)
+{
+	// do nothing if it is zero, same as Vector3A::Normalize()
+#ifdef GIL_SSE
+	__m128 d = Gil::dot4(v, v);
+	if (_mm_cvtss_f32(d) < 0.00001f)
+		return *this;
+	v = _mm_mul_ps(v, Gil::invSqrt4(d, mode));
+#else
+	float d = dot(*this);
+	if (d < 0.00001f)
+		return *this;
+	*this *= Gil::invSqrt(d, mode);
+#endif
+	return *this;
+}
+
+inline float Vector4A::equal(const Vector4A& rhs, float epsilon) const
+{
+#ifdef GIL_SSE
+	const __m128 ABS = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 d = _mm_and_ps(_mm_sub_ps(v, rhs.v), ABS);
+	return _mm_movemask_ps(_mm_cmplt_ps(d, _mm_set1_ps(epsilon))) == 0xf;
+#else
+	return toVector4().equal(rhs.toVector4(), epsilon);
+#endif
+}
+
+inline Vector4A operator*(const float a, const Vector4A& vec)
+{
+	return vec * a;
+}
+
+inline Vector4A operator*(const Matrix4& m, const Vector4A& vec)
+{
+#ifdef GIL_SSE
+	return Vector4A(Gil::multiplyMatrix4Vector(m.get(), vec.v));
+#else
+	return Vector4A(m * vec.toVector4());
+#endif
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector4A& vec)
+{
+	return os << vec.toVector4();
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// inline functions for QuaternionA
+///////////////////////////////////////////////////////////////////////////////
+inline void QuaternionA::Set(float s, float x, float y, float z)
+{
+	*this = QuaternionA(s, x, y, z);
+}
+
+inline void QuaternionA::Set(const Vector3& axis, float angle)
+{
+	*this = QuaternionA(axis, angle);
+}
+
+inline float QuaternionA::length(Gil::NormalizeMode mode) const
+{
+#ifdef GIL_SSE
+	return Gil::squareRoot(_mm_cvtss_f32(Gil::dot4(v, v)), mode);
+#else
+	return toQuaternion().length(mode);
+#endif
+}
+
+inline QuaternionA& QuaternionA::normalize(Gil::NormalizeMode mode)
+{
+#ifdef GIL_SSE
+	// do nothing if it is zero, same as Quaternion::normalize()
+	__m128 d = Gil::dot4(v, v);
+	if (_mm_cvtss_f32(d) < 0.00001f)
+		return *this;
+	v = _mm_mul_ps(v, Gil::invSqrt4(d, mode));
+#else
+	Quaternion q = toQuaternion();
+	*this = q.normalize(mode);
+#endif
+	return *this;
+}
+
+inline QuaternionA& QuaternionA::conjugate()
+{
+#ifdef GIL_SSE
+	v = _mm_xor_ps(v, _mm_castsi128_ps(_mm_setr_epi32(0, 0x80000000, 0x80000000, 0x80000000)));
+#else
+	x = -x;  y = -y;  z = -z;
+#endif
+	return *this;
+}
+
+inline QuaternionA& QuaternionA::invert()
+{
+#ifdef GIL_SSE
+	__m128 d = Gil::dot4(v, v);
+	if (_mm_cvtss_f32(d) < 0.00001f)
+		return *this; // do nothing if it is zero
+	conjugate();
+	v = _mm_div_ps(v, d);   // q* / |q||q|
+#else
+	Quaternion q = toQuaternion();
+	*this = q.invert();
+#endif
+	return *this;
+}
+
+inline Matrix4 QuaternionA::getMatrix() const
+{
+	return toQuaternion().getMatrix();
+}
+
+inline Vector3 QuaternionA::getVector() const
+{
+	return Vector3(x, y, z);
+}
+
+inline QuaternionA QuaternionA::operator-() const
+{
+#ifdef GIL_SSE
+	return QuaternionA(_mm_sub_ps(_mm_setzero_ps(), v));
+#else
+	return QuaternionA(-s, -x, -y, -z);
+#endif
+}
+
+inline QuaternionA QuaternionA::operator+(const QuaternionA& rhs) const
+{
+#ifdef GIL_SSE
+	return QuaternionA(_mm_add_ps(v, rhs.v));
+#else
+	return QuaternionA(s + rhs.s, x + rhs.x, y + rhs.y, z + rhs.z);
+#endif
+}
+
+inline QuaternionA QuaternionA::operator-(const QuaternionA& rhs) const
+{
+#ifdef GIL_SSE
+	return QuaternionA(_mm_sub_ps(v, rhs.v));
+#else
+	return QuaternionA(s - rhs.s, x - rhs.x, y - rhs.y, z - rhs.z);
+#endif
+}
+
+inline QuaternionA QuaternionA::operator*(float a) const
+{
+#ifdef GIL_SSE
+	return QuaternionA(_mm_mul_ps(v, _mm_set1_ps(a)));
+#else
+	return QuaternionA(s * a, x * a, y * a, z * a);
+#endif
+}
+
+inline QuaternionA QuaternionA::operator*(const QuaternionA& rhs) const
+{
+#ifdef GIL_SSE
+	return QuaternionA(Gil::multiplyQuaternion(v, rhs.v));
+#else
+	return QuaternionA(toQuaternion() * rhs.toQuaternion());
+#endif
+}
+
+inline QuaternionA QuaternionA::operator*(const Vector3& vec) const
+{
+	return *this * QuaternionA(0, vec.x, vec.y, vec.z);
+}
+
+inline QuaternionA& QuaternionA::operator+=(const QuaternionA& rhs)
+{
+	*this = *this + rhs;
+	return *this;
+}
+
+inline QuaternionA& QuaternionA::operator-=(const QuaternionA& rhs)
+{
+	*this = *this - rhs;
+	return *this;
+}
+
+inline QuaternionA& QuaternionA::operator*=(float a)
+{
+	*this = *this * a;
+	return *this;
+}
+
+inline QuaternionA& QuaternionA::operator*=(const QuaternionA& rhs)
+{
+	*this = *this * rhs;
+	return *this;
+}
+
+inline bool QuaternionA::operator==(const QuaternionA& rhs) const
+{
+#ifdef GIL_SSE
+	return _mm_movemask_ps(_mm_cmpeq_ps(v, rhs.v)) == 0xf;
+#else
+	return (s == rhs.s) && (x == rhs.x) && (y == rhs.y) && (z == rhs.z);
+#endif
+}
+
+inline bool QuaternionA::operator!=(const QuaternionA& rhs) const
+{
+	return !(*this == rhs);
+}
+
+inline QuaternionA operator*(float a, const QuaternionA& q)
+{
+	return q * a;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const QuaternionA& q)
+{
+	return os << q.toQuaternion();
+}
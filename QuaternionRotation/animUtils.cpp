@@ -46,12 +46,12 @@ Vector3 Gil::slerp(const Vector3& from, const Vector3& to, float alpha, Animatio
 	//@@ FIXME: handle if angle is ~180 degree
 	//float dot = from.dot(to);
 	float cosine = from.dot(to) / (from.Length() * to.Length());
-	float angle = acosf(cosine);
-	float invSine = 1.0f / sinf(angle);
+	float angle = Gil::arcCosine(cosine);
+	float invSine = 1.0f / Gil::sine(angle);
 
 	// compute the scale factors
-	float scale1 = sinf((1 - t) * angle) * invSine;
-	float scale2 = sinf(t * angle) * invSine;
+	float scale1 = Gil::sine((1 - t) * angle) * invSine;
+	float scale2 = Gil::sine(t * angle) * invSine;
 
 	// compute slerp-ed vector
 	return scale1 * from + scale2 * to;
@@ -92,18 +92,20 @@ Quaternion Gil::slerp(const Quaternion& from, const Quaternion& to, float alpha,
 		//std::cout << v2 << std::endl;
 
 		// referenced from Jonathan Blow's Understanding Slerp
-		float angle = acosf(dot) * t;
-		Vector3 v3 = v1 * cosf(angle) + v2 * sinf(angle);
+		float angle = Gil::arcCosine(dot) * t;
+		float sine, cosine;
+		Gil::sinCos(angle, sine, cosine);
+		Vector3 v3 = v1 * cosine + v2 * sine;
 		return Quaternion(0, v3.x, v3.y, v3.z);
 	}
 
 	// determine the angle between
-	float angle = acosf(dot);
+	float angle = Gil::arcCosine(dot);
 	float invSine = 1.0f / sqrtf(1 - dot * dot);  // = 1 / sin(angle)
 
 	// compute the scale factors
-	float scale1 = sinf((1 - t) * angle) * invSine;
-	float scale2 = sinf(t * angle) * invSine;
+	float scale1 = Gil::sine((1 - t) * angle) * invSine;
+	float scale2 = Gil::sine(t * angle) * invSine;
 
 	return Quaternion(from * scale1 + to * scale2);
 }
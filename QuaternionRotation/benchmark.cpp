@@ -0,0 +1,724 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.cpp
+// =============
+// Micro benchmarks of the math library.
+// Each benchmark runs the same work with the different implementations and
+// prints the best time of several runs, and the result checksum to make sure
+// the compiler does not remove the work.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include "benchmark.h"
+#include "Vectors.h"
+#include "Quaternion.h"
+#include "vectorExpr.h"
+#include "blockArray.h"
+#include "animUtils.h"
+#include "Timer.h"
+#include "simdDispatch.h"
+#include "halfFloat.h"
+#include "mortonOrder.h"
+#include "hugePages.h"
+#include "transformStore.h"
+#include "transformIntern.h"
+#include "transformChain.h"
+#include "transformBuilder.h"
+#include "mathBatch.h"
+
+namespace
+{
+	const int RUNS = 5;                         // best of 5 runs
+
+	///////////////////////////////////////////////////////////////////////////
+	// return the best time of RUNS calls of func() in micro-second
+	///////////////////////////////////////////////////////////////////////////
+	template <class Func>
+	double bestTime(Func func)
+	{
+		Timer t;
+		double best = 0;
+		for (int i = 0; i < RUNS; ++i)
+		{
+			t.start();
+			func();
+			t.stop();
+			double elapsed = t.getElapsedTimeInMicroSec();
+			if (i == 0 || elapsed < best)
+				best = elapsed;
+		}
+		return best;
+	}
+
+	float random(float min, float max)
+	{
+		return min + (max - min) * ((float)rand() / RAND_MAX);
+	}
+
+	Vector3 randomVector3()
+	{
+		return Vector3(random(-1, 1), random(-1, 1), random(-1, 1));
+	}
+
+	Quaternion randomQuaternion()
+	{
+		Quaternion q(random(-1, 1), random(-1, 1), random(-1, 1), random(-1, 1));
+		return q.normalize();
+	}
+
+	float checksum(const Vector3* vecs, int count)
+	{
+		float sum = 0;
+		for (int i = 0; i < count; ++i)
+			sum += vecs[i].x + vecs[i].y + vecs[i].z;
+		return sum;
+	}
+
+	float checksum(const Quaternion* quats, int count)
+	{
+		float sum = 0;
+		for (int i = 0; i < count; ++i)
+			sum += quats[i].s + quats[i].x + quats[i].y + quats[i].z;
+		return sum;
+	}
+
+	template <class T>
+	float checksum(const Gil::BlockArray<T>& a)
+	{
+		std::vector<T> v(a.size());
+		a.toArray(&v[0]);
+		return checksum(&v[0], a.size());
+	}
+
+	void printError(const char* name, float error)
+	{
+		std::cout << std::setw(40) << std::left << name
+			<< "   max error " << std::scientific << std::setprecision(1) << error << std::fixed << std::endl;
+	}
+
+	// largest component difference, to check results that must be the same
+	float maxError(const Quaternion* a, const Quaternion* b, int count)
+	{
+		float error = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			Quaternion d = a[i] - b[i];
+			error = std::max(error, std::max(std::max(fabsf(d.s), fabsf(d.x)), std::max(fabsf(d.y), fabsf(d.z))));
+		}
+		return error;
+	}
+
+	float checksum(const std::vector<float>* streams, int n)
+	{
+		float sum = 0;
+		for (int c = 0; c < n; ++c)
+			for (size_t i = 0; i < streams[c].size(); ++i)
+				sum += streams[c][i];
+		return sum;
+	}
+
+	// SoA streams of Vector3 or Quaternion
+	template <int N>
+	struct Streams
+	{
+		std::vector<float> s[N];
+		float* p[N];
+		Streams(int count)
+		{
+			for (int c = 0; c < N; ++c)
+			{
+				s[c].resize(count);
+				p[c] = &s[c][0];
+			}
+		}
+		const float* const* in() const  { return p; }
+	};
+
+	void printResult(const char* name, double time, float sum)
+	{
+		std::cout << std::setw(40) << std::left << name
+			<< std::setw(12) << std::right << std::fixed << std::setprecision(1) << time << " us"
+			<< "   (checksum " << std::setprecision(3) << sum << ")" << std::endl;
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// run all benchmarks
+///////////////////////////////////////////////////////////////////////////////
+void Gil::runBenchmarks()
+{
+	benchmarkExpressions(1 << 20);
+	benchmarkLayouts(1 << 20);
+	benchmarkDispatch(1 << 20);
+	benchmarkMorton(1 << 20);
+	benchmarkHugePages(1 << 25);
+	benchmarkTransformStore(1 << 18);
+	benchmarkInterning(1 << 18);
+	benchmarkTransformChain(1 << 21);
+	benchmarkTransformBuilder(1 << 18);
+	benchmarkQuaternionBatch((1 << 20) + 3);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// compare the regular operators with the expression templates
+// 1. r[i] = a[i] + s*b[i] + t*c[i]
+// 2. the vector part of quaternion product, cross(u, v) + us*v + vs*u
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkExpressions(int count)
+{
+	using namespace Gil::expr;
+
+	std::vector<Vector3> a(count), b(count), c(count), r(count);
+	std::vector<float> w(count);
+	for (int i = 0; i < count; ++i)
+	{
+		a[i] = randomVector3();
+		b[i] = randomVector3();
+		c[i] = randomVector3();
+		w[i] = random(0, 1);
+	}
+	const float s = 0.3f, t = 0.7f;
+	double time;
+
+	std::cout << "===== Expression templates (" << count << " Vector3) =====" << std::endl;
+
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+			r[i] = a[i] + s * b[i] + t * c[i];
+	});
+	printResult("operators: a + s*b + t*c", time, checksum(&r[0], count));
+
+	time = bestTime([&]() {
+		assign(&r[0], count, array(&a[0]) + s * array(&b[0]) + t * array(&c[0]));
+	});
+	printResult("expression: a + s*b + t*c", time, checksum(&r[0], count));
+
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+			r[i] = a[i].cross(b[i]) + w[i] * b[i] + t * a[i];
+	});
+	printResult("operators: cross(a,b) + w*b + t*a", time, checksum(&r[0], count));
+
+	time = bestTime([&]() {
+		assign(&r[0], count, cross(array(&a[0]), array(&b[0])) + array(&w[0]) * array(&b[0]) + t * array(&a[0]));
+	});
+	printResult("expression: cross(a,b) + w*b + t*a", time, checksum(&r[0], count));
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// compare the memory layouts on the core operations
+// AoS:   Vector3/Quaternion arrays with the member functions
+// SoA:   separate stream per component with the SoA kernels
+// AoSoA: Gil::BlockArray with the block kernels
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkLayouts(int count)
+{
+	std::vector<Vector3> vecs(count), outVecs(count);
+	std::vector<Quaternion> quats(count), quats2(count), outQuats(count);
+	for (int i = 0; i < count; ++i)
+	{
+		vecs[i] = randomVector3();
+		quats[i] = randomQuaternion();
+		quats2[i] = randomQuaternion();
+	}
+	Matrix4 m;
+	m.rotate(30, 1, 2, 3).translate(1, 2, 3);
+	const float t = 0.3f;
+	double time;
+
+	Streams<3> soaVecs(count), soaOutVecs(count);
+	Streams<4> soaQuats(count), soaQuats2(count), soaOutQuats(count);
+	for (int i = 0; i < count; ++i)
+	{
+		for (int c = 0; c < 3; ++c)
+			soaVecs.p[c][i] = expr::Components<Vector3>::get(vecs[i], c);
+		for (int c = 0; c < 4; ++c)
+		{
+			soaQuats.p[c][i] = expr::Components<Quaternion>::get(quats[i], c);
+			soaQuats2.p[c][i] = expr::Components<Quaternion>::get(quats2[i], c);
+		}
+	}
+	BlockArray<Vector3> blockVecs(&vecs[0], count), blockOutVecs(count);
+	BlockArray<Quaternion> blockQuats(&quats[0], count), blockQuats2(&quats2[0], count), blockOutQuats(count);
+
+	std::cout << "===== Memory layouts (" << count << " elements) =====" << std::endl;
+
+	// transform points
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+			outVecs[i] = m * vecs[i];
+	});
+	printResult("AoS:   transform points", time, checksum(&outVecs[0], count));
+	time = bestTime([&]() { transformPoints(m, soaVecs.in(), soaOutVecs.p, count); });
+	printResult("SoA:   transform points", time, checksum(soaOutVecs.s, 3));
+	time = bestTime([&]() { transformPoints(m, blockVecs, blockOutVecs); });
+	printResult("AoSoA: transform points", time, checksum(blockOutVecs));
+
+	// rotate vectors by quaternions, q * v * q^-1
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+		{
+			const Quaternion& q = quats[i];
+			Vector3 u(q.x, q.y, q.z);
+			Vector3 c = 2.0f * u.cross(vecs[i]);
+			outVecs[i] = vecs[i] + q.s * c + u.cross(c);
+		}
+	});
+	printResult("AoS:   rotate vectors", time, checksum(&outVecs[0], count));
+	time = bestTime([&]() { rotate(soaQuats.in(), soaVecs.in(), soaOutVecs.p, count); });
+	printResult("SoA:   rotate vectors", time, checksum(soaOutVecs.s, 3));
+	time = bestTime([&]() { rotate(blockQuats, blockVecs, blockOutVecs); });
+	printResult("AoSoA: rotate vectors", time, checksum(blockOutVecs));
+
+	// slerp
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+			outQuats[i] = slerp(quats[i], quats2[i], t);
+	});
+	printResult("AoS:   slerp", time, checksum(&outQuats[0], count));
+	time = bestTime([&]() { slerp(soaQuats.in(), soaQuats2.in(), t, soaOutQuats.p, count); });
+	printResult("SoA:   slerp", time, checksum(soaOutQuats.s, 4));
+	time = bestTime([&]() { slerp(blockQuats, blockQuats2, t, blockOutQuats); });
+	printResult("AoSoA: slerp", time, checksum(blockOutQuats));
+
+	// normalize quaternions (already unit length, so repeating does not change them)
+	time = bestTime([&]() {
+		for (int i = 0; i < count; ++i)
+			quats[i].normalize();
+	});
+	printResult("AoS:   normalize quaternions", time, checksum(&quats[0], count));
+	time = bestTime([&]() { normalize4(soaQuats.p, count); });
+	printResult("SoA:   normalize quaternions", time, checksum(soaQuats.s, 4));
+	time = bestTime([&]() { normalize(blockQuats); });
+	printResult("AoSoA: normalize quaternions", time, checksum(blockQuats));
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// same kernels with the table of each level supported by the CPU
+// The checksums of the levels differ only by rounding (FMA, polynomial
+// evaluation order).
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkDispatch(int count)
+{
+	Streams<1> angles(count), sines(count), cosines(count);
+	Streams<3> vecs(count), outVecs(count);
+	Streams<4> quats(count), quats2(count), outQuats(count);
+	std::vector<Quaternion> aosQuats(count), aosQuats2(count), aosOutQuats(count);
+	for (int i = 0; i < count; ++i)
+	{
+		angles.p[0][i] = random(-10, 10);
+		Vector3 v = randomVector3();
+		Quaternion q = randomQuaternion();
+		Quaternion q2 = randomQuaternion();
+		for (int c = 0; c < 3; ++c)
+			vecs.p[c][i] = expr::Components<Vector3>::get(v, c);
+		for (int c = 0; c < 4; ++c)
+		{
+			quats.p[c][i] = expr::Components<Quaternion>::get(q, c);
+			quats2.p[c][i] = expr::Components<Quaternion>::get(q2, c);
+		}
+		aosQuats[i] = q;
+		aosQuats2[i] = q2;
+	}
+	Matrix4 m;
+	m.rotate(30, 1, 2, 3).translate(1, 2, 3);
+	const int matrixCount = count / 16;
+	std::vector<float> matrices(matrixCount * 16), matrices2(matrixCount * 16), outMatrices(matrixCount * 16);
+	for (int i = 0; i < matrixCount * 16; ++i)
+	{
+		matrices[i] = random(-1, 1);
+		matrices2[i] = random(-1, 1);
+	}
+	std::vector<float> floats(count * 3), decoded(count * 3);
+	std::vector<Half> halves(count * 3);
+	for (int i = 0; i < count * 3; ++i)
+		floats[i] = random(-100, 100);
+	const float mortonMin[3] = { -100, -100, -100 };
+	const float mortonScale[3] = { 1024 / 200.0f, 1024 / 200.0f, 1024 / 200.0f };
+	std::vector<unsigned int> codes(count);
+	double time;
+
+	std::cout << "===== SIMD levels (" << count << " elements, selected: "
+		<< getSimdLevelName(getKernels().level) << ") =====" << std::endl;
+	for (int level = SIMD_SCALAR; level <= SIMD_AVX512; ++level)
+	{
+		const KernelTable* k = getKernels((SimdLevel)level);
+		if (!k)
+			break;
+		std::string name = std::string(getSimdLevelName((SimdLevel)level)) + ": ";
+
+		time = bestTime([&]() { k->sinCos(angles.p[0], sines.p[0], cosines.p[0], count); });
+		printResult((name + "sinCos").c_str(), time, checksum(sines.s, 1) + checksum(cosines.s, 1));
+		time = bestTime([&]() { k->transformPoints(m.get(), vecs.in(), outVecs.p, count); });
+		printResult((name + "transform points").c_str(), time, checksum(outVecs.s, 3));
+		time = bestTime([&]() { k->slerp(quats.in(), quats2.in(), 0.3f, outQuats.p, count); });
+		printResult((name + "slerp").c_str(), time, checksum(outQuats.s, 4));
+		time = bestTime([&]() { k->multiplyQuaternions(&aosQuats[0].s, &aosQuats2[0].s, &aosOutQuats[0].s, count); });
+		printResult((name + "multiply quaternions").c_str(), time, checksum(&aosOutQuats[0], count));
+		time = bestTime([&]() { k->multiplyMatrices(&matrices[0], &matrices2[0], &outMatrices[0], matrixCount, 16); });
+		printResult((name + "multiply matrices (1/16)").c_str(), time, checksum(&outMatrices, 1));
+		time = bestTime([&]() { k->toHalf(&floats[0], &halves[0], count * 3); });
+		printResult((name + "float to half (x3)").c_str(), time, (float)halves[count]);
+		time = bestTime([&]() { k->fromHalf(&halves[0], &decoded[0], count * 3); });
+		printResult((name + "half to float (x3)").c_str(), time, checksum(&decoded, 1));
+		time = bestTime([&]() { k->mortonCodes30(&floats[0], count, mortonMin, mortonScale, &codes[0]); });
+		printResult((name + "Morton codes").c_str(), time, (float)codes[count / 2]);
+	}
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// sort points by std::sort with Vector3::operator< (lexicographic) and by
+// Morton order, then sum the distances between the consecutive points; the
+// smaller the sum, the better the locality of the order
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkMorton(int count)
+{
+	std::vector<Vector3> points(count), sorted(count);
+	for (int i = 0; i < count; ++i)
+		points[i] = randomVector3();
+	std::vector<int> order(count);
+	std::vector<unsigned int> codes(count);
+	Vector3 min, max;
+	getBounds(&points[0], count, min, max);
+	double time;
+
+	// sum of the distances between the consecutive points in the order
+	auto pathLength = [&]() -> float
+	{
+		float sum = 0;
+		for (int i = 1; i < count; ++i)
+			sum += points[order[i]].distance(points[order[i - 1]]);
+		return sum;
+	};
+
+	std::cout << "===== Morton order (" << count << " points) =====" << std::endl;
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; ++i)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&](int a, int b) { return points[a] < points[b]; });
+	});
+	printResult("std::sort, operator<", time, pathLength());
+	time = bestTime([&]() { mortonCodes(&points[0], count, min, max, &codes[0]); });
+	printResult("Morton codes (30-bit)", time, (float)codes[count / 2]);
+	time = bestTime([&]()
+	{
+		mortonCodes(&points[0], count, min, max, &codes[0]);
+		for (int i = 0; i < count; ++i)
+			order[i] = i;
+		radixSort(&codes[0], &order[0], count);
+	});
+	printResult("Morton codes + radix sort (30-bit)", time, pathLength());
+	time = bestTime([&]() { mortonOrder(&points[0], count, &order[0], MORTON_30); });
+	printResult("mortonOrder (30-bit)", time, pathLength());
+	time = bestTime([&]() { mortonOrder(&points[0], count, &order[0], MORTON_63); });
+	printResult("mortonOrder (63-bit)", time, pathLength());
+	time = bestTime([&]() { reorder(&points[0], &order[0], &sorted[0], count); });
+	printResult("reorder", time, checksum(&sorted[0], count));
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// random gather from a large float buffer allocated with each huge page
+// policy; the same random indices for all, so the difference is the TLB
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkHugePages(int count)
+{
+	const int GATHERS = 1 << 22;
+	std::vector<int> indices(GATHERS);
+	for (int i = 0; i < GATHERS; ++i)
+		indices[i] = (int)(((long long)rand() * (RAND_MAX + 1LL) + rand()) % count);
+	const char* names[] = { "normal pages", "transparent huge pages", "explicit huge pages" };
+	HugePagePolicy saved = getHugePagePolicy();
+	double time;
+
+	std::cout << "===== Huge pages (" << count * sizeof(float) / (1 << 20) << " MB, "
+		<< GATHERS << " random loads) =====" << std::endl;
+	for (int policy = HUGE_PAGES_OFF; policy <= HUGE_PAGES_EXPLICIT; ++policy)
+	{
+		setHugePagePolicy((HugePagePolicy)policy);
+		float* buffer = (float*)allocateAligned(count * sizeof(float));
+		if (!buffer)
+			break;
+		for (int i = 0; i < count; ++i)
+			buffer[i] = (float)(i & 0xff);
+
+		float sum = 0;
+		time = bestTime([&]()
+		{
+			sum = 0;
+			for (int i = 0; i < GATHERS; ++i)
+				sum += buffer[indices[i]];
+		});
+		printResult(names[policy], time, sum);
+
+		HugePageStats stats = getHugePageStats();
+		std::cout << "    huge pages: " << stats.hugeBytes() * 100 / stats.bytes << "% of live bytes, "
+			<< getResidentHugePageBytes(buffer) / (1 << 20) << " MB resident, "
+			<< stats.fallbacks << " fallbacks" << std::endl;
+		freeAligned(buffer);
+	}
+	setHugePagePolicy(saved);
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// create, animate, update and destroy objects of TransformStore
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkTransformStore(int count)
+{
+	TransformStore store;
+	std::vector<TransformHandle> handles(count);
+	Quaternion spin = randomQuaternion();
+	double time;
+
+	std::cout << "===== Transform store (" << count << " objects) =====" << std::endl;
+	time = bestTime([&]()
+	{
+		store.clear();
+		for (int i = 0; i < count; ++i)
+			handles[i] = store.create(randomVector3(), randomQuaternion());
+	});
+	printResult("create", time, checksum(store.positions(), store.size()));
+	time = bestTime([&]()
+	{
+		Quaternion* rotations = store.rotations();
+		for (int i = 0; i < store.size(); ++i)
+			rotations[i] = spin * rotations[i];
+	});
+	printResult("rotate all", time, checksum(store.rotations(), store.size()));
+	time = bestTime([&]() { store.updateWorldMatrices(); });
+	printResult("update world matrices", time, store.worldMatrices()[count / 2].get()[12]);
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; ++i)
+			store.setPosition(handles[(i * 7919) % count], Vector3(0, 0, 0));
+	});
+	printResult("set position by handle (random)", time, checksum(store.positions(), store.size()));
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; i += 2)
+			store.destroy(handles[i]);
+		for (int i = 0; i < count; i += 2)
+			handles[i] = store.create();
+	});
+	printResult("destroy + create half", time, (float)store.size());
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// instanced scene: many objects with a few distinct rotations and scales,
+// a matrix per object vs interned shared matrices
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkInterning(int count)
+{
+	const int DISTINCT = 256;
+	Quaternion rotations[DISTINCT];
+	for (int i = 0; i < DISTINCT; ++i)
+		rotations[i] = randomQuaternion();
+	std::vector<Quaternion> objectRotations(count);
+	std::vector<Vector3> objectScales(count);
+	for (int i = 0; i < count; ++i)
+	{
+		int k = rand() % DISTINCT;
+		objectRotations[i] = rotations[k];
+		objectScales[i] = Vector3(1, 1, 1) * (float)(1 + k % 4);
+	}
+	std::vector<Matrix4> matrices(count);
+	std::vector<int> ids(count);
+	TransformInterner interner;
+	double time;
+
+	std::cout << "===== Transform interning (" << count << " objects, " << DISTINCT << " distinct) =====" << std::endl;
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; ++i)
+			matrices[i] = Matrix4::fromTRS(Vector3(0, 0, 0), objectRotations[i], objectScales[i]);
+	});
+	printResult("matrix per object", time, matrices[count / 2].get()[0]);
+	time = bestTime([&]()
+	{
+		interner.clear();
+		for (int i = 0; i < count; ++i)
+			ids[i] = interner.acquire(Vector3(0, 0, 0), objectRotations[i], objectScales[i]);
+	});
+	printResult("interned", time, interner.getMatrix(ids[count / 2]).get()[0]);
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; ++i)
+			ids[i] = interner.update(ids[i], Vector3(0, 0, 0), objectRotations[i], objectScales[i]);
+	});
+	printResult("update, same values", time, interner.getMatrix(ids[count / 2]).get()[0]);
+
+	InternStats stats = interner.getStats();
+	std::cout << "    " << stats.slots << " shared matrices, " << stats.slots * sizeof(Matrix4) / 1024
+		<< " KB vs " << count * sizeof(Matrix4) / 1024 << " KB" << std::endl;
+
+	time = bestTime([&]()
+	{
+		interner.clear();
+		for (int i = 0; i < count; ++i)
+			ids[i] = interner.acquire(objectRotations[i]);
+	});
+	printResult("interned, rotation only", time, interner.getMatrix(ids[count / 2]).get()[0]);
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// K matrices over a point set larger than the caches: one pass per matrix,
+// the product of the matrices, and the tiled chain
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkTransformChain(int count)
+{
+	const int STEPS = 8;
+	Matrix4 matrices[STEPS];
+	for (int s = 0; s < STEPS; ++s)
+		matrices[s].rotate(random(0, 90), random(-1, 1), random(-1, 1), 1).translate(randomVector3());
+	Matrix4 product = matrices[0];
+	for (int s = 1; s < STEPS; ++s)
+		product = matrices[s] * product;
+
+	std::vector<Vector3> points(count), out(count);
+	Streams<3> vecs(count), outVecs(count);
+	for (int i = 0; i < count; ++i)
+	{
+		points[i] = randomVector3();
+		for (int c = 0; c < 3; ++c)
+			vecs.p[c][i] = expr::Components<Vector3>::get(points[i], c);
+	}
+	const KernelTable& kernels = getKernels();
+	double time;
+
+	std::cout << "===== Transform chain (" << count << " points, " << STEPS << " matrices, tile "
+		<< getChainTileSize() << ") =====" << std::endl;
+	time = bestTime([&]()
+	{
+		kernels.transformPoints(matrices[0].get(), vecs.in(), outVecs.p, count);
+		for (int s = 1; s < STEPS; ++s)
+			kernels.transformPoints(matrices[s].get(), outVecs.in(), outVecs.p, count);
+	});
+	printResult("SoA: pass per matrix", time, checksum(outVecs.s, 3));
+	time = bestTime([&]() { kernels.transformPoints(product.get(), vecs.in(), outVecs.p, count); });
+	printResult("SoA: product of matrices", time, checksum(outVecs.s, 3));
+	time = bestTime([&]() { transformPointsChain(matrices, STEPS, vecs.in(), outVecs.p, count); });
+	printResult("SoA: tiled chain", time, checksum(outVecs.s, 3));
+	time = bestTime([&]() { transformPointsChain(matrices, STEPS, &points[0], &out[0], count); });
+	printResult("AoS: tiled chain", time, checksum(&out[0], count));
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// typical model matrix chain with Matrix4 calls and with TransformBuilder
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkTransformBuilder(int count)
+{
+	std::vector<Vector3> positions(count), angles(count);
+	for (int i = 0; i < count; ++i)
+	{
+		positions[i] = randomVector3();
+		angles[i] = randomVector3() * 180.0f;
+	}
+	Vector3 axes[3] = { Vector3(1, 1, 0), Vector3(0, 1, 1), Vector3(1, 0, 1) };
+	for (int k = 0; k < 3; ++k)
+		axes[k].Normalize();
+	std::vector<Matrix4> matrices(count);
+	double time;
+
+	std::cout << "===== Transform builder (" << count << " matrices) =====" << std::endl;
+	time = bestTime([&]()
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			Matrix4& m = matrices[i];
+			m.identity();
+			m.scale(2).rotate(angles[i].x, axes[0]).rotate(angles[i].y, axes[1]).rotate(angles[i].z, axes[2]).translate(positions[i]);
+		}
+	});
+	printResult("Matrix4 calls", time, matrices[count / 2].get()[0] + matrices[count / 2].get()[12]);
+	time = bestTime([&]()
+	{
+		TransformBuilder b;
+		for (int i = 0; i < count; ++i)
+		{
+			b.clear();
+			b.scale(2).rotate(angles[i].x, axes[0]).rotate(angles[i].y, axes[1]).rotate(angles[i].z, axes[2]).translate(positions[i]);
+			matrices[i] = b.build();
+		}
+	});
+	printResult("TransformBuilder", time, matrices[count / 2].get()[0] + matrices[count / 2].get()[12]);
+	std::cout << std::endl;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// quaternion batches of mathBatch.h, to a separate output and in place
+// The in-place runs must give the same values, also when the single
+// quaternion is an element of the output (an odd count covers the tail).
+///////////////////////////////////////////////////////////////////////////////
+void Gil::benchmarkQuaternionBatch(int count)
+{
+	std::vector<Quaternion> a(count), b(count), out(count), inPlace(count);
+	for (int i = 0; i < count; ++i)
+	{
+		a[i] = randomQuaternion();
+		b[i] = randomQuaternion();
+	}
+	double time;
+
+	std::cout << "===== Quaternion batches (" << count << " quaternions) =====" << std::endl;
+	time = bestTime([&]() { multiply(&a[0], &b[0], &out[0], count); });
+	printResult("a[i] * b[i]", time, checksum(&out[0], count));
+	inPlace = a;
+	multiply(&inPlace[0], &b[0], &inPlace[0], count);
+	printError("a[i] * b[i] in place", maxError(&out[0], &inPlace[0], count));
+
+	time = bestTime([&]() { multiply(a[0], &b[0], &out[0], count); });
+	printResult("a * b[i]", time, checksum(&out[0], count));
+	inPlace = b;
+	inPlace[0] = a[0];
+	multiply(inPlace[0], &b[0], &inPlace[0], count);
+	printError("a * b[i], a in out", maxError(&out[0], &inPlace[0], count));
+
+	// short chains, the product of a long one drifts from unit length
+	const int CHAIN = 1027;
+	time = bestTime([&]() { multiplyPrefix(&a[0], &out[0], CHAIN); });
+	printResult("prefix product (1027)", time, checksum(&out[0], CHAIN));
+	inPlace = a;
+	multiplyPrefix(&inPlace[0], &inPlace[0], CHAIN);
+	printError("prefix product in place", maxError(&out[0], &inPlace[0], CHAIN));
+	std::cout << std::endl;
+}
@@ -0,0 +1,28 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.h
+// ===========
+// Micro benchmarks of the math library. Run the program with "-bench" option
+// to print the results to the console instead of opening the window.
+// Build in Release mode to get the meaningful numbers.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Gil
+{
+	void runBenchmarks();                       // run all benchmarks
+	void benchmarkExpressions(int count);       // operators vs expression templates
+	void benchmarkLayouts(int count);           // AoS vs SoA vs AoSoA
+	void benchmarkDispatch(int count);          // kernels of each SIMD level of the CPU
+	void benchmarkMorton(int count);            // lexicographic vs Morton sort of points
+	void benchmarkHugePages(int count);         // random loads with normal vs huge pages
+	void benchmarkTransformStore(int count);    // dense transform store operations
+	void benchmarkInterning(int count);         // matrix per object vs shared matrices
+	void benchmarkTransformChain(int count);    // pass per matrix vs tiled chain
+	void benchmarkTransformBuilder(int count);  // Matrix4 calls vs recorded and merged steps
+	void benchmarkQuaternionBatch(int count);   // quaternion batches, separate output vs in place
+} //end of namespace Gil
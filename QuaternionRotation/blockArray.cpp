@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// blockArray.cpp
+// ==============
+// SoA and AoSoA kernels for Vector3 and Quaternion.
+// The lane kernels are in simdKernels.h, and the instruction set is selected
+// at run time (see simdDispatch.h); this file checks the opposite
+// quaternions of slerp, which the kernels do not handle.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "blockArray.h"
+#include "animUtils.h"
+#include "simdDispatch.h"
+
+namespace
+{
+	const int SLERP_CHUNK = 128;    // elements checked before each slerp kernel call
+
+	///////////////////////////////////////////////////////////////////////////
+	// opposite quaternions for slerp
+	// The rotation axis of 2 opposite quaternions is undefined, so they are
+	// computed with Gil::slerp() before the kernel overwrites the input (out
+	// may be the same as from); it is rare and a scalar check is enough.
+	///////////////////////////////////////////////////////////////////////////
+	struct SlerpFixes
+	{
+		int index[SLERP_CHUNK];
+		Quaternion q[SLERP_CHUNK];
+		int count;
+
+		SlerpFixes() : index(), count(0) {}
+
+		// check n elements from i of SoA streams; index is relative to base
+		void find(const float* const from[4], const float* const to[4], float t, int i, int n, int base)
+		{
+			for (int j = i; j < i + n; ++j)
+			{
+				Quaternion a(from[0][j], from[1][j], from[2][j], from[3][j]);
+				Quaternion b(to[0][j], to[1][j], to[2][j], to[3][j]);
+				if (fabs(1 + a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z) < 0.001f)
+				{
+					index[count] = base + j - i;
+					q[count++] = Gil::slerp(a, b, t);
+				}
+			}
+		}
+	};
+
+	// first float of blocks, or 0 for empty array
+	template <class T>
+	const float* blockData(const Gil::BlockArray<T>& a)
+	{
+		return a.data() ? a.data()->c[0] : 0;
+	}
+
+	template <class T>
+	float* blockData(Gil::BlockArray<T>& a)
+	{
+		return a.data() ? a.data()->c[0] : 0;
+	}
+
+	// the kernels also write the unused lanes of the last block, e.g. the
+	// translation of M * (0, 0, 0, 1), so they are set back to 0
+	template <class T>
+	void clearUnusedLanes(Gil::BlockArray<T>& a)
+	{
+		int used = a.size() % Gil::BLOCK_WIDTH;
+		if (used == 0)
+			return;
+		Gil::Block<T>& last = a.data()[a.blockCount() - 1];
+		for (int c = 0; c < Gil::Block<T>::SIZE; ++c)
+		{
+			for (int lane = used; lane < Gil::BLOCK_WIDTH; ++lane)
+				last.c[c][lane] = 0;
+		}
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SoA kernels, see simdKernels.h
+///////////////////////////////////////////////////////////////////////////////
+void Gil::transformPoints(const Matrix4& m, const float* const in[3], float* const out[3], int count)
+{
+	getKernels().transformPoints(m.get(), in, out, count);
+}
+
+void Gil::rotate(const float* const quats[4], const float* const vecs[3], float* const out[3], int count)
+{
+	getKernels().rotate(quats, vecs, out, count);
+}
+
+void Gil::slerp(const float* const from[4], const float* const to[4], float t, float* const out[4], int count)
+{
+	const KernelTable& kernels = getKernels();
+	for (int i = 0; i < count; i += SLERP_CHUNK)
+	{
+		int n = count - i < SLERP_CHUNK ? count - i : SLERP_CHUNK;
+		SlerpFixes fixes;
+		fixes.find(from, to, t, i, n, i);
+
+		const float* a[4] = { from[0] + i, from[1] + i, from[2] + i, from[3] + i };
+		const float* b[4] = { to[0] + i, to[1] + i, to[2] + i, to[3] + i };
+		float* o[4] = { out[0] + i, out[1] + i, out[2] + i, out[3] + i };
+		kernels.slerp(a, b, t, o, n);
+
+		for (int k = 0; k < fixes.count; ++k)
+		{
+			int j = fixes.index[k];
+			const Quaternion& q = fixes.q[k];
+			out[0][j] = q.s;  out[1][j] = q.x;  out[2][j] = q.y;  out[3][j] = q.z;
+		}
+	}
+}
+
+void Gil::normalize3(float* const vecs[3], int count)
+{
+	getKernels().normalize3(vecs, count);
+}
+
+void Gil::normalize4(float* const quats[4], int count)
+{
+	getKernels().normalize4(quats, count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// AoSoA kernels, 8 lanes of each block
+///////////////////////////////////////////////////////////////////////////////
+void Gil::transformPoints(const Matrix4& m, const BlockArray<Vector3>& in, BlockArray<Vector3>& out)
+{
+	out.resize(in.size());
+	getKernels().transformPointBlocks(m.get(), blockData(in), blockData(out), in.blockCount());
+	clearUnusedLanes(out);
+}
+
+void Gil::rotate(const BlockArray<Quaternion>& quats, const BlockArray<Vector3>& vecs, BlockArray<Vector3>& out)
+{
+	out.resize(quats.size() < vecs.size() ? quats.size() : vecs.size());
+	getKernels().rotateBlocks(blockData(quats), blockData(vecs), blockData(out), out.blockCount());
+	clearUnusedLanes(out);
+}
+
+void Gil::slerp(const BlockArray<Quaternion>& from, const BlockArray<Quaternion>& to, float t,
+	BlockArray<Quaternion>& out)
+{
+	const int CHUNK_BLOCKS = SLERP_CHUNK / BLOCK_WIDTH;
+	const KernelTable& kernels = getKernels();
+	out.resize(from.size() < to.size() ? from.size() : to.size());
+	const Block<Quaternion>* a = from.data();
+	const Block<Quaternion>* b = to.data();
+	Block<Quaternion>* dst = out.data();
+	for (int i = 0; i < out.blockCount(); i += CHUNK_BLOCKS)
+	{
+		int n = out.blockCount() - i < CHUNK_BLOCKS ? out.blockCount() - i : CHUNK_BLOCKS;
+		SlerpFixes fixes;
+		for (int k = 0; k < n; ++k)
+		{
+			const float* pa[4] = { a[i + k].c[0], a[i + k].c[1], a[i + k].c[2], a[i + k].c[3] };
+			const float* pb[4] = { b[i + k].c[0], b[i + k].c[1], b[i + k].c[2], b[i + k].c[3] };
+			fixes.find(pa, pb, t, 0, BLOCK_WIDTH, k * BLOCK_WIDTH);
+		}
+
+		kernels.slerpBlocks(a[i].c[0], b[i].c[0], t, dst[i].c[0], n);
+
+		for (int k = 0; k < fixes.count; ++k)
+		{
+			Block<Quaternion>& d = dst[i + fixes.index[k] / BLOCK_WIDTH];
+			int lane = fixes.index[k] % BLOCK_WIDTH;
+			const Quaternion& q = fixes.q[k];
+			d.c[0][lane] = q.s;  d.c[1][lane] = q.x;  d.c[2][lane] = q.y;  d.c[3][lane] = q.z;
+		}
+	}
+	clearUnusedLanes(out);
+}
+
+void Gil::normalize(BlockArray<Vector3>& vecs)
+{
+	getKernels().normalize3Blocks(blockData(vecs), vecs.blockCount());
+	clearUnusedLanes(vecs);
+}
+
+void Gil::normalize(BlockArray<Quaternion>& quats)
+{
+	getKernels().normalize4Blocks(blockData(quats), quats.blockCount());
+	clearUnusedLanes(quats);
+}
@@ -0,0 +1,204 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// blockArray.h
+// ============
+// AoSoA (array of structures of arrays) container for Vector3 and Quaternion.
+// The elements are stored in blocks of 8, and the components are interleaved
+// per block, so one component of a block is one AVX register;
+//   block 0: x0..x7 y0..y7 z0..z7, block 1: x8..x15 y8..y15 z8..z15, ...
+//
+// SoA keeps each component in a separate stream, which breaks the locality
+// when all components of an element are used. AoSoA keeps the components of
+// 8 elements within 96 (Vector3) or 128 (Quaternion) bytes, and can still be
+// loaded without shuffles.
+//
+// The kernels are written with the lane wrappers of simd.h, and the lanes
+// are selected by the CPU at run time (see simdDispatch.h). There are the
+// same kernels over SoA streams for comparison; see benchmarkLayouts() of
+// benchmark.h.
+//
+// The unused lanes of the last block are 0 and processed with the others;
+// the AoSoA kernels clear them again after each call.
+// The blocks are allocated with HugePageAllocator (see hugePages.h).
+//
+// usage:
+//   Gil::BlockArray<Vector3> points(vertices, count);  // from Vector3 array
+//   Gil::transformPoints(matrix, points, points);
+//   for (Vector3 p : points) ...                       // scalar access
+//   points[i] = Vector3(1, 2, 3);
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <iterator>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+#include "vectorExpr.h"
+#include "hugePages.h"
+
+namespace Gil
+{
+	const int BLOCK_WIDTH = 8;      // elements per block
+
+	///////////////////////////////////////////////////////////////////////////
+	// block of 8 elements, c[component][lane]
+	// Quaternion components are in (s, x, y, z) order.
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	struct alignas(32) Block
+	{
+		static const int SIZE = expr::Components<T>::SIZE;
+		float c[SIZE][BLOCK_WIDTH];
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// array of blocks with scalar access to the elements
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	class BlockArray
+	{
+	public:
+		// reference to an element, converts to/from T
+		class Ref
+		{
+		public:
+			Ref(BlockArray* a, int i) : a(a), i(i) {}
+			operator T() const                  { return a->get(i); }
+			Ref& operator=(const T& v)          { a->set(i, v); return *this; }
+			Ref& operator=(const Ref& r)        { a->set(i, (T)r); return *this; }
+		private:
+			BlockArray* a;
+			int i;
+		};
+
+		// iterators of the elements; *it is Ref (iterator) or T (const_iterator)
+		template <class A, class R>
+		class Iterator
+		{
+		public:
+			typedef std::input_iterator_tag iterator_category;
+			typedef T value_type;
+			typedef int difference_type;
+			typedef void pointer;
+			typedef R reference;
+
+			Iterator(A* a, int i) : a(a), i(i) {}
+			R operator*() const                 { return R(a->at(i)); }
+			Iterator& operator++()              { ++i; return *this; }
+			Iterator operator++(int)            { Iterator it = *this; ++i; return it; }
+			bool operator==(const Iterator& rhs) const { return i == rhs.i; }
+			bool operator!=(const Iterator& rhs) const { return i != rhs.i; }
+		private:
+			A* a;
+			int i;
+		};
+		typedef Iterator<BlockArray, Ref> iterator;
+		typedef Iterator<const BlockArray, T> const_iterator;
+
+		//constructors
+		BlockArray() : count(0) {}
+		explicit BlockArray(int count) : count(0)   { resize(count); }
+		BlockArray(const T* src, int count);
+
+		void        resize(int count);                  //new elements are 0
+		int         size() const                        { return count; }
+		int         blockCount() const                  { return (int)blocks.size(); }
+		Block<T>*   data()                              { return blocks.empty() ? 0 : &blocks[0]; }
+		const Block<T>* data() const                    { return blocks.empty() ? 0 : &blocks[0]; }
+
+		T           get(int i) const;
+		void        set(int i, const T& v);
+		void        toArray(T* dst) const;              //copy all elements to AoS array
+
+		Ref         at(int i)                           { return Ref(this, i); }
+		T           at(int i) const                     { return get(i); }
+		Ref         operator[](int i)                   { return Ref(this, i); }
+		T           operator[](int i) const             { return get(i); }
+
+		iterator    begin()                             { return iterator(this, 0); }
+		iterator    end()                               { return iterator(this, count); }
+		const_iterator begin() const                    { return const_iterator(this, 0); }
+		const_iterator end() const                      { return const_iterator(this, count); }
+
+	private:
+		std::vector<Block<T>, HugePageAllocator<Block<T> > > blocks;   // 64-byte aligned, huge pages if large
+		int count;
+	};
+
+
+	// SoA kernels over separate component streams; in[0] = x[], in[1] = y[], ...
+	// (s[], x[], y[], z[] for quaternions). out may be the same as in.
+	void transformPoints(const Matrix4& m, const float* const in[3], float* const out[3], int count);  // M * (p, 1)
+	void rotate(const float* const quats[4], const float* const vecs[3], float* const out[3], int count); // q * v * q^-1, unit quaternions
+	void slerp(const float* const from[4], const float* const to[4], float t, float* const out[4], int count);
+	void normalize3(float* const vecs[3], int count);    //0 length vectors are not changed
+	void normalize4(float* const quats[4], int count);   //0 length quaternions are not changed
+
+	// AoSoA kernels, same as the SoA kernels; out is resized to the input, and
+	// may be the same as in. rotate() and slerp() stop at the shorter input, so
+	// out gets min(quats.size(), vecs.size()) or min(from.size(), to.size())
+	void transformPoints(const Matrix4& m, const BlockArray<Vector3>& in, BlockArray<Vector3>& out);
+	void rotate(const BlockArray<Quaternion>& quats, const BlockArray<Vector3>& vecs, BlockArray<Vector3>& out);
+	void slerp(const BlockArray<Quaternion>& from, const BlockArray<Quaternion>& to, float t, BlockArray<Quaternion>& out);
+	void normalize(BlockArray<Vector3>& vecs);       //0 length vectors are not changed
+	void normalize(BlockArray<Quaternion>& quats);   //0 length quaternions are not changed
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// inline functions for BlockArray
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	BlockArray<T>::BlockArray(const T* src, int count) : count(0)
+	{
+		resize(count);
+		for (int i = 0; i < count; ++i)
+			set(i, src[i]);
+	}
+
+	template <class T>
+	void BlockArray<T>::resize(int n)
+	{
+		int oldLanes = blockCount() * BLOCK_WIDTH;
+		blocks.resize((n + BLOCK_WIDTH - 1) / BLOCK_WIDTH, Block<T>());
+
+		// clear the lanes of the old last block from the smaller size; the new
+		// blocks are 0
+		int lanes = blockCount() * BLOCK_WIDTH < oldLanes ? blockCount() * BLOCK_WIDTH : oldLanes;
+		for (int i = n < count ? n : count; i < lanes; ++i)
+			set(i, T());
+		count = n;
+	}
+
+	template <class T>
+	T BlockArray<T>::get(int i) const
+	{
+		const Block<T>& b = blocks[i / BLOCK_WIDTH];
+		int lane = i % BLOCK_WIDTH;
+		T v;
+		for (int c = 0; c < Block<T>::SIZE; ++c)
+			expr::Components<T>::at(v, c) = b.c[c][lane];
+		return v;
+	}
+
+	template <class T>
+	void BlockArray<T>::set(int i, const T& v)
+	{
+		Block<T>& b = blocks[i / BLOCK_WIDTH];
+		int lane = i % BLOCK_WIDTH;
+		for (int c = 0; c < Block<T>::SIZE; ++c)
+			b.c[c][lane] = expr::Components<T>::get(v, c);
+	}
+
+	template <class T>
+	void BlockArray<T>::toArray(T* dst) const
+	{
+		for (int i = 0; i < count; ++i)
+			dst[i] = get(i);
+	}
+} //end of namespace Gil
@@ -0,0 +1,428 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// fastMath.h
+// ==========
+// Scalar and SIMD math helpers shared by the vector, matrix and quaternion
+// classes.
+//
+// Normalization precision (NormalizeMode)
+// Every Normalize()/Length() in Vectors.h and Quaternion.h takes the mode as
+// an optional parameter. The default is NORMALIZE_EXACT, same as before.
+//
+// max relative error of 1/sqrt(x), measured over [1e-6, 1e6]
+// +---------------------+-------------------+------------------------------+
+// | mode                | SSE (rsqrtss/ps)  | no SSE (bit trick, Doom3)    |
+// +---------------------+-------------------+------------------------------+
+// | NORMALIZE_EXACT     | 9.0e-8 (~1 ulp)   | 9.0e-8 (~1 ulp)              |
+// | NORMALIZE_RSQRT_NR  | 2.7e-7 (~2 ulp)   | 1.5e-7 (2 Newton iterations) |
+// | NORMALIZE_RSQRT     | 3.3e-4 (~12 bits) | 1.8e-3 (1 Newton iteration)  |
+// +---------------------+-------------------+------------------------------+
+// The error of the normalized vector length is the same as above.
+// NORMALIZE_RSQRT_NR is good enough for re-normalizing quaternions and
+// directions every frame. NORMALIZE_RSQRT is only for visual purposes, and it
+// does not handle 0-length input (result is inf/NaN).
+//
+// Trigonometric functions
+// fastSinCos/fastSin/fastCos/fastAsin/fastAcos/fastAtan2 are polynomial
+// (minimax) approximations without C library calls. The same code is used
+// for scalar float, 4-lane __m128 and 8-lane __m256 (AVX2 build only).
+//
+// max absolute error (radian), measured against double precision libm
+// +------------+-------------------+-----------+
+// | function   | input range       | error     |
+// +------------+-------------------+-----------+
+// | sin, cos   | [-10000, 10000]   | 9.3e-8    |
+// | asin       | [-1, 1]           | 1.7e-7    |
+// | acos       | [-1, 1]           | 3.0e-7    |
+// | atan2      | all (y, x)        | 2.8e-7    |
+// +------------+-------------------+-----------+
+// asin/acos clamp the input to [-1, 1] instead of returning NaN, and
+// atan2(0, 0) returns 0.
+// The math classes call sinCos(), sine(), arcSine(), arcCosine() and
+// arcTangent2() below, which use the C library unless GIL_FAST_TRIG is
+// defined.
+//
+// Compile-time evaluation
+// The scalar functions are constexpr. In a constant expression they always
+// use the polynomial versions and exact square root (NormalizeMode is
+// ignored), because the C library and the intrinsics are not constexpr.
+// So a constexpr quaternion or matrix may differ from the same one computed
+// at run time by the trigonometric error above.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include "simd.h"
+
+namespace Gil {
+inline namespace GIL_ISA      // see simd.h
+{
+	// precision policy for normalization and length
+	enum NormalizeMode
+	{
+		NORMALIZE_EXACT = 0,    // 1 / sqrt(x)
+		NORMALIZE_RSQRT_NR,     // rsqrt estimate + Newton-Raphson iteration
+		NORMALIZE_RSQRT         // rsqrt estimate only
+	};
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// rough estimate of 1/sqrt(x)
+	// SSE: rsqrtss, 12-bit precision
+	// otherwise: magic number and 1 Newton iteration (InvSqrt() of Vectors.h)
+	///////////////////////////////////////////////////////////////////////////
+	inline float rsqrtEstimate(float x)
+	{
+#ifdef GIL_SSE
+		return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+		float xhalf = 0.5f * x;
+		int i;
+		std::memcpy(&i, &x, sizeof(i));
+		i = 0x5f3759df - (i >> 1);
+		std::memcpy(&x, &i, sizeof(x));
+		return x * (1.5f - xhalf * x * x);
+#endif
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// 1/sqrt(x) with the given precision
+	///////////////////////////////////////////////////////////////////////////
+	constexpr float invSqrt(float x, NormalizeMode mode = NORMALIZE_EXACT)
+	{
+		if (std::is_constant_evaluated())
+			return 1.0f / constSqrt(x);
+		if (mode == NORMALIZE_EXACT)
+			return 1.0f / sqrtf(x);
+
+		float r = rsqrtEstimate(x);
+		if (mode == NORMALIZE_RSQRT_NR)
+		{
+			// Newton-Raphson: r' = r * (1.5 - 0.5 * x * r * r)
+			float xhalf = 0.5f * x;
+			r = r * (1.5f - xhalf * r * r);
+#ifndef GIL_SSE
+			r = r * (1.5f - xhalf * r * r); // the bit trick needs one more
+#endif
+		}
+		return r;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// sqrt(x) with the given precision, sqrt(x) = x * 1/sqrt(x)
+	///////////////////////////////////////////////////////////////////////////
+	constexpr float squareRoot(float x, NormalizeMode mode = NORMALIZE_EXACT)
+	{
+		if (std::is_constant_evaluated())
+			return constSqrt(x);
+		if (mode == NORMALIZE_EXACT)
+			return sqrtf(x);
+		if (x <= 0)
+			return 0;   // avoid 0 * inf
+		return x * invSqrt(x, mode);
+	}
+
+#ifdef GIL_SSE
+	///////////////////////////////////////////////////////////////////////////
+	// 4-lane 1/sqrt(x) with the given precision
+	///////////////////////////////////////////////////////////////////////////
+	inline __m128 invSqrt4(__m128 x, NormalizeMode mode = NORMALIZE_EXACT)
+	{
+		if (mode == NORMALIZE_EXACT)
+			return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x));
+
+		__m128 r = _mm_rsqrt_ps(x);
+		if (mode == NORMALIZE_RSQRT_NR)
+		{
+			__m128 xhalf = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+			__m128 rr = _mm_mul_ps(r, r);
+			r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xhalf, rr)));
+		}
+		return r;
+	}
+#endif
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// IEEE 754 half precision (float16) stored in 16 bits
+	// 1 sign, 5 exponent, 10 mantissa bits; max 65504, about 3 decimal digits.
+	// Values beyond the range become inf, small values become subnormal or 0,
+	// and NaN stays NaN (as 0x7e00). The rounding is to nearest even, same as
+	// F16C instructions. The array versions are in halfFloat.h.
+	///////////////////////////////////////////////////////////////////////////
+	typedef unsigned short Half;
+
+	constexpr Half floatToHalf(float f)
+	{
+		const unsigned int F16_MAX = (127 + 16) << 23;             // >= this is inf or NaN
+		const unsigned int MIN_NORMAL = (127 - 14) << 23;          // < this is subnormal
+		const unsigned int DENORM_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+		unsigned int u = std::bit_cast<unsigned int>(f);
+		unsigned int sign = u & 0x80000000u;
+		u ^= sign;
+
+		unsigned int h = 0;
+		if (u >= F16_MAX)
+		{
+			h = u > 0x7f800000u ? 0x7e00 : 0x7c00;
+		}
+		else if (u < MIN_NORMAL)
+		{
+			// adding 0.5 of the subnormal unit rounds the mantissa by the FPU
+			float r = std::bit_cast<float>(u) + std::bit_cast<float>(DENORM_MAGIC);
+			h = std::bit_cast<unsigned int>(r) - DENORM_MAGIC;
+		}
+		else
+		{
+			unsigned int odd = (u >> 13) & 1;                       // round half to even
+			u += ((unsigned int)(15 - 127) << 23) + 0xfff + odd;    // rebias exponent, round
+			h = u >> 13;
+		}
+		return (Half)(h | (sign >> 16));
+	}
+
+	constexpr float halfToFloat(Half h)
+	{
+		const unsigned int SHIFTED_EXP = 0x7c00 << 13;             // exponent mask after shift
+		unsigned int u = (unsigned int)(h & 0x7fff) << 13;
+		unsigned int exp = u & SHIFTED_EXP;
+		u += (127 - 15) << 23;                                      // rebias exponent
+		if (exp == SHIFTED_EXP)
+		{
+			u += (128 - 16) << 23;                                  // inf/NaN
+		}
+		else if (exp == 0)
+		{
+			// 0 or subnormal: renormalize with the FPU
+			u += 1 << 23;
+			u = std::bit_cast<unsigned int>(std::bit_cast<float>(u) - std::bit_cast<float>(113u << 23));
+		}
+		return std::bit_cast<float>(u | (unsigned int)(h & 0x8000) << 16);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// trigonometric kernels
+	// They are written once with the lane wrappers of simd.h, and used for
+	// scalar (fast*(float)), SSE (fast*(__m128)) and AVX2 (fast*(__m256)).
+	// The polynomials are the minimax approximations of Cephes single
+	// precision library.
+	///////////////////////////////////////////////////////////////////////////
+	namespace trig
+	{
+		constexpr float PI = 3.14159265358979f;
+		constexpr float HALF_PI = 1.57079632679490f;
+		constexpr float QUARTER_PI = 0.785398163397448f;
+		constexpr float TWO_OVER_PI = 0.636619772367581f;
+
+		///////////////////////////////////////////////////////////////////////
+		// sine and cosine at once
+		// x is reduced to r = x - q*(pi/2), |r| <= pi/4, with 3 parts of pi/2
+		// (Cody-Waite), then the polynomials of r are swapped and negated by
+		// the quadrant q.
+		// q: 0 -> ( sin r,  cos r)   1 -> ( cos r, -sin r)
+		//    2 -> (-sin r, -cos r)   3 -> (-cos r,  sin r)
+		///////////////////////////////////////////////////////////////////////
+		template <class V>
+		constexpr void sinCos(typename V::F x, typename V::F& s, typename V::F& c)
+		{
+			typedef typename V::F F;
+			typename V::I q = V::round(V::mul(x, V::set1(TWO_OVER_PI)));
+			F qf = V::toFloat(q);
+			F r = V::fmadd(qf, V::set1(-1.5703125f), x);
+			r = V::fmadd(qf, V::set1(-4.837512969970703125e-4f), r);
+			r = V::fmadd(qf, V::set1(-7.54978995489188216e-8f), r);
+			F rr = V::mul(r, r);
+
+			// sin(r) = r + r^3 * P(r^2)
+			F ps = V::fmadd(V::set1(-1.9515295891e-4f), rr, V::set1(8.3321608736e-3f));
+			ps = V::fmadd(ps, rr, V::set1(-1.6666654611e-1f));
+			ps = V::fmadd(V::mul(ps, rr), r, r);
+
+			// cos(r) = 1 - r^2/2 + r^4 * Q(r^2)
+			F pc = V::fmadd(V::set1(2.443315711809948e-5f), rr, V::set1(-1.388731625493765e-3f));
+			pc = V::fmadd(pc, rr, V::set1(4.166664568298827e-2f));
+			pc = V::fmadd(V::mul(pc, rr), rr, V::fmadd(V::set1(-0.5f), rr, V::set1(1.0f)));
+
+			typename V::M swap = V::testBits(q, 1);
+			s = V::negateIf(V::testBits(q, 2), V::select(swap, pc, ps));
+			c = V::negateIf(V::testBits(V::addi(q, 1), 2), V::select(swap, ps, pc));
+		}
+
+		///////////////////////////////////////////////////////////////////////
+		// asin(a) for 0 <= a <= 0.5 with z = a * a
+		///////////////////////////////////////////////////////////////////////
+		template <class V>
+		constexpr typename V::F asinPoly(typename V::F a, typename V::F z)
+		{
+			typename V::F p = V::fmadd(V::set1(4.2163199048e-2f), z, V::set1(2.4181311049e-2f));
+			p = V::fmadd(p, z, V::set1(4.5470025998e-2f));
+			p = V::fmadd(p, z, V::set1(7.4953002686e-2f));
+			p = V::fmadd(p, z, V::set1(1.6666752422e-1f));
+			return V::fmadd(V::mul(p, z), a, a);
+		}
+
+		///////////////////////////////////////////////////////////////////////
+		// arc sine, the input is clamped to [-1, 1]
+		// |x| > 0.5 uses asin(x) = pi/2 - 2*asin(sqrt((1-x)/2))
+		///////////////////////////////////////////////////////////////////////
+		template <class V>
+		constexpr typename V::F asin(typename V::F x)
+		{
+			typedef typename V::F F;
+			F a = V::min(V::abs(x), V::set1(1.0f));
+			typename V::M big = V::gt(a, V::set1(0.5f));
+			F zBig = V::mul(V::set1(0.5f), V::sub(V::set1(1.0f), a));
+			F z = V::select(big, zBig, V::mul(a, a));
+			F p = asinPoly<V>(V::select(big, V::sqrt(zBig), a), z);
+			p = V::select(big, V::fmadd(V::set1(-2.0f), p, V::set1(HALF_PI)), p);
+			return V::copySign(p, x);
+		}
+
+		///////////////////////////////////////////////////////////////////////
+		// arc cosine, the input is clamped to [-1, 1]
+		// |x| > 0.5:  acos(|x|) = 2*asin(sqrt((1-|x|)/2)), acos(-x) = pi - acos(x)
+		// otherwise:  acos(x) = pi/2 - asin(x)
+		///////////////////////////////////////////////////////////////////////
+		template <class V>
+		constexpr typename V::F acos(typename V::F x)
+		{
+			typedef typename V::F F;
+			F a = V::min(V::abs(x), V::set1(1.0f));
+			typename V::M big = V::gt(a, V::set1(0.5f));
+			F zBig = V::mul(V::set1(0.5f), V::sub(V::set1(1.0f), a));
+			F z = V::select(big, zBig, V::mul(a, a));
+			F p = asinPoly<V>(V::select(big, V::sqrt(zBig), a), z);
+
+			typename V::M negative = V::lt(x, V::set1(0.0f));
+			F bigResult = V::add(p, p);
+			bigResult = V::select(negative, V::sub(V::set1(PI), bigResult), bigResult);
+			F smallResult = V::sub(V::set1(HALF_PI), V::negateIf(negative, p));
+			return V::select(big, bigResult, smallResult);
+		}
+
+		///////////////////////////////////////////////////////////////////////
+		// arc tangent of y/x in [-pi, pi]
+		// t = min(|x|,|y|) / max(|x|,|y|) is in [0, 1], and for t > tan(pi/8)
+		// atan(t) = pi/4 + atan((t-1)/(t+1)). Then the octant is restored.
+		// atan2(0, 0) returns 0.
+		///////////////////////////////////////////////////////////////////////
+		template <class V>
+		constexpr typename V::F atan2(typename V::F y, typename V::F x)
+		{
+			typedef typename V::F F;
+			F ax = V::abs(x);
+			F ay = V::abs(y);
+			F lo = V::min(ax, ay);
+			F hi = V::max(ax, ay);
+			typename V::M zero = V::lt(hi, V::set1(1e-30f));
+			F t = V::div(lo, V::select(zero, V::set1(1.0f), hi));
+
+			typename V::M mid = V::gt(t, V::set1(0.414213562373095f));
+			t = V::select(mid, V::div(V::sub(t, V::set1(1.0f)), V::add(t, V::set1(1.0f))), t);
+			F z = V::mul(t, t);
+			F p = V::fmadd(V::set1(8.05374449538e-2f), z, V::set1(-1.38776856032e-1f));
+			p = V::fmadd(p, z, V::set1(1.99777106478e-1f));
+			p = V::fmadd(p, z, V::set1(-3.33329491539e-1f));
+			p = V::fmadd(V::mul(p, z), t, t);
+			p = V::add(p, V::select(mid, V::set1(QUARTER_PI), V::set1(0.0f)));
+
+			p = V::select(V::gt(ay, ax), V::sub(V::set1(HALF_PI), p), p);
+			p = V::select(V::lt(x, V::set1(0.0f)), V::sub(V::set1(PI), p), p);
+			p = V::select(zero, V::set1(0.0f), p);
+			return V::copySign(p, y);
+		}
+	} //end of namespace trig
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// fast scalar trigonometric functions (radian)
+	///////////////////////////////////////////////////////////////////////////
+	constexpr void fastSinCos(float x, float& s, float& c)	{ trig::sinCos<Simd1>(x, s, c); }
+	constexpr float fastSin(float x)						{ float s = 0, c = 0; trig::sinCos<Simd1>(x, s, c); return s; }
+	constexpr float fastCos(float x)						{ float s = 0, c = 0; trig::sinCos<Simd1>(x, s, c); return c; }
+	constexpr float fastAsin(float x)						{ return trig::asin<Simd1>(x); }
+	constexpr float fastAcos(float x)						{ return trig::acos<Simd1>(x); }
+	constexpr float fastAtan2(float y, float x)				{ return trig::atan2<Simd1>(y, x); }
+
+#ifdef GIL_SSE
+	// 4-lane versions
+	inline void fastSinCos(__m128 x, __m128& s, __m128& c)	{ trig::sinCos<Simd4>(x, s, c); }
+	inline __m128 fastAsin(__m128 x)						{ return trig::asin<Simd4>(x); }
+	inline __m128 fastAcos(__m128 x)						{ return trig::acos<Simd4>(x); }
+	inline __m128 fastAtan2(__m128 y, __m128 x)				{ return trig::atan2<Simd4>(y, x); }
+#endif
+
+#ifdef GIL_AVX2
+	// 8-lane versions
+	inline void fastSinCos(__m256 x, __m256& s, __m256& c)	{ trig::sinCos<Simd8>(x, s, c); }
+	inline __m256 fastAsin(__m256 x)						{ return trig::asin<Simd8>(x); }
+	inline __m256 fastAcos(__m256 x)						{ return trig::acos<Simd8>(x); }
+	inline __m256 fastAtan2(__m256 y, __m256 x)				{ return trig::atan2<Simd8>(y, x); }
+#endif
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// trigonometric functions used by the vector, matrix, quaternion and
+	// animation code. They call the C library by default. Define
+	// GIL_FAST_TRIG in the project settings to use the fast versions above.
+	// In constant expressions, the fast versions are always used.
+	///////////////////////////////////////////////////////////////////////////
+	constexpr void sinCos(float x, float& s, float& c)
+	{
+#ifndef GIL_FAST_TRIG
+		if (!std::is_constant_evaluated())
+		{
+			s = sinf(x);
+			c = cosf(x);
+			return;
+		}
+#endif
+		fastSinCos(x, s, c);
+	}
+
+	constexpr float sine(float x)
+	{
+#ifndef GIL_FAST_TRIG
+		if (!std::is_constant_evaluated())
+			return sinf(x);
+#endif
+		return fastSin(x);
+	}
+
+	constexpr float arcSine(float x)
+	{
+#ifndef GIL_FAST_TRIG
+		if (!std::is_constant_evaluated())
+			return asinf(x);
+#endif
+		return fastAsin(x);
+	}
+
+	constexpr float arcCosine(float x)
+	{
+#ifndef GIL_FAST_TRIG
+		if (!std::is_constant_evaluated())
+			return acosf(x);
+#endif
+		return fastAcos(x);
+	}
+
+	constexpr float arcTangent2(float y, float x)
+	{
+#ifndef GIL_FAST_TRIG
+		if (!std::is_constant_evaluated())
+			return atan2f(y, x);
+#endif
+		return fastAtan2(y, x);
+	}
+} //end of inline namespace GIL_ISA
+} //end of namespace Gil
@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameArena.cpp
+// ==============
+// Linear arena over a list of chunks. Each chunk starts with a 64-byte
+// header linking to the previous chunk, and the chunks are allocated with
+// allocateAligned(), so the large arenas are backed by huge pages.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdarg>
+#include <cstdio>
+#include "frameArena.h"
+#include "hugePages.h"
+
+namespace
+{
+	const size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+	char* alignUp(char* p, size_t alignment)
+	{
+		return (char*)(((size_t)p + alignment - 1) & ~(alignment - 1));
+	}
+}
+
+struct alignas(Gil::CACHE_LINE_SIZE) Gil::LinearArena::Chunk
+{
+	Chunk* previous;
+	size_t size;                // bytes after the header
+};
+
+
+
+Gil::LinearArena::LinearArena(size_t capacity) : chunk(0), top(0), end(0), used(0), capacity(0), peak(0),
+	heapAllocations(0)
+{
+	if (capacity > 0)
+		addChunk(capacity);
+}
+
+Gil::LinearArena::~LinearArena()
+{
+	freeChunks();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bump the pointer, or continue in a new chunk at least as large as all the
+// chunks so far, so the number of chunks per frame stays small
+// alignment must be a power of 2
+///////////////////////////////////////////////////////////////////////////////
+void* Gil::LinearArena::allocate(size_t bytes, size_t alignment)
+{
+	char* p = alignUp(top, alignment);
+	if (!chunk || p > end || bytes > (size_t)(end - p))
+	{
+		size_t size = bytes + alignment;
+		if (size < capacity)
+			size = capacity;
+		if (!addChunk(size))
+			return 0;
+		p = alignUp(top, alignment);
+	}
+	top = p + bytes;
+	used += bytes;
+	return p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// free all allocations; if the frame needed more than one chunk, replace them
+// with one chunk of the total size for the next frames
+///////////////////////////////////////////////////////////////////////////////
+void Gil::LinearArena::reset()
+{
+	if (used > peak)
+		peak = used;
+	used = 0;
+	if (!chunk)
+		return;
+
+	if (chunk->previous)
+	{
+		size_t total = capacity;
+		freeChunks();
+		addChunk(total);
+	}
+	else
+	{
+		top = (char*)(chunk + 1);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// formatted string in the arena, valid until the reset
+///////////////////////////////////////////////////////////////////////////////
+const char* Gil::LinearArena::format(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	va_list copy;
+	va_copy(copy, args);
+
+	// try the rest of the current chunk first, then allocate the exact size
+	const char* text = "";
+	size_t space = chunk ? (size_t)(end - top) : 0;
+	int length = vsnprintf(top, space, fmt, args);
+	if (length >= 0 && (size_t)length < space)
+	{
+		text = (char*)allocate(length + 1, 1);
+	}
+	else if (length >= 0)
+	{
+		char* p = (char*)allocate(length + 1, 1);
+		if (p)
+		{
+			vsnprintf(p, length + 1, fmt, copy);
+			text = p;
+		}
+	}
+	va_end(copy);
+	va_end(args);
+	return text;
+}
+
+Gil::ArenaStats Gil::LinearArena::getStats() const
+{
+	ArenaStats stats;
+	stats.used = used;
+	stats.capacity = capacity;
+	stats.peak = used > peak ? used : peak;
+	stats.heapAllocations = heapAllocations;
+	return stats;
+}
+
+bool Gil::LinearArena::addChunk(size_t bytes)
+{
+	if (bytes < MIN_CHUNK_SIZE)
+		bytes = MIN_CHUNK_SIZE;
+	Chunk* c = (Chunk*)allocateAligned(sizeof(Chunk) + bytes);
+	if (!c)
+		return false;
+
+	c->previous = chunk;
+	c->size = bytes;
+	chunk = c;
+	top = (char*)(c + 1);
+	end = top + bytes;
+	capacity += bytes;
+	++heapAllocations;
+	return true;
+}
+
+void Gil::LinearArena::freeChunks()
+{
+	while (chunk)
+	{
+		Chunk* previous = chunk->previous;
+		freeAligned(chunk);
+		chunk = previous;
+	}
+	top = end = 0;
+	capacity = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// the arena of this frame becomes the previous one, and the arena of the
+// frame before is reset for the next frame
+///////////////////////////////////////////////////////////////////////////////
+void Gil::FrameArena::endFrame()
+{
+	index ^= 1;
+	arenas[index].reset();
+}
@@ -0,0 +1,149 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// frameArena.h
+// ============
+// Linear (bump) allocator for the transient data of a frame, e.g. poses,
+// blend weights, skinning matrices and text of the info overlay.
+// An allocation moves a pointer, and reset() frees all at once, so there is
+// no per-object free and no heap traffic in the frame loop.
+//
+// When a frame needs more than the capacity, the arena takes another chunk
+// from the heap, and the next reset() replaces the chunks with one chunk of
+// the peak size. So the heap is used only in the first frames, or when the
+// work grows, and the steady-state frames make no heap allocations.
+//
+// FrameArena keeps 2 arenas and swaps them at endFrame(), so the data of the
+// previous frame stays valid for one more frame (e.g. the last pose for
+// motion blur or velocity).
+//
+// NOTE: the destructors of the objects are not called; only trivially
+// destructible types can be allocated. The pointers are invalid after the
+// reset of their arena.
+//
+// usage:
+//   Gil::FrameArena frameArena(1 << 20);               // global
+//   ...
+//   std::span<Matrix4> palette = frameArena.current().matrices(boneCount);
+//   const char* text = frameArena.current().format("fps: %.1f", fps);
+//   ...
+//   frameArena.endFrame();                             // at the end of displayCB()
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+	// counters of an arena
+	struct ArenaStats
+	{
+		size_t used;                // bytes allocated since the last reset
+		size_t capacity;            // bytes of the chunks
+		size_t peak;                // max of used at reset
+		int heapAllocations;        // chunks taken from the heap, total
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// bump allocator over chunks of memory
+	///////////////////////////////////////////////////////////////////////////
+	class LinearArena
+	{
+	public:
+		explicit LinearArena(size_t capacity = 0);
+		~LinearArena();
+
+		void*       allocate(size_t bytes, size_t alignment = 16);  // 0 if out of memory
+		void        reset();                                        // free all, merge the chunks
+		const char* format(const char* fmt, ...);                   // printf to the arena, "" if failed
+		ArenaStats  getStats() const;
+
+		// n value-initialized elements, empty span if failed
+		template <class T>
+		std::span<T> allocate(int n);
+
+		std::span<Vector3>      vectors(int n)          { return allocate<Vector3>(n); }
+		std::span<Quaternion>   quaternions(int n)      { return allocate<Quaternion>(n); }
+		std::span<Matrix4>      matrices(int n)         { return allocate<Matrix4>(n); }
+
+		// copy of n elements from src
+		template <class T>
+		std::span<T> copy(const T* src, int n);
+
+	private:
+		struct Chunk;
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		bool addChunk(size_t bytes);
+		void freeChunks();
+
+		Chunk* chunk;               // current chunk, linked to the previous ones
+		char* top;                  // next free byte of the current chunk
+		char* end;                  // end of the current chunk
+		size_t used;
+		size_t capacity;
+		size_t peak;
+		int heapAllocations;
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// double-buffered arenas of the frames
+	///////////////////////////////////////////////////////////////////////////
+	class FrameArena
+	{
+	public:
+		explicit FrameArena(size_t capacity = 0) : arenas{ LinearArena(capacity), LinearArena(capacity) }, index(0) {}
+
+		LinearArena&        current()                   { return arenas[index]; }       // data of this frame
+		const LinearArena&  previous() const            { return arenas[index ^ 1]; }   // data of the last frame
+		void                endFrame();                 // swap and reset the arena of 2 frames ago
+
+	private:
+		LinearArena arenas[2];
+		int index;
+	};
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// inline functions for LinearArena
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	std::span<T> LinearArena::allocate(int n)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "arena does not call destructors");
+		if (n <= 0)
+			return std::span<T>();
+		T* p = (T*)allocate(sizeof(T) * n, alignof(T) > 16 ? alignof(T) : 16);
+		if (!p)
+			return std::span<T>();
+		for (int i = 0; i < n; ++i)
+			new (p + i) T();
+		return std::span<T>(p, n);
+	}
+
+	template <class T>
+	std::span<T> LinearArena::copy(const T* src, int n)
+	{
+		static_assert(std::is_trivially_destructible<T>::value, "arena does not call destructors");
+		if (n <= 0)
+			return std::span<T>();
+		T* p = (T*)allocate(sizeof(T) * n, alignof(T) > 16 ? alignof(T) : 16);
+		if (!p)
+			return std::span<T>();
+		for (int i = 0; i < n; ++i)
+			new (p + i) T(src[i]);
+		return std::span<T>(p, n);
+	}
+} //end of namespace Gil
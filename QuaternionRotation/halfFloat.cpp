@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// halfFloat.cpp
+// =============
+// Conversion of vector and quaternion arrays to float16 and back.
+// The members of the vectors and quaternions are contiguous floats, so the
+// arrays are converted as float arrays by the kernel of the CPU.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "halfFloat.h"
+#include "simdDispatch.h"
+
+void Gil::toHalf(const float* src, Half* dst, int count)
+{
+	getKernels().toHalf(src, dst, count);
+}
+
+void Gil::fromHalf(const Half* src, float* dst, int count)
+{
+	getKernels().fromHalf(src, dst, count);
+}
+
+void Gil::toHalf(const Vector2* src, Half* dst, int count)
+{
+	if (count > 0)
+		toHalf(&src->x, dst, count * 2);
+}
+
+void Gil::toHalf(const Vector3* src, Half* dst, int count)
+{
+	if (count > 0)
+		toHalf(&src->x, dst, count * 3);
+}
+
+void Gil::toHalf(const Vector4* src, Half* dst, int count)
+{
+	if (count > 0)
+		toHalf(&src->x, dst, count * 4);
+}
+
+void Gil::toHalf(const Quaternion* src, Half* dst, int count)
+{
+	if (count > 0)
+		toHalf(&src->s, dst, count * 4);
+}
+
+void Gil::fromHalf(const Half* src, Vector2* dst, int count)
+{
+	if (count > 0)
+		fromHalf(src, &dst->x, count * 2);
+}
+
+void Gil::fromHalf(const Half* src, Vector3* dst, int count)
+{
+	if (count > 0)
+		fromHalf(src, &dst->x, count * 3);
+}
+
+void Gil::fromHalf(const Half* src, Vector4* dst, int count)
+{
+	if (count > 0)
+		fromHalf(src, &dst->x, count * 4);
+}
+
+void Gil::fromHalf(const Half* src, Quaternion* dst, int count)
+{
+	if (count > 0)
+		fromHalf(src, &dst->s, count * 4);
+}
@@ -0,0 +1,143 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// halfFloat.h
+// ===========
+// Conversion of vector and quaternion arrays to packed float16 (Half) and
+// back, and HalfArray container that keeps the elements in float16 and
+// decodes them on access.
+//
+// Half of the bytes are moved for the streams limited by memory bandwidth,
+// e.g. positions, normals and rotations uploaded every frame. The batch
+// conversions use F16C instructions with AVX2 CPUs and SSE2 integer code
+// otherwise (see simdDispatch.h); the scalar floatToHalf()/halfToFloat()
+// are in fastMath.h.
+//
+// NOTE: float16 has 11 significant bits and the max is 65504; keep the
+// positions in a local range. Decoded quaternions are not exactly unit
+// length, normalize them if it matters.
+//
+// usage:
+//   Gil::HalfArray<Vector3> normals(src, count);   // encode
+//   Vector3 n = normals[i];                          // decode one element
+//   normals.decode(0, count, dst);                   // decode a range at once
+//   upload(normals.data(), normals.byteSize());      // 6 bytes per Vector3
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "Vectors.h"
+#include "Quaternion.h"
+#include "vectorExpr.h"
+
+namespace Gil
+{
+	// float arrays, round to nearest even
+	void toHalf(const float* src, Half* dst, int count);
+	void fromHalf(const Half* src, float* dst, int count);
+
+	// vector and quaternion arrays, the components are packed in the order
+	// of the members (x y z, x y z w, s x y z); dst has count * components halves
+	void toHalf(const Vector2* src, Half* dst, int count);
+	void toHalf(const Vector3* src, Half* dst, int count);
+	void toHalf(const Vector4* src, Half* dst, int count);
+	void toHalf(const Quaternion* src, Half* dst, int count);
+	void fromHalf(const Half* src, Vector2* dst, int count);
+	void fromHalf(const Half* src, Vector3* dst, int count);
+	void fromHalf(const Half* src, Vector4* dst, int count);
+	void fromHalf(const Half* src, Quaternion* dst, int count);
+
+	///////////////////////////////////////////////////////////////////////////
+	// array of T stored as float16, decoded on access
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	class HalfArray
+	{
+	public:
+		static const int SIZE = expr::Components<T>::SIZE;  // halves per element
+
+		// reference to an element, converts to/from T
+		class Ref
+		{
+		public:
+			Ref(HalfArray* a, int i) : a(a), i(i) {}
+			operator T() const                  { return a->get(i); }
+			Ref& operator=(const T& v)          { a->set(i, v); return *this; }
+			Ref& operator=(const Ref& r)        { a->set(i, (T)r); return *this; }
+		private:
+			HalfArray* a;
+			int i;
+		};
+
+		//constructors
+		HalfArray() : count(0) {}
+		explicit HalfArray(int count) : halves(count * SIZE), count(count) {}
+		HalfArray(const T* src, int count)              { assign(src, count); }
+
+		void        resize(int n)                       { halves.resize(n * SIZE); count = n; }  //new elements are 0
+		void        assign(const T* src, int n);        //encode n elements
+		int         size() const                        { return count; }
+		int         byteSize() const                    { return count * SIZE * (int)sizeof(Half); }
+		Half*       data()                              { return halves.empty() ? 0 : &halves[0]; }
+		const Half* data() const                        { return halves.empty() ? 0 : &halves[0]; }
+
+		T           get(int i) const;
+		void        set(int i, const T& v);
+		void        decode(int first, int n, T* dst) const;         //decode n elements from first
+		void        encode(int first, int n, const T* src);         //encode n elements to first
+
+		Ref         operator[](int i)                   { return Ref(this, i); }
+		T           operator[](int i) const             { return get(i); }
+
+	private:
+		std::vector<Half> halves;
+		int count;
+	};
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// inline functions for HalfArray
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	void HalfArray<T>::assign(const T* src, int n)
+	{
+		resize(n);
+		encode(0, n, src);
+	}
+
+	template <class T>
+	T HalfArray<T>::get(int i) const
+	{
+		const Half* h = &halves[i * SIZE];
+		T v;
+		for (int c = 0; c < SIZE; ++c)
+			expr::Components<T>::at(v, c) = halfToFloat(h[c]);
+		return v;
+	}
+
+	template <class T>
+	void HalfArray<T>::set(int i, const T& v)
+	{
+		Half* h = &halves[i * SIZE];
+		for (int c = 0; c < SIZE; ++c)
+			h[c] = floatToHalf(expr::Components<T>::get(v, c));
+	}
+
+	template <class T>
+	void HalfArray<T>::decode(int first, int n, T* dst) const
+	{
+		if (n > 0)
+			fromHalf(&halves[first * SIZE], dst, n);
+	}
+
+	template <class T>
+	void HalfArray<T>::encode(int first, int n, const T* src)
+	{
+		if (n > 0)
+			toHalf(src, &halves[first * SIZE], n);
+	}
+} //end of namespace Gil
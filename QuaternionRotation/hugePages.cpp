@@ -0,0 +1,297 @@
+///////////////////////////////////////////////////////////////////////////////
+// hugePages.cpp
+// =============
+// Allocation of aligned blocks from the heap or from huge page mappings.
+// Each block has a 64-byte header before the returned address, with the
+// mapping and the kind, so freeAligned() needs only the pointer.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdio>
+#include "hugePages.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+	enum BlockKind
+	{
+		BLOCK_HEAP,             // aligned operator new
+		BLOCK_MAPPED,           // normal pages from the OS
+		BLOCK_ADVISED,          // transparent huge pages
+		BLOCK_EXPLICIT          // hugetlb or large pages
+	};
+
+	struct alignas(Gil::CACHE_LINE_SIZE) BlockHeader
+	{
+		void* base;             // start of the heap block or mapping
+		size_t mapped;          // bytes of the mapping
+		size_t bytes;           // bytes requested
+		BlockKind kind;
+	};
+	static_assert(sizeof(BlockHeader) == Gil::CACHE_LINE_SIZE, "header must keep the data aligned");
+
+	std::atomic<int> currentPolicy(Gil::HUGE_PAGES_TRANSPARENT);
+	// same members as Gil::HugePageStats
+	struct Counters
+	{
+		std::atomic<size_t> allocations, bytes, peakBytes, explicitBytes, advisedBytes, largeRequests, fallbacks;
+	} counters;
+
+	size_t roundUp(size_t n, size_t unit)
+	{
+		return (n + unit - 1) / unit * unit;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// OS mappings; each returns the base or 0, and sets mapped
+	///////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+	// "Lock pages in memory" must be enabled in the token once
+	bool enableLargePages()
+	{
+		HANDLE token;
+		if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+			return false;
+		TOKEN_PRIVILEGES privileges;
+		privileges.PrivilegeCount = 1;
+		privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+		bool enabled = LookupPrivilegeValueA(0, "SeLockMemoryPrivilege", &privileges.Privileges[0].Luid)
+			&& AdjustTokenPrivileges(token, FALSE, &privileges, 0, 0, 0)
+			&& GetLastError() == ERROR_SUCCESS;     // ERROR_NOT_ALL_ASSIGNED without the privilege
+		CloseHandle(token);
+		return enabled;
+	}
+
+	void* mapExplicit(size_t size, size_t& mapped)
+	{
+		static const bool enabled = enableLargePages();
+		size_t page = GetLargePageMinimum();
+		if (!enabled || page == 0)
+			return 0;
+		mapped = roundUp(size, page);
+		return VirtualAlloc(0, mapped, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	}
+
+	void* mapAdvised(size_t, size_t&)
+	{
+		return 0;               // no transparent huge pages on Windows
+	}
+
+	void* mapNormal(size_t size, size_t& mapped)
+	{
+		mapped = size;
+		return VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+
+	void unmap(void* base, size_t)
+	{
+		VirtualFree(base, 0, MEM_RELEASE);
+	}
+#else
+	void* mapExplicit(size_t size, size_t& mapped)
+	{
+#ifdef MAP_HUGETLB
+		mapped = roundUp(size, Gil::HUGE_PAGE_SIZE);
+		void* p = mmap(0, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		return p == MAP_FAILED ? 0 : p;
+#else
+		return 0;
+#endif
+	}
+
+	// map one more huge page and trim both ends to align to the huge page
+	void* mapAdvised(size_t size, size_t& mapped)
+	{
+#ifdef MADV_HUGEPAGE
+		mapped = roundUp(size, Gil::HUGE_PAGE_SIZE);
+		size_t reserved = mapped + Gil::HUGE_PAGE_SIZE;
+		void* p = mmap(0, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			return 0;
+		char* start = (char*)p;
+		char* base = (char*)roundUp((size_t)start, Gil::HUGE_PAGE_SIZE);
+		if (base > start)
+			munmap(start, base - start);
+		if (start + reserved > base + mapped)
+			munmap(base + mapped, start + reserved - (base + mapped));
+		if (madvise(base, mapped, MADV_HUGEPAGE) != 0)
+		{
+			munmap(base, mapped);   // THP is not in the kernel
+			return 0;
+		}
+		return base;
+#else
+		return 0;
+#endif
+	}
+
+	void* mapNormal(size_t size, size_t& mapped)
+	{
+		mapped = size;
+		void* p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return p == MAP_FAILED ? 0 : p;
+	}
+
+	void unmap(void* base, size_t mapped)
+	{
+		munmap(base, mapped);
+	}
+#endif
+
+	void addBytes(BlockKind kind, size_t n)
+	{
+		++counters.allocations;
+		size_t total = counters.bytes += n;
+		size_t peak = counters.peakBytes.load();
+		while (total > peak && !counters.peakBytes.compare_exchange_weak(peak, total))
+			;
+		if (kind == BLOCK_EXPLICIT)
+			counters.explicitBytes += n;
+		else if (kind == BLOCK_ADVISED)
+			counters.advisedBytes += n;
+	}
+
+	void subtractBytes(BlockKind kind, size_t n)
+	{
+		--counters.allocations;
+		counters.bytes -= n;
+		if (kind == BLOCK_EXPLICIT)
+			counters.explicitBytes -= n;
+		else if (kind == BLOCK_ADVISED)
+			counters.advisedBytes -= n;
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// try the mappings allowed by the policy from the largest pages, then the heap
+///////////////////////////////////////////////////////////////////////////////
+void* Gil::allocateAligned(size_t bytes)
+{
+	if (bytes > (size_t)-1 / 2)
+		return 0;
+
+	size_t size = bytes + sizeof(BlockHeader);
+	BlockKind kind = BLOCK_HEAP;
+	void* base = 0;
+	size_t mapped = size;
+	int mode = currentPolicy.load();
+	if (mode != HUGE_PAGES_OFF && bytes >= HUGE_PAGE_MIN_BYTES)
+	{
+		++counters.largeRequests;
+		if (mode == HUGE_PAGES_EXPLICIT && (base = mapExplicit(size, mapped)) != 0)
+			kind = BLOCK_EXPLICIT;
+		else if ((base = mapAdvised(size, mapped)) != 0)
+			kind = BLOCK_ADVISED;
+		else if ((base = mapNormal(size, mapped)) != 0)
+			kind = BLOCK_MAPPED;
+		if (kind != BLOCK_EXPLICIT && kind != BLOCK_ADVISED)
+			++counters.fallbacks;
+	}
+	if (!base)
+	{
+		base = ::operator new(size, std::align_val_t(CACHE_LINE_SIZE), std::nothrow);
+		if (!base)
+			return 0;
+	}
+
+	BlockHeader* header = (BlockHeader*)base;
+	header->base = base;
+	header->mapped = mapped;
+	header->bytes = bytes;
+	header->kind = kind;
+	addBytes(kind, bytes);
+	return header + 1;
+}
+
+void Gil::freeAligned(void* p)
+{
+	if (!p)
+		return;
+
+	BlockHeader* header = (BlockHeader*)p - 1;
+	subtractBytes(header->kind, header->bytes);
+	if (header->kind == BLOCK_HEAP)
+		::operator delete(header->base, std::align_val_t(CACHE_LINE_SIZE));
+	else
+		unmap(header->base, header->mapped);
+}
+
+void Gil::setHugePagePolicy(HugePagePolicy policy)
+{
+	currentPolicy = policy;
+}
+
+Gil::HugePagePolicy Gil::getHugePagePolicy()
+{
+	return (HugePagePolicy)currentPolicy.load();
+}
+
+Gil::HugePageStats Gil::getHugePageStats()
+{
+	HugePageStats stats;
+	stats.allocations = counters.allocations;
+	stats.bytes = counters.bytes;
+	stats.peakBytes = counters.peakBytes;
+	stats.explicitBytes = counters.explicitBytes;
+	stats.advisedBytes = counters.advisedBytes;
+	stats.largeRequests = counters.largeRequests;
+	stats.fallbacks = counters.fallbacks;
+	return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bytes of the block backed by huge pages at the moment
+// Explicit blocks are always huge pages. Transparent blocks are promoted by
+// the kernel on the first touch or later by khugepaged, so the AnonHugePages
+// of the mapping is read from /proc/self/smaps (the kernel may have merged
+// the mapping with a neighbour advised the same way).
+///////////////////////////////////////////////////////////////////////////////
+size_t Gil::getResidentHugePageBytes(const void* p)
+{
+	if (!p)
+		return 0;
+
+	const BlockHeader* header = (const BlockHeader*)p - 1;
+	if (header->kind == BLOCK_EXPLICIT)
+		return header->bytes;
+	if (header->kind != BLOCK_ADVISED)
+		return 0;
+
+	size_t resident = 0;
+#ifndef _WIN32
+	FILE* file = fopen("/proc/self/smaps", "r");
+	if (!file)
+		return 0;
+	char line[256];
+	bool found = false;
+	size_t address = (size_t)header->base;
+	while (fgets(line, sizeof(line), file))
+	{
+		unsigned long long start, end, kb;
+		if (sscanf(line, "%llx-%llx", &start, &end) == 2)
+			found = address >= start && address < end;
+		else if (found && sscanf(line, "AnonHugePages: %llu kB", &kb) == 1)
+		{
+			resident = (size_t)kb * 1024;
+			break;
+		}
+	}
+	fclose(file);
+	if (resident > header->bytes)
+		resident = header->bytes;
+#endif
+	return resident;
+}
@@ -0,0 +1,99 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// hugePages.h
+// ===========
+// 64-byte aligned allocation of large math buffers backed by huge pages.
+// Random access over arrays of hundreds of MB misses the TLB on most loads
+// with 4 KiB pages; a 2 MiB page covers 512 times more memory per entry.
+//
+// Blocks of HUGE_PAGE_MIN_BYTES or more are mapped from the OS:
+//   Linux:   mmap(MAP_HUGETLB) from the reserved pool with the explicit policy,
+//            otherwise a 2 MiB aligned mapping advised with MADV_HUGEPAGE
+//            (transparent huge pages, "madvise" or "always" mode)
+//   Windows: VirtualAlloc(MEM_LARGE_PAGES) with the explicit policy, which
+//            needs "Lock pages in memory" privilege, otherwise normal pages
+// Smaller blocks, and the large ones the OS refuses, come from the heap or
+// normal pages, so the allocation fails only if there is no memory at all.
+//
+// HugePageStats counts the live bytes of each kind, so the coverage can be
+// compared with the timings; getResidentHugePageBytes() asks the kernel how
+// much of a transparent block is really backed by huge pages.
+//
+// usage:
+//   std::vector<float, Gil::HugePageAllocator<float> > buffer(count);
+//   Gil::HugePageStats stats = Gil::getHugePageStats();
+//   std::cout << stats.hugeBytes() * 100.0 / stats.bytes << "% huge pages\n";
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <new>
+
+namespace Gil
+{
+	const size_t CACHE_LINE_SIZE = 64;              // alignment of all blocks
+	const size_t HUGE_PAGE_SIZE = 2 << 20;          // 2 MiB pages of x64
+	const size_t HUGE_PAGE_MIN_BYTES = 1 << 20;     // smaller blocks are from the heap
+
+	enum HugePagePolicy
+	{
+		HUGE_PAGES_OFF = 0,         // heap only
+		HUGE_PAGES_TRANSPARENT,     // madvise(MADV_HUGEPAGE) on Linux (default)
+		HUGE_PAGES_EXPLICIT         // hugetlb or large pages first, then transparent
+	};
+
+	// counters of the live blocks, and of all the large requests
+	struct HugePageStats
+	{
+		size_t allocations;         // live blocks
+		size_t bytes;               // live bytes requested
+		size_t peakBytes;           // max of bytes
+		size_t explicitBytes;       // live bytes in hugetlb or large pages
+		size_t advisedBytes;        // live bytes advised as transparent huge pages
+		size_t largeRequests;       // blocks of HUGE_PAGE_MIN_BYTES or more
+		size_t fallbacks;           // large blocks that got normal pages
+
+		size_t hugeBytes() const    { return explicitBytes + advisedBytes; }
+	};
+
+	void*           allocateAligned(size_t bytes);      // 64-byte aligned, 0 if failed
+	void            freeAligned(void* p);               // p from allocateAligned(), or 0
+
+	void            setHugePagePolicy(HugePagePolicy policy);   // for the next allocations
+	HugePagePolicy  getHugePagePolicy();
+	HugePageStats   getHugePageStats();
+	size_t          getResidentHugePageBytes(const void* p);    // huge page bytes of the block now
+
+	///////////////////////////////////////////////////////////////////////////
+	// allocator of the standard containers with allocateAligned()
+	// throws std::bad_alloc like std::allocator
+	///////////////////////////////////////////////////////////////////////////
+	template <class T>
+	class HugePageAllocator
+	{
+	public:
+		typedef T value_type;
+
+		HugePageAllocator() {}
+		template <class U>
+		HugePageAllocator(const HugePageAllocator<U>&) {}
+
+		T* allocate(size_t n)
+		{
+			void* p = allocateAligned(n * sizeof(T));
+			if (!p)
+				throw std::bad_alloc();
+			return (T*)p;
+		}
+		void deallocate(T* p, size_t)                   { freeAligned(p); }
+
+		template <class U>
+		bool operator==(const HugePageAllocator<U>&) const  { return true; }
+		template <class U>
+		bool operator!=(const HugePageAllocator<U>&) const  { return false; }
+	};
+} //end of namespace Gil
@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////
+// mathBatch.cpp
+// =============
+// Batch operations over arrays of vectors and quaternions.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "mathBatch.h"
+#include "simdDispatch.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize array of 2D vectors
+// 4 vectors (8 floats) are loaded with 2 registers;
+// a = (x0 y0 x1 y1), b = (x2 y2 x3 y3)
+///////////////////////////////////////////////////////////////////////////////
+void Gil::normalize(Vector2* vecs, int count, NormalizeMode mode)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		float* p = &vecs[i].x;
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p + 4);
+
+		// squared lengths (l0 l1 l2 l3)
+		__m128 aa = _mm_mul_ps(a, a);
+		__m128 bb = _mm_mul_ps(b, b);
+		__m128 d = _mm_add_ps(_mm_shuffle_ps(aa, bb, _MM_SHUFFLE(2, 0, 2, 0)),
+			_mm_shuffle_ps(aa, bb, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m128 inv = invSqrt4(d, mode);
+
+		// spread the scales back to (i0 i0 i1 i1), (i2 i2 i3 i3)
+		_mm_storeu_ps(p, _mm_mul_ps(a, _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(1, 1, 0, 0))));
+		_mm_storeu_ps(p + 4, _mm_mul_ps(b, _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(3, 3, 2, 2))));
+	}
+#endif
+	for (; i < count; ++i)
+		vecs[i].Normalize(mode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize array of 3D vectors
+// 4 vectors (12 floats) are loaded with 3 registers;
+// a = (x0 y0 z0 x1), b = (y1 z1 x2 y2), c = (z2 x3 y3 z3)
+// The squares are transposed to (x0 x1 x2 x3) + (y0 y1 y2 y3) + (z0 z1 z2 z3)
+// to get 4 squared lengths at once.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::normalize(Vector3* vecs, int count, NormalizeMode mode)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		float* p = &vecs[i].x;
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p + 4);
+		__m128 c = _mm_loadu_ps(p + 8);
+
+		__m128 aa = _mm_mul_ps(a, a);
+		__m128 bb = _mm_mul_ps(b, b);
+		__m128 cc = _mm_mul_ps(c, c);
+
+		// xx = (aa0 aa3 bb2 cc1)
+		__m128 t = _mm_shuffle_ps(bb, cc, _MM_SHUFFLE(1, 1, 2, 2));
+		__m128 xx = _mm_shuffle_ps(aa, t, _MM_SHUFFLE(2, 0, 3, 0));
+		// yy = (aa1 bb0 bb3 cc2)
+		__m128 t1 = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(0, 0, 1, 1));
+		__m128 t2 = _mm_shuffle_ps(bb, cc, _MM_SHUFFLE(2, 2, 3, 3));
+		__m128 yy = _mm_shuffle_ps(t1, t2, _MM_SHUFFLE(2, 0, 2, 0));
+		// zz = (aa2 bb1 cc0 cc3)
+		t1 = _mm_shuffle_ps(aa, bb, _MM_SHUFFLE(1, 1, 2, 2));
+		t2 = _mm_shuffle_ps(cc, cc, _MM_SHUFFLE(3, 3, 0, 0));
+		__m128 zz = _mm_shuffle_ps(t1, t2, _MM_SHUFFLE(2, 0, 2, 0));
+
+		__m128 inv = invSqrt4(_mm_add_ps(_mm_add_ps(xx, yy), zz), mode);
+
+		// spread the scales back to (i0 i0 i0 i1), (i1 i1 i2 i2), (i2 i3 i3 i3)
+		_mm_storeu_ps(p, _mm_mul_ps(a, _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(1, 0, 0, 0))));
+		_mm_storeu_ps(p + 4, _mm_mul_ps(b, _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(2, 2, 1, 1))));
+		_mm_storeu_ps(p + 8, _mm_mul_ps(c, _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(3, 3, 3, 2))));
+	}
+#endif
+	for (; i < count; ++i)
+		vecs[i].Normalize(mode);
+}
+
+#ifdef GIL_SSE
+///////////////////////////////////////////////////////////////////////////////
+// load 4 consecutive 4-float elements at p and return their squared lengths
+// The elements are transposed, so the squared lengths are 3 adds of columns.
+///////////////////////////////////////////////////////////////////////////////
+static inline __m128 loadSquaredLength4(const float* p, __m128 r[4])
+{
+	r[0] = _mm_loadu_ps(p);
+	r[1] = _mm_loadu_ps(p + 4);
+	r[2] = _mm_loadu_ps(p + 8);
+	r[3] = _mm_loadu_ps(p + 12);
+
+	__m128 c0 = r[0], c1 = r[1], c2 = r[2], c3 = r[3];
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)),
+		_mm_add_ps(_mm_mul_ps(c2, c2), _mm_mul_ps(c3, c3)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// multiply each of 4 elements by its own scale and store
+///////////////////////////////////////////////////////////////////////////////
+static inline void storeScaled4(float* p, const __m128 r[4], __m128 inv)
+{
+	_mm_storeu_ps(p, _mm_mul_ps(r[0], _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(0, 0, 0, 0))));
+	_mm_storeu_ps(p + 4, _mm_mul_ps(r[1], _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(1, 1, 1, 1))));
+	_mm_storeu_ps(p + 8, _mm_mul_ps(r[2], _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(2, 2, 2, 2))));
+	_mm_storeu_ps(p + 12, _mm_mul_ps(r[3], _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize array of 4D vectors
+///////////////////////////////////////////////////////////////////////////////
+void Gil::normalize(Vector4* vecs, int count, NormalizeMode mode)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		float* p = &vecs[i].x;
+		__m128 r[4];
+		__m128 inv = invSqrt4(loadSquaredLength4(p, r), mode);
+		storeScaled4(p, r, inv);
+	}
+#endif
+	for (; i < count; ++i)
+		vecs[i].Normalize(mode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize array of quaternions
+// Same as Quaternion::normalize(), the quaternions with (near) 0 length are
+// not changed.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::normalize(Quaternion* quats, int count, NormalizeMode mode)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	const __m128 EPSILON = _mm_set1_ps(0.00001f);
+	const __m128 ONE = _mm_set1_ps(1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		float* p = &quats[i].s;
+		__m128 r[4];
+		__m128 d = loadSquaredLength4(p, r);
+		__m128 inv = invSqrt4(d, mode);
+
+		// keep 1 for the quaternions of d < EPSILON
+		__m128 mask = _mm_cmplt_ps(d, EPSILON);
+		inv = _mm_or_ps(_mm_and_ps(mask, ONE), _mm_andnot_ps(mask, inv));
+		storeScaled4(p, r, inv);
+	}
+#endif
+	for (; i < count; ++i)
+		quats[i].normalize(mode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// normalize array of aligned 3D vectors
+// w is 0, so the squared lengths of 4 vectors are the same as Vector4.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::normalize(Vector3A* vecs, int count, NormalizeMode mode)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		float* p = &vecs[i].x;
+		__m128 r[4];
+		__m128 inv = invSqrt4(loadSquaredLength4(p, r), mode);
+		storeScaled4(p, r, inv);
+	}
+#endif
+	for (; i < count; ++i)
+		vecs[i].Normalize(mode);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// packed Vector3 array to aligned Vector3A array
+// 4 vectors (12 floats) are loaded with 3 registers and spread to 4;
+// a = (x0 y0 z0 x1), b = (y1 z1 x2 y2), c = (z2 x3 y3 z3)
+///////////////////////////////////////////////////////////////////////////////
+void Gil::toAligned(const Vector3* src, Vector3A* dst, int count)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	const __m128 MASK_XYZ = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	for (; i + 4 <= count; i += 4)
+	{
+		const float* p = &src[i].x;
+		__m128 a = _mm_loadu_ps(p);
+		__m128 b = _mm_loadu_ps(p + 4);
+		__m128 c = _mm_loadu_ps(p + 8);
+
+		__m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 3, 3));     // x1 x1 y1 z1
+		__m128 t2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2));     // x2 y2 z2 z2
+		_mm_store_ps(&dst[i].x, _mm_and_ps(a, MASK_XYZ));
+		_mm_store_ps(&dst[i + 1].x, _mm_and_ps(_mm_shuffle_ps(t1, t1, _MM_SHUFFLE(3, 3, 2, 1)), MASK_XYZ));
+		_mm_store_ps(&dst[i + 2].x, _mm_and_ps(t2, MASK_XYZ));
+		_mm_store_ps(&dst[i + 3].x, _mm_and_ps(_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 2, 1)), MASK_XYZ));
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = Vector3A(src[i]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// aligned Vector3A array to packed Vector3 array, reverse of toAligned()
+///////////////////////////////////////////////////////////////////////////////
+void Gil::fromAligned(const Vector3A* src, Vector3* dst, int count)
+{
+	int i = 0;
+#ifdef GIL_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 v0 = _mm_load_ps(&src[i].x);
+		__m128 v1 = _mm_load_ps(&src[i + 1].x);
+		__m128 v2 = _mm_load_ps(&src[i + 2].x);
+		__m128 v3 = _mm_load_ps(&src[i + 3].x);
+
+		__m128 t1 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 2, 2));   // z0 z0 x1 x1
+		__m128 t2 = _mm_shuffle_ps(v2, v3, _MM_SHUFFLE(0, 0, 2, 2));   // z2 z2 x3 x3
+		float* p = &dst[i].x;
+		_mm_storeu_ps(p, _mm_shuffle_ps(v0, t1, _MM_SHUFFLE(2, 0, 1, 0)));     // x0 y0 z0 x1
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 0, 2, 1))); // y1 z1 x2 y2
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(t2, v3, _MM_SHUFFLE(2, 1, 2, 0))); // z2 x3 y3 z3
+	}
+#endif
+	for (; i < count; ++i)
+		dst[i] = src[i].toVector3();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// transform array of aligned points, same as Matrix4 * Vector3
+// The points are transposed to the lanes of the selected kernel, and the
+// matrix elements are broadcast.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::transformPoints(const Matrix4& m, const Vector3A* in, Vector3A* out, int count)
+{
+	if (count > 0)
+		getKernels().transformAligned(m.get(), &in->x, &out->x, count, 1.0f);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// transform array of aligned directions, no translation
+// NOTE: for normals, pass the transpose of the inverse of the matrix
+///////////////////////////////////////////////////////////////////////////////
+void Gil::transformDirections(const Matrix4& m, const Vector3A* in, Vector3A* out, int count)
+{
+	if (count > 0)
+		getKernels().transformAligned(m.get(), &in->x, &out->x, count, 0.0f);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// element-wise products, out[i] = a[i] * b[i]
+// The lanes of the selected kernel are transposed to SoA form; 16 multiplies
+// per lane group instead of the shuffles of the single product.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::multiply(const Quaternion* a, const Quaternion* b, Quaternion* out, int count)
+{
+	if (count > 0)
+		getKernels().multiplyQuaternions(&a->s, &b->s, &out->s, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// same quaternion a for all elements, out[i] = a * b[i]
+// e.g. parent orientation applied to all children; a may be an element of out
+///////////////////////////////////////////////////////////////////////////////
+void Gil::multiply(const Quaternion& a, const Quaternion* b, Quaternion* out, int count)
+{
+	if (count > 0)
+		getKernels().multiplyQuaternionsBy(&a.s, &b->s, &out->s, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// running product, out[i] = quats[0] * quats[1] * ... * quats[i]
+// A single chain is limited by the latency of each product, so the array is
+// split into one segment per lane of the selected kernel, and the carries of
+// the previous segments are applied after; see simdKernels.h. The result is
+// the same as the sequential product up to rounding.
+///////////////////////////////////////////////////////////////////////////////
+void Gil::multiplyPrefix(const Quaternion* quats, Quaternion* out, int count)
+{
+	if (count > 0)
+		getKernels().multiplyQuaternionPrefix(&quats->s, &out->s, count);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// trigonometric functions of arrays, see simdKernels.h
+///////////////////////////////////////////////////////////////////////////////
+void Gil::sinCos(const float* angles, float* sines, float* cosines, int count)
+{
+	getKernels().sinCos(angles, sines, cosines, count);
+}
+
+void Gil::arcCosine(const float* values, float* angles, int count)
+{
+	getKernels().arcCosine(values, angles, count);
+}
+
+void Gil::arcTangent2(const float* ys, const float* xs, float* angles, int count)
+{
+	getKernels().arcTangent2(ys, xs, angles, count);
+}
@@ -0,0 +1,52 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// mathBatch.h
+// ===========
+// Batch operations over arrays of vectors and quaternions.
+// The normalizations and conversions process 4 elements at a time with SSE
+// if available, and the rest (or all, without SSE) with the scalar member
+// functions. The transforms, the quaternion products and the trigonometric
+// functions use the kernels of simdDispatch.h for the CPU.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+#include "VectorsA.h"
+
+namespace Gil
+{
+	// normalize all elements of the array with the given precision
+	// same as calling Normalize()/normalize() for each element
+	void normalize(Vector2* vecs, int count, NormalizeMode mode = NORMALIZE_EXACT);
+	void normalize(Vector3* vecs, int count, NormalizeMode mode = NORMALIZE_EXACT);
+	void normalize(Vector4* vecs, int count, NormalizeMode mode = NORMALIZE_EXACT);
+	void normalize(Quaternion* quats, int count, NormalizeMode mode = NORMALIZE_EXACT);
+	void normalize(Vector3A* vecs, int count, NormalizeMode mode = NORMALIZE_EXACT);
+
+	// conversion between packed Vector3 (12 bytes) and aligned Vector3A
+	// (16 bytes) arrays, lossless; w of Vector3A is set to 0
+	void toAligned(const Vector3* src, Vector3A* dst, int count);
+	void fromAligned(const Vector3A* src, Vector3* dst, int count);
+
+	// transform aligned arrays with aligned loads and stores, out may be the same as in
+	void transformPoints(const Matrix4& m, const Vector3A* in, Vector3A* out, int count);     // M * (p, 1)
+	void transformDirections(const Matrix4& m, const Vector3A* in, Vector3A* out, int count); // M * (d, 0)
+
+	// composition of quaternion arrays, the output may be the same as an input
+	void multiply(const Quaternion* a, const Quaternion* b, Quaternion* out, int count);   // out[i] = a[i] * b[i]
+	void multiply(const Quaternion& a, const Quaternion* b, Quaternion* out, int count);   // out[i] = a * b[i]
+	void multiplyPrefix(const Quaternion* quats, Quaternion* out, int count);              // out[i] = q[0] * ... * q[i]
+
+	// fast trigonometric functions over float arrays (radian), with the lanes
+	// of the CPU (see simdDispatch.h). See fastMath.h for the error bounds.
+	// The output arrays may be the same as the input.
+	void sinCos(const float* angles, float* sines, float* cosines, int count);
+	void arcCosine(const float* values, float* angles, int count);
+	void arcTangent2(const float* ys, const float* xs, float* angles, int count);
+} //end of namespace Gil
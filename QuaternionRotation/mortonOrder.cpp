@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// mortonOrder.cpp
+// ===============
+// Morton codes and parallel radix sort of the codes.
+// Each pass of the radix sort counts the digits of a contiguous chunk per
+// thread, then the offsets of each (digit, chunk) are summed in the order of
+// the chunks, and each thread scatters its chunk to its own offsets, so the
+// sort is stable without locks. The threads are started once per sort and
+// meet at a std::barrier twice per pass.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <barrier>
+#include <thread>
+#include <vector>
+#include "mortonOrder.h"
+#include "simdDispatch.h"
+#include "profiler.h"
+
+namespace
+{
+	const int RADIX_BITS = 8;
+	const int RADIX = 1 << RADIX_BITS;
+	const int MIN_KEYS_PER_THREAD = 1 << 16;    // smaller arrays are sorted by 1 thread
+	const int MAX_THREADS = 16;
+
+	int getThreadCount(int count)
+	{
+		int threads = (int)std::thread::hardware_concurrency();
+		if (threads > count / MIN_KEYS_PER_THREAD)
+			threads = count / MIN_KEYS_PER_THREAD;
+		if (threads > MAX_THREADS)
+			threads = MAX_THREADS;
+		return threads > 1 ? threads : 1;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// state of a radix sort shared by the threads
+	// The completion step of the barrier runs on one thread between the
+	// phases: prefix sums after the histograms, and the swap of the buffers
+	// after the scatter.
+	///////////////////////////////////////////////////////////////////////////
+	template <class K>
+	class RadixSort
+	{
+	public:
+		struct Step
+		{
+			RadixSort* sort;
+			void operator()() noexcept { sort->step(); }
+		};
+
+		RadixSort(K* keys, int* values, int count) : count(count), threads(getThreadCount(count)),
+			shift(0), src(0), skip(false), scattered(false),
+			keyBuffer(count), valueBuffer(count), offsets(threads * RADIX)
+		{
+			this->keys[0] = keys;
+			this->keys[1] = &keyBuffer[0];
+			this->values[0] = values;
+			this->values[1] = &valueBuffer[0];
+		}
+
+		void sort()
+		{
+			std::barrier<Step> sync(threads, Step{ this });
+			std::vector<std::thread> pool;
+			for (int t = 1; t < threads; ++t)
+				pool.emplace_back(&RadixSort::run, this, t, std::ref(sync));
+			run(0, sync);
+			for (std::thread& thread : pool)
+				thread.join();
+
+			// odd number of scatters, the result is in the buffers
+			if (src != 0)
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					keys[0][i] = keys[1][i];
+					values[0][i] = values[1][i];
+				}
+			}
+		}
+
+	private:
+		int first(int t) const { return (int)((long long)count * t / threads); }
+
+		void run(int t, std::barrier<Step>& sync)
+		{
+			GIL_PROFILE_ZONE("radixSort thread");
+			for (int pass = 0; pass < (int)sizeof(K) * 8 / RADIX_BITS; ++pass)
+			{
+				histogram(t);
+				sync.arrive_and_wait();
+				if (!skip)
+					scatter(t);
+				sync.arrive_and_wait();
+			}
+		}
+
+		void histogram(int t)
+		{
+			int* counts = &offsets[t * RADIX];
+			for (int d = 0; d < RADIX; ++d)
+				counts[d] = 0;
+			const K* k = keys[src];
+			for (int i = first(t), last = first(t + 1); i < last; ++i)
+				++counts[(k[i] >> shift) & (RADIX - 1)];
+		}
+
+		void scatter(int t)
+		{
+			int* next = &offsets[t * RADIX];
+			const K* k = keys[src];
+			const int* v = values[src];
+			K* dstKeys = keys[src ^ 1];
+			int* dstValues = values[src ^ 1];
+			for (int i = first(t), last = first(t + 1); i < last; ++i)
+			{
+				int j = next[(k[i] >> shift) & (RADIX - 1)]++;
+				dstKeys[j] = k[i];
+				dstValues[j] = v[i];
+			}
+		}
+
+		// prefix sums of the histograms, or the end of a pass
+		void step()
+		{
+			if (!scattered)
+			{
+				skip = false;
+				int sum = 0;
+				for (int d = 0; d < RADIX; ++d)
+				{
+					int start = sum;
+					for (int t = 0; t < threads; ++t)
+					{
+						int n = offsets[t * RADIX + d];
+						offsets[t * RADIX + d] = sum;
+						sum += n;
+					}
+					if (sum - start == count)   // all keys have digit d
+					{
+						skip = true;
+						break;
+					}
+				}
+				scattered = true;
+			}
+			else
+			{
+				if (!skip)
+					src ^= 1;
+				shift += RADIX_BITS;
+				scattered = false;
+			}
+		}
+
+		K* keys[2];
+		int* values[2];
+		int count;
+		int threads;
+		int shift;
+		int src;                    // index of the keys and values of this pass
+		bool skip;                  // all keys have the same digit in this pass
+		bool scattered;             // phase of the pass for step()
+		std::vector<K> keyBuffer;
+		std::vector<int> valueBuffer;
+		std::vector<int> offsets;   // counts, then next positions of (thread, digit)
+	};
+
+	// scale from the box to 2^bits cells per axis, 0 for flat axes
+	void getScale(const Vector3& min, const Vector3& max, int bits, float scale[3])
+	{
+		float cells = (float)(1 << bits);
+		Vector3 size = max - min;
+		scale[0] = size.x > 0 ? cells / size.x : 0;
+		scale[1] = size.y > 0 ? cells / size.y : 0;
+		scale[2] = size.z > 0 ? cells / size.z : 0;
+	}
+}
+
+
+
+void Gil::getBounds(const Vector3* points, int count, Vector3& min, Vector3& max)
+{
+	if (count <= 0)
+	{
+		min.Set(0, 0, 0);
+		max.Set(0, 0, 0);
+		return;
+	}
+
+	min = max = points[0];
+	for (int i = 1; i < count; ++i)
+	{
+		const Vector3& p = points[i];
+		if (p.x < min.x) min.x = p.x;
+		if (p.y < min.y) min.y = p.y;
+		if (p.z < min.z) min.z = p.z;
+		if (p.x > max.x) max.x = p.x;
+		if (p.y > max.y) max.y = p.y;
+		if (p.z > max.z) max.z = p.z;
+	}
+}
+
+void Gil::mortonCodes(const Vector3* points, int count, const Vector3& min, const Vector3& max, unsigned int* codes)
+{
+	if (count <= 0)
+		return;
+	float scale[3];
+	getScale(min, max, 10, scale);
+	getKernels().mortonCodes30(&points->x, count, &min.x, scale, codes);
+}
+
+void Gil::mortonCodes(const Vector3* points, int count, const Vector3& min, const Vector3& max, unsigned long long* codes)
+{
+	if (count <= 0)
+		return;
+	float scale[3];
+	getScale(min, max, 21, scale);
+	getKernels().mortonCodes63(&points->x, count, &min.x, scale, codes);
+}
+
+void Gil::radixSort(unsigned int* keys, int* values, int count)
+{
+	GIL_PROFILE_ZONE("radixSort");
+	if (count > 1)
+		RadixSort<unsigned int>(keys, values, count).sort();
+}
+
+void Gil::radixSort(unsigned long long* keys, int* values, int count)
+{
+	GIL_PROFILE_ZONE("radixSort");
+	if (count > 1)
+		RadixSort<unsigned long long>(keys, values, count).sort();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// quantize in the bounding box, compute the codes and sort the indices
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::mortonOrder(const Vector3* points, int count, int* order, MortonBits bits)
+{
+	GIL_PROFILE_ZONE("mortonOrder");
+	if (count < 0)
+		return false;
+	for (int i = 0; i < count; ++i)
+		order[i] = i;
+	if (count < 2)
+		return true;
+
+	Vector3 min, max;
+	getBounds(points, count, min, max);
+	if (bits == MORTON_63)
+	{
+		std::vector<unsigned long long> codes(count);
+		mortonCodes(points, count, min, max, &codes[0]);
+		radixSort(&codes[0], order, count);
+	}
+	else
+	{
+		std::vector<unsigned int> codes(count);
+		mortonCodes(points, count, min, max, &codes[0]);
+		radixSort(&codes[0], order, count);
+	}
+	return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// mortonOrder.h
+// =============
+// Morton (Z-order) sorting of point and vertex sets. The positions are
+// quantized in the bounding box, interleaved to 30-bit (10 bits per axis) or
+// 63-bit (21 bits per axis) Morton codes in a SIMD pass (see simdDispatch.h),
+// and sorted by the codes with a parallel LSD radix sort. The result is the
+// permutation, so any number of vertex attributes can be reordered with it.
+//
+// Points close in the Morton order are close in space, so traversals in this
+// order touch fewer cache lines and pages than in the input order or in the
+// lexicographic order of Vector3::operator<, which sorts by x only for
+// distinct x values.
+//
+// usage:
+//   std::vector<int> order(count);
+//   Gil::mortonOrder(points, count, &order[0]);            // 30-bit codes
+//   Gil::reorder(points, &order[0], sorted, count);        // sorted[i] = points[order[i]]
+//   Gil::reorder(normals, &order[0], sortedNormals, count);
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Vectors.h"
+
+namespace Gil
+{
+	// bits of the Morton codes
+	enum MortonBits
+	{
+		MORTON_30 = 30,         // 10 bits per axis, 1024^3 cells
+		MORTON_63 = 63          // 21 bits per axis, for large or dense sets
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// Morton code of quantized coordinates, x is the highest bit of each triple
+	// (bits of the arguments above 10 or 21 are ignored)
+	///////////////////////////////////////////////////////////////////////////
+	constexpr unsigned int spreadBits3(unsigned int v)
+	{
+		v &= 0x7ff;
+		v = (v | (v << 16)) & 0x070000ff;
+		v = (v | (v << 8)) & 0x0700f00f;
+		v = (v | (v << 4)) & 0x430c30c3;
+		v = (v | (v << 2)) & 0x49249249;
+		return v;
+	}
+
+	constexpr unsigned int mortonCode30(unsigned int x, unsigned int y, unsigned int z)
+	{
+		return (spreadBits3(x & 0x3ff) << 2) | (spreadBits3(y & 0x3ff) << 1) | spreadBits3(z & 0x3ff);
+	}
+
+	constexpr unsigned long long mortonCode63(unsigned int x, unsigned int y, unsigned int z)
+	{
+		unsigned long long high = ((unsigned long long)spreadBits3(x >> 10) << 2)
+			| ((unsigned long long)spreadBits3(y >> 10) << 1) | spreadBits3(z >> 10);
+		return (high << 30) | mortonCode30(x, y, z);
+	}
+
+	// bounding box of the points, min = max = 0 if count is 0
+	void getBounds(const Vector3* points, int count, Vector3& min, Vector3& max);
+
+	// Morton codes of the points quantized in the box min-max
+	void mortonCodes(const Vector3* points, int count, const Vector3& min, const Vector3& max, unsigned int* codes);
+	void mortonCodes(const Vector3* points, int count, const Vector3& min, const Vector3& max, unsigned long long* codes);
+
+	///////////////////////////////////////////////////////////////////////////
+	// stable LSD radix sort of keys with the values (e.g. indices), 8 bits per
+	// pass; the passes where all keys have the same digit are skipped, and
+	// large arrays are sorted by several threads
+	///////////////////////////////////////////////////////////////////////////
+	void radixSort(unsigned int* keys, int* values, int count);
+	void radixSort(unsigned long long* keys, int* values, int count);
+
+	// permutation of the points in Morton order, points[order[0]] is the first
+	// (equal codes keep the input order); returns false if count is negative
+	bool mortonOrder(const Vector3* points, int count, int* order, MortonBits bits = MORTON_30);
+
+	// dst[i] = src[order[i]], dst must not be src
+	template <class T>
+	void reorder(const T* src, const int* order, T* dst, int count)
+	{
+		for (int i = 0; i < count; ++i)
+			dst[i] = src[order[i]];
+	}
+} //end of namespace Gil
@@ -0,0 +1,318 @@
+///////////////////////////////////////////////////////////////////////////////
+// profiler.cpp
+// ============
+// Per-thread ring buffers of zone events, frame statistics and trace files.
+// Each buffer has one writer (its thread) and one reader (endProfileFrame),
+// so the head and tail indices are enough to share it without a lock. The
+// mutex is only taken when a thread gets its buffer, and by the reader.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include "profiler.h"
+#include "Timer.h"
+
+namespace
+{
+	const uint32_t BUFFER_SIZE = 1 << 14;       // events per thread, power of 2
+	const size_t MAX_TRACE_EVENTS = 1 << 22;    // the trace stops growing after
+
+	struct Event
+	{
+		const char* name;
+		int64_t start;                          // ticks
+		int64_t end;
+		int depth;
+		int thread;                             // id in the trace, fills the padding
+	};
+
+	struct ThreadBuffer
+	{
+		ThreadBuffer(int id) : events(BUFFER_SIZE), head(0), tail(0), dropped(0), inUse(true), id(id), depth(0) {}
+
+		std::vector<Event> events;
+		std::atomic<uint32_t> head;             // next write, by the thread
+		std::atomic<uint32_t> tail;             // next read, by the reader
+		std::atomic<int> dropped;
+		std::atomic<bool> inUse;                // a thread owns the buffer
+		int id;                                 // id of the owner thread in the trace
+		int depth;                              // open zones of the thread
+	};
+
+	// gives the buffer back at thread exit, so short-lived threads reuse it
+	struct BufferOwner
+	{
+		ThreadBuffer* buffer = 0;
+		~BufferOwner()
+		{
+			if (buffer)
+				buffer->inUse.store(false, std::memory_order_release);
+		}
+	};
+
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	int threadCount = 0;                        // ids given to threads, by registryMutex
+	thread_local BufferOwner bufferOwner;
+
+	// reader state, used by one thread
+	Gil::FrameStats lastFrame = { -1, 0, 0, {} };
+	int64_t frameStart = 0;
+	std::unordered_map<std::string_view, int> zoneIndices;
+	std::vector<Gil::ZoneStats> zones;
+	std::vector<int64_t> zoneStarts;            // first start of the zones
+	std::vector<int> zoneOrder;
+	bool tracing = false;
+	int64_t traceStart = 0;
+	std::vector<Event> traceEvents;
+
+	// Timer::CYCLES falls back to the clock if the TSC is not invariant
+	inline int64_t now()
+	{
+		return Timer::getTicks(Timer::CYCLES);
+	}
+
+	double nanoSecPerTick()
+	{
+		static const double ns = Timer::getNanoSecPerTick(Timer::CYCLES);
+		return ns;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// buffer of the calling thread; a free buffer of an ended thread is
+	// reused before a new one is made, but the thread gets a new id, so the
+	// trace does not merge the two threads (the unread events of the ended
+	// thread keep their own id)
+	///////////////////////////////////////////////////////////////////////////
+	ThreadBuffer* getThreadBuffer()
+	{
+		ThreadBuffer* buffer = bufferOwner.buffer;
+		if (buffer)
+			return buffer;
+
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (size_t i = 0; i < buffers.size() && !buffer; ++i)
+		{
+			if (!buffers[i]->inUse.load(std::memory_order_acquire))
+				buffer = buffers[i].get();
+		}
+		if (buffer)
+		{
+			buffer->inUse.store(true, std::memory_order_relaxed);
+			buffer->id = threadCount++;
+			buffer->depth = 0;
+		}
+		else
+		{
+			buffers.push_back(std::make_unique<ThreadBuffer>(threadCount++));
+			buffer = buffers.back().get();
+		}
+		bufferOwner.buffer = buffer;
+		return buffer;
+	}
+
+	// writer side, drops the event if the reader is BUFFER_SIZE behind
+	void pushEvent(ThreadBuffer* buffer, const Event& event)
+	{
+		uint32_t head = buffer->head.load(std::memory_order_relaxed);
+		if (head - buffer->tail.load(std::memory_order_acquire) >= BUFFER_SIZE)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer->events[head & (BUFFER_SIZE - 1)] = event;
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	void addToFrame(const Event& event, int64_t ns)
+	{
+		std::pair<std::unordered_map<std::string_view, int>::iterator, bool> found =
+			zoneIndices.emplace(std::string_view(event.name), (int)zones.size());
+		if (found.second)
+		{
+			Gil::ZoneStats stats = { event.name, event.depth, 1, ns, ns, ns };
+			zones.push_back(stats);
+			zoneStarts.push_back(event.start);
+			return;
+		}
+
+		int index = found.first->second;
+		Gil::ZoneStats& stats = zones[index];
+		++stats.count;
+		stats.totalNs += ns;
+		stats.minNs = (std::min)(stats.minNs, ns);    // not the macros of windows.h
+		stats.maxNs = (std::max)(stats.maxNs, ns);
+		if (event.start < zoneStarts[index])
+		{
+			zoneStarts[index] = event.start;
+			stats.depth = event.depth;
+		}
+	}
+
+	void addToTrace(const Event& event)
+	{
+		if (!tracing || event.start < traceStart || traceEvents.size() >= MAX_TRACE_EVENTS)
+			return;
+		traceEvents.push_back(event);
+	}
+
+	FILE* openFile(const char* fileName)
+	{
+#ifdef _MSC_VER
+		FILE* file = 0;
+		if (fopen_s(&file, fileName, "w") != 0)
+			return 0;
+		return file;
+#else
+		return fopen(fileName, "w");
+#endif
+	}
+
+	// JSON string without the quotes
+	void writeName(FILE* file, const char* name)
+	{
+		for (const char* c = name; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				fputc('\\', file);
+			if ((unsigned char)*c >= 0x20)
+				fputc(*c, file);
+		}
+	}
+}
+
+
+
+Gil::ProfileZone::ProfileZone(const char* name) : name(name)
+{
+	++getThreadBuffer()->depth;
+	start = now();
+}
+
+Gil::ProfileZone::~ProfileZone()
+{
+	int64_t end = now();
+	ThreadBuffer* buffer = getThreadBuffer();
+	Event event = { name, start, end, --buffer->depth, buffer->id };
+	pushEvent(buffer, event);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// read the events of all threads since the last call, and replace the frame
+// statistics with their sums; while tracing, the events and the frame itself
+// are also kept for the trace file
+///////////////////////////////////////////////////////////////////////////////
+void Gil::endProfileFrame()
+{
+	int64_t frameEnd = now();
+	double ns = nanoSecPerTick();
+	int thread = getThreadBuffer()->id;
+
+	zoneIndices.clear();
+	zones.clear();
+	zoneStarts.clear();
+	int dropped = 0;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (size_t i = 0; i < buffers.size(); ++i)
+		{
+			ThreadBuffer* buffer = buffers[i].get();
+			uint32_t head = buffer->head.load(std::memory_order_acquire);
+			for (uint32_t j = buffer->tail.load(std::memory_order_relaxed); j != head; ++j)
+			{
+				const Event& event = buffer->events[j & (BUFFER_SIZE - 1)];
+				addToFrame(event, (int64_t)((event.end - event.start) * ns));
+				addToTrace(event);
+			}
+			buffer->tail.store(head, std::memory_order_release);
+			dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+		}
+	}
+
+	// zones in order of their first start, so a parent comes before its children
+	zoneOrder.resize(zones.size());
+	for (size_t i = 0; i < zoneOrder.size(); ++i)
+		zoneOrder[i] = (int)i;
+	std::sort(zoneOrder.begin(), zoneOrder.end(), [](int a, int b) { return zoneStarts[a] < zoneStarts[b]; });
+
+	lastFrame.zones.clear();
+	for (size_t i = 0; i < zoneOrder.size(); ++i)
+		lastFrame.zones.push_back(zones[zoneOrder[i]]);
+	lastFrame.frameNs = frameStart ? (int64_t)((frameEnd - frameStart) * ns) : 0;
+	lastFrame.dropped = dropped;
+	++lastFrame.frame;
+
+	if (frameStart)
+	{
+		Event frame = { "frame", frameStart, frameEnd, 0, thread };
+		addToTrace(frame);
+	}
+	frameStart = frameEnd;
+}
+
+const Gil::FrameStats& Gil::getProfileFrame()
+{
+	return lastFrame;
+}
+
+void Gil::beginProfileTrace()
+{
+	traceEvents.clear();
+	traceStart = now();
+	tracing = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// write the events read by endProfileFrame() since beginProfileTrace() as
+// complete ("X") events of the Chrome Trace Event format, in micro-seconds
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::endProfileTrace(const char* fileName)
+{
+	tracing = false;
+	FILE* file = openFile(fileName);
+	if (!file)
+		return false;
+
+	double us = nanoSecPerTick() * 0.001;
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	for (size_t i = 0; i < traceEvents.size(); ++i)
+	{
+		const Event& event = traceEvents[i];
+		fprintf(file, "{\"name\":\"");
+		writeName(file, event.name);
+		fprintf(file, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d},\n",
+			(event.start - traceStart) * us, (event.end - event.start) * us, event.thread);
+	}
+
+	// names of the threads, in the order they got their ids
+	int threads;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		threads = threadCount;
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}%s\n",
+			i, i, i + 1 < threads ? "," : "");
+	}
+	fprintf(file, "]}\n");
+
+	traceEvents.clear();
+	bool ok = !ferror(file);
+	return fclose(file) == 0 && ok;
+}
+
+bool Gil::isProfileTracing()
+{
+	return tracing;
+}
@@ -0,0 +1,104 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// profiler.h
+// ==========
+// Scoped profiling zones with per-frame statistics and trace export.
+//
+// A zone measures the time from its construction to the end of its scope.
+// Zones nest; the depth is kept per thread. Each thread writes its events to
+// its own ring buffer with one atomic store and no lock, and the buffers are
+// read by endProfileFrame(), which sums the events of the frame per zone name
+// (count, total, min, max). Between beginProfileTrace() and endProfileTrace()
+// the events are also kept, and written as a Chrome Trace Event JSON file,
+// which opens in chrome://tracing and ui.perfetto.dev.
+//
+// The time stamps are the ticks of Timer::CYCLES (Timer::CLOCK if the TSC is
+// not invariant), converted to nano-seconds when the buffers are read.
+//
+// The macros compile to nothing unless GIL_PROFILE is defined in the project
+// settings, so the zones can stay in the code.
+//
+// NOTE: the zone names must be string literals (or live as long as the
+// program). endProfileFrame() and the trace functions must be called from
+// one thread, e.g. the display callback. A full buffer drops the new events,
+// see FrameStats::dropped.
+//
+// usage:
+//   void displayCB()
+//   {
+//       GIL_PROFILE_FRAME();                           // ends the previous frame
+//       GIL_PROFILE_ZONE("displayCB");
+//       {
+//           GIL_PROFILE_ZONE("draw");
+//           draw();
+//       }
+//   }
+//   const Gil::FrameStats& stats = Gil::getProfileFrame();
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <vector>
+
+#ifdef GIL_PROFILE
+#define GIL_PROFILE_CONCAT2(a, b)   a##b
+#define GIL_PROFILE_CONCAT(a, b)    GIL_PROFILE_CONCAT2(a, b)
+#define GIL_PROFILE_ZONE(name)      Gil::ProfileZone GIL_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define GIL_PROFILE_FUNCTION()      GIL_PROFILE_ZONE(__func__)
+#define GIL_PROFILE_FRAME()         Gil::endProfileFrame()
+#else
+#define GIL_PROFILE_ZONE(name)      ((void)0)
+#define GIL_PROFILE_FUNCTION()      ((void)0)
+#define GIL_PROFILE_FRAME()         ((void)0)
+#endif
+
+namespace Gil
+{
+	// statistics of a zone name in a frame, over all threads
+	struct ZoneStats
+	{
+		const char* name;
+		int depth;                  // nesting depth of the first event, 0 at the top
+		int count;                  // events
+		int64_t totalNs;
+		int64_t minNs;
+		int64_t maxNs;
+	};
+
+	// statistics of a frame, the zones in order of their first start
+	struct FrameStats
+	{
+		int frame;                  // number of the frame, from 0
+		int64_t frameNs;            // time between the 2 endProfileFrame() calls
+		int dropped;                // events lost to full buffers
+		std::vector<ZoneStats> zones;
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// RAII zone, use GIL_PROFILE_ZONE() instead to compile it out
+	///////////////////////////////////////////////////////////////////////////
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name);
+		~ProfileZone();
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		const char* name;
+		int64_t start;              // ticks
+	};
+
+	void endProfileFrame();                     // read the thread buffers and sum the frame
+	const FrameStats& getProfileFrame();        // last finished frame
+
+	void beginProfileTrace();                   // keep the events from now on
+	bool endProfileTrace(const char* fileName); // write the kept events as JSON, false if the file fails
+	bool isProfileTracing();
+} //end of namespace Gil
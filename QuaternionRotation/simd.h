@@ -0,0 +1,455 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// simd.h
+// ======
+// Thin lane wrappers to write a math kernel once and instantiate it for
+// scalar float (Simd1), SSE 4-lane (Simd4) and AVX2+FMA 8-lane (Simd8).
+// Each wrapper has the same set of static functions;
+//   F: float lanes, I: int32 lanes, M: comparison mask
+// The int32 functions (truncate, andi, ori, shli, shri, storei) are for bit
+// manipulation such as Morton codes. load4/store4 move 4-float items at a
+// stride (quaternions, matrix columns) between AoS arrays and the lanes;
+// lane k is the item at p + k * stride, and a..d are its 4 floats.
+// The wider wrappers also work on 4-float groups (group g is lanes 4g..4g+3);
+// shuffle() is _mm_shuffle_ps within each group, and loadGroups/storeGroups
+// move group g from/to p + g * stride.
+//
+// Simd4 is enabled on x64 (or x86 with /arch:SSE2), Simd8 only if the
+// translation unit is compiled with AVX2 and FMA (/arch:AVX2, -mavx2 -mfma),
+// and Simd16 with AVX-512 (/arch:AVX512, -mavx512f).
+//
+// The kernels of simdDispatch.h are compiled once per instruction set in
+// separate translation units. Such a unit selects its target by defining one
+// of GIL_TARGET_SCALAR, GIL_TARGET_SSE2, GIL_TARGET_AVX2 or GIL_TARGET_AVX512
+// before including this file, and everything below is declared in an inline
+// namespace named by the target (isa_sse2, isa_avx2, ...). The inline
+// functions of different targets then have different symbols, so the linker
+// cannot pick an AVX2 copy of an inline function for SSE2 code.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(GIL_TARGET_SCALAR)
+// no lanes wider than Simd1, reference kernels of the dispatch
+
+#elif defined(GIL_TARGET_SSE2) || defined(GIL_TARGET_AVX2) || defined(GIL_TARGET_AVX512)
+// explicit target of a kernel unit, regardless of the compiler options
+#define GIL_SSE 1
+#include <emmintrin.h>
+#if defined(GIL_TARGET_AVX2) || defined(GIL_TARGET_AVX512)
+#define GIL_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(GIL_TARGET_AVX512)
+#define GIL_AVX512 1
+#endif
+
+// MSVC uses /arch of the file (see the project file); gcc and clang enable
+// the instructions for the rest of the unit
+#if defined(__GNUC__) && defined(GIL_TARGET_AVX512)
+#pragma GCC target("avx512f,avx2,fma,f16c")
+#elif defined(__GNUC__) && defined(GIL_TARGET_AVX2)
+#pragma GCC target("avx2,fma,f16c")
+#endif
+
+#else
+// SSE is the baseline on x64; on x86 it requires /arch:SSE2 (MSVC default)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GIL_SSE 1
+#include <emmintrin.h>
+#endif
+
+// MSVC defines __AVX2__ with /arch:AVX2, which also allows FMA instructions
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define GIL_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(GIL_AVX2) && defined(__AVX512F__)
+#define GIL_AVX512 1
+#endif
+#endif
+
+// name of the inline namespace of this target
+#if defined(GIL_AVX512)
+#define GIL_ISA isa_avx512
+#elif defined(GIL_AVX2)
+#define GIL_ISA isa_avx2
+#elif defined(GIL_SSE)
+#define GIL_ISA isa_sse2
+#else
+#define GIL_ISA isa_scalar
+#endif
+
+namespace Gil {
+inline namespace GIL_ISA
+{
+	///////////////////////////////////////////////////////////////////////////
+	// square root for constant expressions, Newton iteration in double
+	///////////////////////////////////////////////////////////////////////////
+	constexpr float constSqrt(float x)
+	{
+		if (x < 0)
+			return std::numeric_limits<float>::quiet_NaN();
+		if (x == 0 || x == std::numeric_limits<float>::infinity())
+			return x;
+		double r = x > 1 ? x : 1.0;     // start above the root, then it decreases
+		for (;;)
+		{
+			double next = 0.5 * (r + x / r);
+			if (next >= r)              // converged
+				break;
+			r = next;
+		}
+		return (float)r;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// scalar (1 lane)
+	// All functions are constexpr, so the kernels can run at compile time.
+	// The ones calling the C library have a plain C++ version for constant
+	// expressions.
+	///////////////////////////////////////////////////////////////////////////
+	struct Simd1
+	{
+		typedef float F;
+		typedef int   I;
+		typedef bool  M;
+		static const int WIDTH = 1;
+
+		static constexpr F set1(float a)                { return a; }
+		static constexpr F load(const float* p)         { return *p; }
+		static constexpr void store(float* p, F a)      { *p = a; }
+		static constexpr F add(F a, F b)                { return a + b; }
+		static constexpr F sub(F a, F b)                { return a - b; }
+		static constexpr F mul(F a, F b)                { return a * b; }
+		static constexpr F div(F a, F b)                { return a / b; }
+		static constexpr F fmadd(F a, F b, F c)         { return a * b + c; }
+		static constexpr F sqrt(F a)
+		{
+			if (std::is_constant_evaluated())
+				return constSqrt(a);
+			return sqrtf(a);
+		}
+		static constexpr F abs(F a)                     { return a < 0 ? -a : (a == 0 ? 0.0f : a); }
+		static constexpr F min(F a, F b)                { return a < b ? a : b; }
+		static constexpr F max(F a, F b)                { return a > b ? a : b; }
+		static constexpr M lt(F a, F b)                 { return a < b; }
+		static constexpr M gt(F a, F b)                 { return a > b; }
+		static constexpr F select(M m, F a, F b)        { return m ? a : b; }
+		static constexpr F negateIf(M m, F a)           { return m ? -a : a; }
+		static constexpr F copySign(F a, F s)
+		{
+			if (std::is_constant_evaluated())
+				return (s < 0) != (a < 0) ? -a : a;    // -0 is treated as +0
+			return copysignf(a, s);
+		}
+		static constexpr I round(F a)
+		{
+			if (std::is_constant_evaluated())
+			{
+				float b = a + 0.5f;
+				int i = (int)b;                         // truncate, then floor
+				return (float)i > b ? i - 1 : i;
+			}
+			return (int)floorf(a + 0.5f);
+		}
+		static constexpr F toFloat(I i)                 { return (float)i; }
+		static constexpr M testBits(I i, int bits)      { return (i & bits) != 0; }
+		static constexpr I addi(I i, int n)             { return i + n; }
+		static constexpr void transpose4(F&, F&, F&, F&) {}
+		static constexpr void load4(const float* p, int, F& a, F& b, F& c, F& d)
+		{
+			a = p[0];  b = p[1];  c = p[2];  d = p[3];
+		}
+		static constexpr void store4(float* p, int, F a, F b, F c, F d)
+		{
+			p[0] = a;  p[1] = b;  p[2] = c;  p[3] = d;
+		}
+		static constexpr I truncate(F a)                { return (int)a; }
+		static constexpr I andi(I i, int bits)          { return i & bits; }
+		static constexpr I ori(I a, I b)                { return a | b; }
+		template <int N> static constexpr I shli(I i)   { return (int)((unsigned int)i << N); }
+		template <int N> static constexpr I shri(I i)   { return (int)((unsigned int)i >> N); }
+		static constexpr void storei(int* p, I i)       { *p = i; }
+	};
+
+#ifdef GIL_SSE
+	///////////////////////////////////////////////////////////////////////////
+	// SSE2 (4 lanes)
+	///////////////////////////////////////////////////////////////////////////
+	struct Simd4
+	{
+		typedef __m128  F;
+		typedef __m128i I;
+		typedef __m128  M;
+		static const int WIDTH = 4;
+
+		static F set1(float a)                  { return _mm_set1_ps(a); }
+		static F load(const float* p)           { return _mm_loadu_ps(p); }
+		static void store(float* p, F a)        { _mm_storeu_ps(p, a); }
+		static F add(F a, F b)                  { return _mm_add_ps(a, b); }
+		static F sub(F a, F b)                  { return _mm_sub_ps(a, b); }
+		static F mul(F a, F b)                  { return _mm_mul_ps(a, b); }
+		static F div(F a, F b)                  { return _mm_div_ps(a, b); }
+		static F fmadd(F a, F b, F c)           { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static F sqrt(F a)                      { return _mm_sqrt_ps(a); }
+		static F abs(F a)                       { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		static F min(F a, F b)                  { return _mm_min_ps(a, b); }
+		static F max(F a, F b)                  { return _mm_max_ps(a, b); }
+		static M lt(F a, F b)                   { return _mm_cmplt_ps(a, b); }
+		static M gt(F a, F b)                   { return _mm_cmpgt_ps(a, b); }
+		static F select(M m, F a, F b)          { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+		static F negateIf(M m, F a)             { return _mm_xor_ps(a, _mm_and_ps(m, _mm_set1_ps(-0.0f))); }
+		static F copySign(F a, F s)
+		{
+			__m128 sign = _mm_set1_ps(-0.0f);
+			return _mm_or_ps(_mm_andnot_ps(sign, a), _mm_and_ps(sign, s));
+		}
+		static I round(F a)                     { return _mm_cvtps_epi32(a); }
+		static F toFloat(I i)                   { return _mm_cvtepi32_ps(i); }
+		static M testBits(I i, int bits)
+		{
+			__m128i b = _mm_set1_epi32(bits);
+			return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, b), b));
+		}
+		static I addi(I i, int n)               { return _mm_add_epi32(i, _mm_set1_epi32(n)); }
+		static void transpose4(F& a, F& b, F& c, F& d)  { _MM_TRANSPOSE4_PS(a, b, c, d); }
+		template <int S> static F shuffle(F a, F b)     { return _mm_shuffle_ps(a, b, S); }
+		static F loadGroups(const float* p, int)        { return _mm_loadu_ps(p); }
+		static void storeGroups(float* p, int, F a)     { _mm_storeu_ps(p, a); }
+		static void load4(const float* p, int stride, F& a, F& b, F& c, F& d)
+		{
+			a = _mm_loadu_ps(p);
+			b = _mm_loadu_ps(p + stride);
+			c = _mm_loadu_ps(p + stride * 2);
+			d = _mm_loadu_ps(p + stride * 3);
+			_MM_TRANSPOSE4_PS(a, b, c, d);
+		}
+		static void store4(float* p, int stride, F a, F b, F c, F d)
+		{
+			_MM_TRANSPOSE4_PS(a, b, c, d);
+			_mm_storeu_ps(p, a);
+			_mm_storeu_ps(p + stride, b);
+			_mm_storeu_ps(p + stride * 2, c);
+			_mm_storeu_ps(p + stride * 3, d);
+		}
+		static I truncate(F a)                  { return _mm_cvttps_epi32(a); }
+		static I andi(I i, int bits)            { return _mm_and_si128(i, _mm_set1_epi32(bits)); }
+		static I ori(I a, I b)                  { return _mm_or_si128(a, b); }
+		template <int N> static I shli(I i)     { return _mm_slli_epi32(i, N); }
+		template <int N> static I shri(I i)     { return _mm_srli_epi32(i, N); }
+		static void storei(int* p, I i)         { _mm_storeu_si128((__m128i*)p, i); }
+	};
+#endif
+
+#ifdef GIL_AVX2
+	///////////////////////////////////////////////////////////////////////////
+	// AVX2 + FMA (8 lanes)
+	///////////////////////////////////////////////////////////////////////////
+	struct Simd8
+	{
+		typedef __m256  F;
+		typedef __m256i I;
+		typedef __m256  M;
+		static const int WIDTH = 8;
+
+		static F set1(float a)                  { return _mm256_set1_ps(a); }
+		static F load(const float* p)           { return _mm256_loadu_ps(p); }
+		static void store(float* p, F a)        { _mm256_storeu_ps(p, a); }
+		static F add(F a, F b)                  { return _mm256_add_ps(a, b); }
+		static F sub(F a, F b)                  { return _mm256_sub_ps(a, b); }
+		static F mul(F a, F b)                  { return _mm256_mul_ps(a, b); }
+		static F div(F a, F b)                  { return _mm256_div_ps(a, b); }
+		static F fmadd(F a, F b, F c)           { return _mm256_fmadd_ps(a, b, c); }
+		static F sqrt(F a)                      { return _mm256_sqrt_ps(a); }
+		static F abs(F a)                       { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		static F min(F a, F b)                  { return _mm256_min_ps(a, b); }
+		static F max(F a, F b)                  { return _mm256_max_ps(a, b); }
+		static M lt(F a, F b)                   { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static M gt(F a, F b)                   { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static F select(M m, F a, F b)          { return _mm256_blendv_ps(b, a, m); }
+		static F negateIf(M m, F a)             { return _mm256_xor_ps(a, _mm256_and_ps(m, _mm256_set1_ps(-0.0f))); }
+		static F copySign(F a, F s)
+		{
+			__m256 sign = _mm256_set1_ps(-0.0f);
+			return _mm256_or_ps(_mm256_andnot_ps(sign, a), _mm256_and_ps(sign, s));
+		}
+		static I round(F a)                     { return _mm256_cvtps_epi32(a); }
+		static F toFloat(I i)                   { return _mm256_cvtepi32_ps(i); }
+		static M testBits(I i, int bits)
+		{
+			__m256i b = _mm256_set1_epi32(bits);
+			return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(i, b), b));
+		}
+		static I addi(I i, int n)               { return _mm256_add_epi32(i, _mm256_set1_epi32(n)); }
+		static void transpose4(F& a, F& b, F& c, F& d)
+		{
+			__m256 t0 = _mm256_unpacklo_ps(a, b);
+			__m256 t1 = _mm256_unpacklo_ps(c, d);
+			__m256 t2 = _mm256_unpackhi_ps(a, b);
+			__m256 t3 = _mm256_unpackhi_ps(c, d);
+			a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+			b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+			c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+			d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+		template <int S> static F shuffle(F a, F b)     { return _mm256_shuffle_ps(a, b, S); }
+		static F loadGroups(const float* p, int stride)
+		{
+			return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + stride), 1);
+		}
+		static void storeGroups(float* p, int stride, F a)
+		{
+			_mm_storeu_ps(p, _mm256_castps256_ps128(a));
+			_mm_storeu_ps(p + stride, _mm256_extractf128_ps(a, 1));
+		}
+		// register j holds the items j and j + 4, so transpose4() puts lane k in place
+		static void load4(const float* p, int stride, F& a, F& b, F& c, F& d)
+		{
+			a = loadGroups(p, stride * 4);
+			b = loadGroups(p + stride, stride * 4);
+			c = loadGroups(p + stride * 2, stride * 4);
+			d = loadGroups(p + stride * 3, stride * 4);
+			transpose4(a, b, c, d);
+		}
+		static void store4(float* p, int stride, F a, F b, F c, F d)
+		{
+			transpose4(a, b, c, d);
+			storeGroups(p, stride * 4, a);
+			storeGroups(p + stride, stride * 4, b);
+			storeGroups(p + stride * 2, stride * 4, c);
+			storeGroups(p + stride * 3, stride * 4, d);
+		}
+		static I truncate(F a)                  { return _mm256_cvttps_epi32(a); }
+		static I andi(I i, int bits)            { return _mm256_and_si256(i, _mm256_set1_epi32(bits)); }
+		static I ori(I a, I b)                  { return _mm256_or_si256(a, b); }
+		template <int N> static I shli(I i)     { return _mm256_slli_epi32(i, N); }
+		template <int N> static I shri(I i)     { return _mm256_srli_epi32(i, N); }
+		static void storei(int* p, I i)         { _mm256_storeu_si256((__m256i*)p, i); }
+	};
+#endif
+
+#ifdef GIL_AVX512
+	///////////////////////////////////////////////////////////////////////////
+	// AVX-512 (16 lanes), the comparison mask is a bit mask
+	///////////////////////////////////////////////////////////////////////////
+	struct Simd16
+	{
+		typedef __m512    F;
+		typedef __m512i   I;
+		typedef __mmask16 M;
+		static const int WIDTH = 16;
+
+		static F set1(float a)                  { return _mm512_set1_ps(a); }
+		static F load(const float* p)           { return _mm512_loadu_ps(p); }
+		static void store(float* p, F a)        { _mm512_storeu_ps(p, a); }
+		static F add(F a, F b)                  { return _mm512_add_ps(a, b); }
+		static F sub(F a, F b)                  { return _mm512_sub_ps(a, b); }
+		static F mul(F a, F b)                  { return _mm512_mul_ps(a, b); }
+		static F div(F a, F b)                  { return _mm512_div_ps(a, b); }
+		static F fmadd(F a, F b, F c)           { return _mm512_fmadd_ps(a, b, c); }
+		static F sqrt(F a)                      { return _mm512_sqrt_ps(a); }
+		static F abs(F a)                       { return _mm512_abs_ps(a); }
+		static F min(F a, F b)                  { return _mm512_min_ps(a, b); }
+		static F max(F a, F b)                  { return _mm512_max_ps(a, b); }
+		static M lt(F a, F b)                   { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+		static M gt(F a, F b)                   { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+		static F select(M m, F a, F b)          { return _mm512_mask_blend_ps(m, b, a); }
+		static F negateIf(M m, F a)
+		{
+			__m512i i = _mm512_castps_si512(a);
+			return _mm512_castsi512_ps(_mm512_mask_xor_epi32(i, m, i, _mm512_set1_epi32((int)0x80000000)));
+		}
+		static F copySign(F a, F s)
+		{
+			__m512i sign = _mm512_set1_epi32((int)0x80000000);
+			return _mm512_castsi512_ps(_mm512_or_si512(_mm512_andnot_si512(sign, _mm512_castps_si512(a)),
+				_mm512_and_si512(sign, _mm512_castps_si512(s))));
+		}
+		static I round(F a)                     { return _mm512_cvtps_epi32(a); }
+		static F toFloat(I i)                   { return _mm512_cvtepi32_ps(i); }
+		static M testBits(I i, int bits)
+		{
+			__m512i b = _mm512_set1_epi32(bits);
+			return _mm512_cmpeq_epi32_mask(_mm512_and_si512(i, b), b);
+		}
+		static I addi(I i, int n)               { return _mm512_add_epi32(i, _mm512_set1_epi32(n)); }
+		static void transpose4(F& a, F& b, F& c, F& d)
+		{
+			__m512 t0 = _mm512_unpacklo_ps(a, b);
+			__m512 t1 = _mm512_unpacklo_ps(c, d);
+			__m512 t2 = _mm512_unpackhi_ps(a, b);
+			__m512 t3 = _mm512_unpackhi_ps(c, d);
+			a = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+			b = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+			c = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+			d = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		}
+		template <int S> static F shuffle(F a, F b)     { return _mm512_shuffle_ps(a, b, S); }
+		static F loadGroups(const float* p, int stride)
+		{
+			__m512 r = _mm512_castps128_ps512(_mm_loadu_ps(p));
+			r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride), 1);
+			r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 2), 2);
+			return _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 3), 3);
+		}
+		static void storeGroups(float* p, int stride, F a)
+		{
+			_mm_storeu_ps(p, _mm512_castps512_ps128(a));
+			_mm_storeu_ps(p + stride, _mm512_extractf32x4_ps(a, 1));
+			_mm_storeu_ps(p + stride * 2, _mm512_extractf32x4_ps(a, 2));
+			_mm_storeu_ps(p + stride * 3, _mm512_extractf32x4_ps(a, 3));
+		}
+		// register j holds the items j, j + 4, j + 8 and j + 12, see Simd8
+		static void load4(const float* p, int stride, F& a, F& b, F& c, F& d)
+		{
+			a = loadGroups(p, stride * 4);
+			b = loadGroups(p + stride, stride * 4);
+			c = loadGroups(p + stride * 2, stride * 4);
+			d = loadGroups(p + stride * 3, stride * 4);
+			transpose4(a, b, c, d);
+		}
+		static void store4(float* p, int stride, F a, F b, F c, F d)
+		{
+			transpose4(a, b, c, d);
+			storeGroups(p, stride * 4, a);
+			storeGroups(p + stride, stride * 4, b);
+			storeGroups(p + stride * 2, stride * 4, c);
+			storeGroups(p + stride * 3, stride * 4, d);
+		}
+		static I truncate(F a)                  { return _mm512_cvttps_epi32(a); }
+		static I andi(I i, int bits)            { return _mm512_and_si512(i, _mm512_set1_epi32(bits)); }
+		static I ori(I a, I b)                  { return _mm512_or_si512(a, b); }
+		template <int N> static I shli(I i)     { return _mm512_slli_epi32(i, N); }
+		template <int N> static I shri(I i)     { return _mm512_srli_epi32(i, N); }
+		static void storei(int* p, I i)         { _mm512_storeu_si512(p, i); }
+	};
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	// widest lanes available in this build, for the batch kernels
+	// SimdBlockLanes is at most 8 lanes, the width of an AoSoA block.
+	///////////////////////////////////////////////////////////////////////////
+#if defined(GIL_AVX512)
+	typedef Simd16 SimdLanes;
+	typedef Simd8 SimdBlockLanes;
+#elif defined(GIL_AVX2)
+	typedef Simd8 SimdLanes;
+	typedef Simd8 SimdBlockLanes;
+#elif defined(GIL_SSE)
+	typedef Simd4 SimdLanes;
+	typedef Simd4 SimdBlockLanes;
+#else
+	typedef Simd1 SimdLanes;
+	typedef Simd1 SimdBlockLanes;
+#endif
+} //end of inline namespace GIL_ISA
+} //end of namespace Gil
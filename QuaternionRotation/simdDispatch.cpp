@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdDispatch.cpp
+// ================
+// CPU feature detection and selection of the batch kernels.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include "simdDispatch.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define GIL_X86 1
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define GIL_X86 1
+#endif
+
+namespace
+{
+#ifdef GIL_X86
+	// r = eax, ebx, ecx, edx of CPUID leaf/subleaf
+	void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int r[4])
+	{
+#ifdef _MSC_VER
+		int regs[4];
+		__cpuidex(regs, (int)leaf, (int)subleaf);
+		for (int i = 0; i < 4; ++i)
+			r[i] = (unsigned int)regs[i];
+#else
+		__cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+	}
+
+	// XCR0, the register states saved by the OS
+	unsigned long long readXcr0()
+	{
+#ifdef _MSC_VER
+		return _xgetbv(0);
+#else
+		unsigned int lo, hi;
+		__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+		return ((unsigned long long)hi << 32) | lo;
+#endif
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	// level forced by GIL_SIMD environment variable, or -1
+	///////////////////////////////////////////////////////////////////////////
+	int getForcedLevel()
+	{
+		char value[16] = "";
+#ifdef _MSC_VER
+		char* env = 0;
+		size_t length = 0;
+		if (_dupenv_s(&env, &length, "GIL_SIMD") == 0 && env)
+		{
+			strncpy_s(value, env, sizeof(value) - 1);
+			free(env);
+		}
+#else
+		const char* env = getenv("GIL_SIMD");
+		if (env)
+			strncpy(value, env, sizeof(value) - 1);
+#endif
+		for (int level = Gil::SIMD_SCALAR; level <= Gil::SIMD_AVX512; ++level)
+		{
+			if (strcmp(value, Gil::getSimdLevelName((Gil::SimdLevel)level)) == 0)
+				return level;
+		}
+		return -1;
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// detected level, lowered by GIL_SIMD
+	///////////////////////////////////////////////////////////////////////////
+	const Gil::KernelTable& selectKernels()
+	{
+		Gil::SimdLevel level = Gil::detectSimdLevel();
+		int forced = getForcedLevel();
+		if (forced >= 0 && forced < level)
+			level = (Gil::SimdLevel)forced;
+		return *Gil::getKernels(level);
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// highest level supported by the CPU and enabled by the OS
+// AVX needs the OS to save YMM registers (XCR0 bits 1, 2), and AVX-512 also
+// the opmask and ZMM registers (bits 5, 6, 7).
+///////////////////////////////////////////////////////////////////////////////
+Gil::SimdLevel Gil::detectSimdLevel()
+{
+#ifdef GIL_X86
+	unsigned int r[4];
+	cpuid(0, 0, r);
+	unsigned int maxLeaf = r[0];
+
+	cpuid(1, 0, r);
+	bool sse2 = (r[3] & (1u << 26)) != 0;
+	bool fma = (r[2] & (1u << 12)) != 0;
+	bool osxsave = (r[2] & (1u << 27)) != 0;
+	bool avx = (r[2] & (1u << 28)) != 0;
+	bool f16c = (r[2] & (1u << 29)) != 0;
+	if (!sse2)
+		return SIMD_SCALAR;
+	if (!osxsave || !avx || !fma || !f16c || maxLeaf < 7)
+		return SIMD_SSE2;
+
+	unsigned long long xcr0 = readXcr0();
+	if ((xcr0 & 0x6) != 0x6)
+		return SIMD_SSE2;
+
+	cpuid(7, 0, r);
+	bool avx2 = (r[1] & (1u << 5)) != 0;
+	bool avx512f = (r[1] & (1u << 16)) != 0;
+	if (!avx2)
+		return SIMD_SSE2;
+	if (!avx512f || (xcr0 & 0xe6) != 0xe6)
+		return SIMD_AVX2;
+	return SIMD_AVX512;
+#else
+	return SIMD_SCALAR;
+#endif
+}
+
+const char* Gil::getSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SIMD_SSE2:     return "sse2";
+	case SIMD_AVX2:     return "avx2";
+	case SIMD_AVX512:   return "avx512";
+	default:            return "scalar";
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// kernels of the best level, selected once at the first call
+///////////////////////////////////////////////////////////////////////////////
+const Gil::KernelTable& Gil::getKernels()
+{
+	static const KernelTable& table = selectKernels();
+	return table;
+}
+
+const Gil::KernelTable* Gil::getKernels(SimdLevel level)
+{
+	static const SimdLevel supported = detectSimdLevel();
+	if (level > supported)
+		return 0;
+
+	switch (level)
+	{
+	case SIMD_SSE2:     return &getSse2Kernels();
+	case SIMD_AVX2:     return &getAvx2Kernels();
+	case SIMD_AVX512:   return &getAvx512Kernels();
+	default:            return &getScalarKernels();
+	}
+}
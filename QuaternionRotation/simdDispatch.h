@@ -0,0 +1,116 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// simdDispatch.h
+// ==============
+// Run-time selection of the batch kernels by the instruction set of the CPU.
+// The kernels are compiled once for each level (simdKernels*.cpp) and the
+// table of the best level is chosen at the first call of getKernels(), so
+// one executable runs with SSE2 on any x64 CPU and with AVX2+FMA or AVX-512
+// where they are available.
+//
+// Set the environment variable GIL_SIMD to scalar, sse2, avx2 or avx512 to
+// force a lower level, e.g. to compare the results or the timings. A level
+// above the CPU is ignored.
+//
+// The kernels work on float arrays only and are called by the batch
+// functions of mathBatch.h, blockArray.h and Matrix4, so the callers do not
+// use this table directly; an indirect call per array is negligible.
+// Single element operations (Vector3::Normalize(), Quaternion * Quaternion)
+// are inlined and stay on the instruction set of the build, and so does
+// Matrix4::decompose() of arrays; each matrix takes its own branches
+// (reflection, shear, the largest term of the quaternion), which lanes would
+// all have to run.
+//
+// NOTE: on MSVC, the AVX2 and AVX-512 kernel files are compiled with their
+// own /arch option (see the project file), and the rest of the project must
+// stay on the default SSE2.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+namespace Gil
+{
+	// instruction set levels, each level includes the lower ones
+	enum SimdLevel
+	{
+		SIMD_SCALAR = 0,        // 1 lane, reference
+		SIMD_SSE2,              // 4 lanes
+		SIMD_AVX2,              // 8 lanes, AVX2 + FMA + F16C
+		SIMD_AVX512             // 16 lanes, AVX-512F
+	};
+
+	///////////////////////////////////////////////////////////////////////////
+	// batch kernels of one level
+	// Vectors and quaternions are SoA streams (in[0] = x[], ...; quaternions
+	// are s[], x[], y[], z[]), or AoSoA blocks of 8 (*Blocks, count is the
+	// number of blocks), or AoS arrays of quaternions (4 floats) and matrices.
+	// Matrices are column-major. The outputs may be the same as the inputs.
+	///////////////////////////////////////////////////////////////////////////
+	struct KernelTable
+	{
+		SimdLevel level;
+
+		// trigonometric functions of fastMath.h
+		void (*sinCos)(const float* angles, float* sines, float* cosines, int count);
+		void (*arcCosine)(const float* values, float* angles, int count);
+		void (*arcTangent2)(const float* ys, const float* xs, float* angles, int count);
+
+		// SoA streams
+		void (*transformPoints)(const float* m, const float* const in[3], float* const out[3], int count);
+		void (*rotate)(const float* const quats[4], const float* const vecs[3], float* const out[3], int count);
+		void (*slerp)(const float* const from[4], const float* const to[4], float t, float* const out[4], int count); //no check of opposite quaternions
+		void (*normalize3)(float* const vecs[3], int count);
+		void (*normalize4)(float* const quats[4], int count);
+
+		// AoSoA blocks, same as the SoA streams
+		void (*transformPointBlocks)(const float* m, const float* in, float* out, int blocks);
+		void (*rotateBlocks)(const float* quats, const float* vecs, float* out, int blocks);
+		void (*slerpBlocks)(const float* from, const float* to, float t, float* out, int blocks);
+		void (*normalize3Blocks)(float* vecs, int blocks);
+		void (*normalize4Blocks)(float* quats, int blocks);
+
+		// AoS arrays, out[i] = a[i] * b[i]; stride is the floats between matrices
+		// (16 for packed arrays, sizeof(Matrix4) / sizeof(float) for Matrix4)
+		void (*multiplyQuaternions)(const float* a, const float* b, float* out, int count);
+		void (*multiplyMatrices)(const float* a, const float* b, float* out, int count, int stride);
+
+		// AoS arrays of aligned 3D vectors (x y z 0), out[i] = M * (in[i], w);
+		// w = 1 for points, 0 for directions
+		void (*transformAligned)(const float* m, const float* in, float* out, int count, float w);
+
+		// AoS quaternions, out[i] = a * b[i] (a may be in out) and the running
+		// product out[i] = quats[0] * ... * quats[i]
+		void (*multiplyQuaternionsBy)(const float* a, const float* b, float* out, int count);
+		void (*multiplyQuaternionPrefix)(const float* quats, float* out, int count);
+
+		// AoS matrices; the inverses and their determinants (an inverse with a
+		// (near) 0 determinant is not finite), and the matrices T*R*S of AoS
+		// translations (x y z), quaternions (s x y z) and scales (x y z)
+		void (*invertMatrices)(const float* in, float* out, float* determinants, int count, int stride);
+		void (*composeTRS)(const float* translations, const float* rotations, const float* scales, float* out, int count, int stride);
+
+		// float16 conversion, same as floatToHalf()/halfToFloat() of fastMath.h
+		// (F16C instructions with AVX2 and AVX-512)
+		void (*toHalf)(const float* src, unsigned short* dst, int count);
+		void (*fromHalf)(const unsigned short* src, float* dst, int count);
+
+		// Morton codes of AoS points (x y z), q = (p - min) * scale is clamped to
+		// 10 (30-bit codes) or 21 (63-bit codes) bits per axis, x is the highest
+		void (*mortonCodes30)(const float* points, int count, const float* min, const float* scale, unsigned int* codes);
+		void (*mortonCodes63)(const float* points, int count, const float* min, const float* scale, unsigned long long* codes);
+	};
+
+	SimdLevel detectSimdLevel();                    //highest level of the CPU and OS
+	const char* getSimdLevelName(SimdLevel level);  //"scalar", "sse2", "avx2", "avx512"
+	const KernelTable& getKernels();                //kernels of the selected level, chosen once
+	const KernelTable* getKernels(SimdLevel level); //kernels of the level, 0 if not supported by the CPU
+
+	// tables of each level, defined in simdKernels*.cpp
+	const KernelTable& getScalarKernels();
+	const KernelTable& getSse2Kernels();
+	const KernelTable& getAvx2Kernels();
+	const KernelTable& getAvx512Kernels();
+} //end of namespace Gil
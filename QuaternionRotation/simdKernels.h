@@ -0,0 +1,1034 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// simdKernels.h
+// =============
+// Batch kernels of simdDispatch.h, written once with the lane wrappers of
+// simd.h and compiled by simdKernels*.cpp for each instruction set.
+//
+// Only simdKernels*.cpp include this file, after defining GIL_TARGET_*.
+// Do not include Vectors.h, Matrices.h or other headers with inline
+// functions here; they are outside the inline namespace of the target, and
+// an AVX2 copy of them could replace the SSE2 one at link time.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "simdDispatch.h"
+#include "fastMath.h"
+
+namespace Gil {
+inline namespace GIL_ISA      // see simd.h
+{
+namespace kernels
+{
+	const int BLOCK = 8;            // lanes of AoSoA block, same as BLOCK_WIDTH of blockArray.h
+
+	///////////////////////////////////////////////////////////////////////////
+	// trigonometric functions
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	void sinCos(const float* angles, float* sines, float* cosines, int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+		{
+			typename V::F s, c;
+			trig::sinCos<V>(V::load(angles + i), s, c);
+			V::store(sines + i, s);
+			V::store(cosines + i, c);
+		}
+		for (; i < count; ++i)
+			fastSinCos(angles[i], sines[i], cosines[i]);
+	}
+
+	template <class V>
+	void arcCosine(const float* values, float* angles, int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			V::store(angles + i, trig::acos<V>(V::load(values + i)));
+		for (; i < count; ++i)
+			angles[i] = fastAcos(values[i]);
+	}
+
+	template <class V>
+	void arcTangent2(const float* ys, const float* xs, float* angles, int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			V::store(angles + i, trig::atan2<V>(V::load(ys + i), V::load(xs + i)));
+		for (; i < count; ++i)
+			angles[i] = fastAtan2(ys[i], xs[i]);
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// lanes of V::WIDTH elements from i of SoA streams
+	///////////////////////////////////////////////////////////////////////////
+
+	// p' = M * (p, 1), m is column-major
+	template <class V>
+	inline void transformLanes(const float* m, const float* const in[3], float* const out[3], int i)
+	{
+		typedef typename V::F F;
+		F x = V::load(in[0] + i);
+		F y = V::load(in[1] + i);
+		F z = V::load(in[2] + i);
+		for (int r = 0; r < 3; ++r)
+		{
+			F p = V::fmadd(V::set1(m[r]), x, V::fmadd(V::set1(m[r + 4]), y,
+				V::fmadd(V::set1(m[r + 8]), z, V::set1(m[r + 12]))));
+			V::store(out[r] + i, p);
+		}
+	}
+
+	// v' = q * v * q^-1 for unit quaternion q = (s, u)
+	//   t = 2 * (u x v), v' = v + s*t + u x t
+	template <class V>
+	inline void rotateLanes(const float* const q[4], const float* const in[3], float* const out[3], int i)
+	{
+		typedef typename V::F F;
+		F s = V::load(q[0] + i);
+		F ux = V::load(q[1] + i);
+		F uy = V::load(q[2] + i);
+		F uz = V::load(q[3] + i);
+		F x = V::load(in[0] + i);
+		F y = V::load(in[1] + i);
+		F z = V::load(in[2] + i);
+
+		F two = V::set1(2.0f);
+		F tx = V::mul(two, V::sub(V::mul(uy, z), V::mul(uz, y)));
+		F ty = V::mul(two, V::sub(V::mul(uz, x), V::mul(ux, z)));
+		F tz = V::mul(two, V::sub(V::mul(ux, y), V::mul(uy, x)));
+
+		V::store(out[0] + i, V::add(V::fmadd(s, tx, x), V::sub(V::mul(uy, tz), V::mul(uz, ty))));
+		V::store(out[1] + i, V::add(V::fmadd(s, ty, y), V::sub(V::mul(uz, tx), V::mul(ux, tz))));
+		V::store(out[2] + i, V::add(V::fmadd(s, tz, z), V::sub(V::mul(ux, ty), V::mul(uy, tx))));
+	}
+
+	// slerp with linear alpha, same as Gil::slerp() except the case of
+	// dot ~= -1, which is fixed by the caller (see blockArray.cpp)
+	template <class V>
+	inline void slerpLanes(const float* const from[4], const float* const to[4], float t,
+		float* const out[4], int i)
+	{
+		typedef typename V::F F;
+		F a[4], b[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			a[c] = V::load(from[c] + i);
+			b[c] = V::load(to[c] + i);
+		}
+		F one = V::set1(1.0f);
+		F dot = V::fmadd(a[0], b[0], V::fmadd(a[1], b[1], V::fmadd(a[2], b[2], V::mul(a[3], b[3]))));
+		dot = V::max(V::set1(-1.0f), V::min(one, dot));
+
+		// scale1 = sin((1-t)*angle) / sin(angle), scale2 = sin(t*angle) / sin(angle)
+		F angle = trig::acos<V>(dot);
+		F invSine = V::div(one, V::sqrt(V::max(V::sub(one, V::mul(dot, dot)), V::set1(1e-12f))));
+		F s1, s2, c;
+		trig::sinCos<V>(V::mul(V::set1(1 - t), angle), s1, c);
+		trig::sinCos<V>(V::mul(V::set1(t), angle), s2, c);
+
+		// lerp if 2 quaternions are close
+		typename V::M close = V::lt(V::sub(one, dot), V::set1(0.001f));
+		F scale1 = V::select(close, V::set1(1 - t), V::mul(s1, invSine));
+		F scale2 = V::select(close, V::set1(t), V::mul(s2, invSine));
+
+		for (int c = 0; c < 4; ++c)
+			V::store(out[c] + i, V::fmadd(a[c], scale1, V::mul(b[c], scale2)));
+	}
+
+	template <class V>
+	inline void normalize3Lanes(float* const v[3], int i)
+	{
+		typedef typename V::F F;
+		F x = V::load(v[0] + i);
+		F y = V::load(v[1] + i);
+		F z = V::load(v[2] + i);
+		F d = V::fmadd(x, x, V::fmadd(y, y, V::mul(z, z)));
+
+		// keep the vectors of d < EPSILON, 0 lanes would become 0 * inf = NaN
+		F one = V::set1(1.0f);
+		F inv = V::select(V::lt(d, V::set1(0.00001f)), one, V::div(one, V::sqrt(d)));
+		V::store(v[0] + i, V::mul(x, inv));
+		V::store(v[1] + i, V::mul(y, inv));
+		V::store(v[2] + i, V::mul(z, inv));
+	}
+
+	template <class V>
+	inline void normalize4Lanes(float* const q[4], int i)
+	{
+		typedef typename V::F F;
+		F c[4];
+		for (int k = 0; k < 4; ++k)
+			c[k] = V::load(q[k] + i);
+		F d = V::fmadd(c[0], c[0], V::fmadd(c[1], c[1], V::fmadd(c[2], c[2], V::mul(c[3], c[3]))));
+
+		// keep 1 for the quaternions of d < EPSILON, same as Quaternion::normalize()
+		F one = V::set1(1.0f);
+		F inv = V::select(V::lt(d, V::set1(0.00001f)), one, V::div(one, V::sqrt(d)));
+		for (int k = 0; k < 4; ++k)
+			V::store(q[k] + i, V::mul(c[k], inv));
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// SoA streams, V lanes then 1 lane for the rest
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	void transformPoints(const float* m, const float* const in[3], float* const out[3], int count)
+	{
+		// local copy, so the elements are not reloaded after each store to out
+		float mat[16];
+		for (int k = 0; k < 16; ++k)
+			mat[k] = m[k];
+
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			transformLanes<V>(mat, in, out, i);
+		for (; i < count; ++i)
+			transformLanes<Simd1>(mat, in, out, i);
+	}
+
+	template <class V>
+	void rotate(const float* const quats[4], const float* const vecs[3], float* const out[3], int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			rotateLanes<V>(quats, vecs, out, i);
+		for (; i < count; ++i)
+			rotateLanes<Simd1>(quats, vecs, out, i);
+	}
+
+	template <class V>
+	void slerp(const float* const from[4], const float* const to[4], float t, float* const out[4], int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			slerpLanes<V>(from, to, t, out, i);
+		for (; i < count; ++i)
+			slerpLanes<Simd1>(from, to, t, out, i);
+	}
+
+	template <class V>
+	void normalize3(float* const vecs[3], int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			normalize3Lanes<V>(vecs, i);
+		for (; i < count; ++i)
+			normalize3Lanes<Simd1>(vecs, i);
+	}
+
+	template <class V>
+	void normalize4(float* const quats[4], int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			normalize4Lanes<V>(quats, i);
+		for (; i < count; ++i)
+			normalize4Lanes<Simd1>(quats, i);
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// AoSoA blocks of N components, the lanes of V (<= 8) cover a block
+	///////////////////////////////////////////////////////////////////////////
+	template <int N, class P>
+	struct BlockPointers
+	{
+		P* p[N];
+		BlockPointers(P* blocks, int b)
+		{
+			for (int c = 0; c < N; ++c)
+				p[c] = blocks + (b * N + c) * BLOCK;
+		}
+	};
+
+	template <class V>
+	void transformPointBlocks(const float* m, const float* in, float* out, int blocks)
+	{
+		float mat[16];
+		for (int k = 0; k < 16; ++k)
+			mat[k] = m[k];
+
+		for (int b = 0; b < blocks; ++b)
+		{
+			BlockPointers<3, const float> i(in, b);
+			BlockPointers<3, float> o(out, b);
+			for (int k = 0; k < BLOCK; k += V::WIDTH)
+				transformLanes<V>(mat, i.p, o.p, k);
+		}
+	}
+
+	template <class V>
+	void rotateBlocks(const float* quats, const float* vecs, float* out, int blocks)
+	{
+		for (int b = 0; b < blocks; ++b)
+		{
+			BlockPointers<4, const float> q(quats, b);
+			BlockPointers<3, const float> i(vecs, b);
+			BlockPointers<3, float> o(out, b);
+			for (int k = 0; k < BLOCK; k += V::WIDTH)
+				rotateLanes<V>(q.p, i.p, o.p, k);
+		}
+	}
+
+	template <class V>
+	void slerpBlocks(const float* from, const float* to, float t, float* out, int blocks)
+	{
+		for (int b = 0; b < blocks; ++b)
+		{
+			BlockPointers<4, const float> pa(from, b);
+			BlockPointers<4, const float> pb(to, b);
+			BlockPointers<4, float> o(out, b);
+			for (int k = 0; k < BLOCK; k += V::WIDTH)
+				slerpLanes<V>(pa.p, pb.p, t, o.p, k);
+		}
+	}
+
+	template <class V>
+	void normalize3Blocks(float* vecs, int blocks)
+	{
+		for (int b = 0; b < blocks; ++b)
+		{
+			BlockPointers<3, float> v(vecs, b);
+			for (int k = 0; k < BLOCK; k += V::WIDTH)
+				normalize3Lanes<V>(v.p, k);
+		}
+	}
+
+	template <class V>
+	void normalize4Blocks(float* quats, int blocks)
+	{
+		for (int b = 0; b < blocks; ++b)
+		{
+			BlockPointers<4, float> q(quats, b);
+			for (int k = 0; k < BLOCK; k += V::WIDTH)
+				normalize4Lanes<V>(q.p, k);
+		}
+	}
+
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// products of V::WIDTH quaternions (s, x, y, z) from a and b, r = a * b
+	// The 4 registers of each input are transposed within each 4-float group,
+	// so they hold s, x, y and z of the lanes in the same (permuted) order,
+	// and the transpose back restores the element order.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline void multiplyQuaternion(const typename V::F p[4], const typename V::F q[4], typename V::F r[4])
+	{
+		r[0] = V::sub(V::mul(p[0], q[0]), V::fmadd(p[1], q[1], V::fmadd(p[2], q[2], V::mul(p[3], q[3]))));
+		r[1] = V::fmadd(p[0], q[1], V::fmadd(p[1], q[0], V::sub(V::mul(p[2], q[3]), V::mul(p[3], q[2]))));
+		r[2] = V::fmadd(p[0], q[2], V::fmadd(p[2], q[0], V::sub(V::mul(p[3], q[1]), V::mul(p[1], q[3]))));
+		r[3] = V::fmadd(p[0], q[3], V::fmadd(p[3], q[0], V::sub(V::mul(p[1], q[2]), V::mul(p[2], q[1]))));
+	}
+
+	template <class V>
+	inline void loadTransposed(const float* a, typename V::F p[4])
+	{
+		const int W = V::WIDTH;
+		p[0] = V::load(a);
+		p[1] = V::load(a + W);
+		p[2] = V::load(a + W * 2);
+		p[3] = V::load(a + W * 3);
+		V::transpose4(p[0], p[1], p[2], p[3]);
+	}
+
+	template <class V>
+	inline void storeTransposed(float* a, typename V::F p[4])
+	{
+		const int W = V::WIDTH;
+		V::transpose4(p[0], p[1], p[2], p[3]);
+		V::store(a, p[0]);
+		V::store(a + W, p[1]);
+		V::store(a + W * 2, p[2]);
+		V::store(a + W * 3, p[3]);
+	}
+
+	template <class V>
+	inline void multiplyQuaternionLanes(const float* a, const float* b, float* out)
+	{
+		typename V::F p[4], q[4], r[4];
+		loadTransposed<V>(a, p);
+		loadTransposed<V>(b, q);
+		multiplyQuaternion<V>(p, q, r);
+		storeTransposed<V>(out, r);
+	}
+
+	template <class V>
+	void multiplyQuaternions(const float* a, const float* b, float* out, int count)
+	{
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			multiplyQuaternionLanes<V>(a + i * 4, b + i * 4, out + i * 4);
+		for (; i < count; ++i)
+			multiplyQuaternionLanes<Simd1>(a + i * 4, b + i * 4, out + i * 4);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// same quaternion a for all elements, out[i] = a * b[i]
+	// a is copied first, it may be an element of out.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline void multiplyQuaternionLanesBy(const float* a, const float* b, float* out)
+	{
+		typename V::F p[4] = { V::set1(a[0]), V::set1(a[1]), V::set1(a[2]), V::set1(a[3]) };
+		typename V::F q[4], r[4];
+		loadTransposed<V>(b, q);
+		multiplyQuaternion<V>(p, q, r);
+		storeTransposed<V>(out, r);
+	}
+
+	template <class V>
+	void multiplyQuaternionsBy(const float* a, const float* b, float* out, int count)
+	{
+		const float q[4] = { a[0], a[1], a[2], a[3] };
+		int i = 0;
+		for (; i + V::WIDTH <= count; i += V::WIDTH)
+			multiplyQuaternionLanesBy<V>(q, b + i * 4, out + i * 4);
+		for (; i < count; ++i)
+			multiplyQuaternionLanesBy<Simd1>(q, b + i * 4, out + i * 4);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// running product, out[i] = quats[0] * quats[1] * ... * quats[i]
+	// A single chain is limited by the latency of each product, so the array
+	// is split into V::WIDTH segments and the chains run in the lanes at once;
+	//   1. out[i] = running product within its own segment
+	//   2. carry of segment k = product of the last elements of segments 0..k-1
+	//   3. out[i] = carry * out[i] for segments 1.. (multiplyQuaternionsBy)
+	// Quaternion multiplication is associative, so the result is the same as
+	// the sequential product up to rounding.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	void multiplyQuaternionPrefix(const float* quats, float* out, int count)
+	{
+		typedef typename V::F F;
+		const int size = count / V::WIDTH;     // elements per segment
+		int i = 0;
+		if (size >= 8)
+		{
+			const int stride = size * 4;        // floats between the segments
+			F acc[4];
+			V::load4(quats, stride, acc[0], acc[1], acc[2], acc[3]);
+			V::store4(out, stride, acc[0], acc[1], acc[2], acc[3]);
+			for (int j = 1; j < size; ++j)
+			{
+				F q[4];
+				V::load4(quats + j * 4, stride, q[0], q[1], q[2], q[3]);
+				F p[4] = { acc[0], acc[1], acc[2], acc[3] };
+				multiplyQuaternion<V>(p, q, acc);
+				V::store4(out + j * 4, stride, acc[0], acc[1], acc[2], acc[3]);
+			}
+
+			// apply the carries of the previous segments
+			float carry[4], next[4];
+			const float* last = out + stride - 4;
+			for (int k = 0; k < 4; ++k)
+				carry[k] = last[k];
+			for (int s = 1; s < V::WIDTH; ++s)
+			{
+				float* seg = out + s * stride;
+				multiplyQuaternionLanes<Simd1>(carry, seg + stride - 4, next);
+				multiplyQuaternionsBy<V>(carry, seg, seg, size);
+				for (int k = 0; k < 4; ++k)
+					carry[k] = next[k];
+			}
+			i = size * V::WIDTH;
+		}
+		if (i == 0)
+		{
+			for (int k = 0; k < 4; ++k)
+				out[k] = quats[k];
+			i = 1;
+		}
+		for (; i < count; ++i)
+			multiplyQuaternionLanes<Simd1>(out + (i - 1) * 4, quats + i * 4, out + i * 4);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// 4x4 matrix product, column j of r = sum of column k of a * b[j*4 + k]
+	// AVX2 computes 2 columns per register; a column of a is broadcast to both
+	// halves, and b[j*4 + k] of 2 columns is spread with an in-lane permute.
+	// AVX-512 does the same for 4 columns.
+	// All inputs are loaded before the stores, so out may be a or b.
+	///////////////////////////////////////////////////////////////////////////
+	inline void multiplyMatrix(const float* a, const float* b, float* out)
+	{
+#if defined(GIL_AVX512)
+		__m512 bb = _mm512_loadu_ps(b);
+		__m512 r = _mm512_mul_ps(_mm512_broadcast_f32x4(_mm_loadu_ps(a)), _mm512_permute_ps(bb, 0x00));
+		r = _mm512_fmadd_ps(_mm512_broadcast_f32x4(_mm_loadu_ps(a + 4)), _mm512_permute_ps(bb, 0x55), r);
+		r = _mm512_fmadd_ps(_mm512_broadcast_f32x4(_mm_loadu_ps(a + 8)), _mm512_permute_ps(bb, 0xaa), r);
+		r = _mm512_fmadd_ps(_mm512_broadcast_f32x4(_mm_loadu_ps(a + 12)), _mm512_permute_ps(bb, 0xff), r);
+		_mm512_storeu_ps(out, r);
+#elif defined(GIL_AVX2)
+		__m256 a0 = _mm256_broadcast_ps((const __m128*)a);
+		__m256 a1 = _mm256_broadcast_ps((const __m128*)(a + 4));
+		__m256 a2 = _mm256_broadcast_ps((const __m128*)(a + 8));
+		__m256 a3 = _mm256_broadcast_ps((const __m128*)(a + 12));
+		__m256 b01 = _mm256_loadu_ps(b);
+		__m256 b23 = _mm256_loadu_ps(b + 8);
+		__m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+		__m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+		r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+		r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+		r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xaa), r01);
+		r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xaa), r23);
+		r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xff), r01);
+		r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xff), r23);
+		_mm256_storeu_ps(out, r01);
+		_mm256_storeu_ps(out + 8, r23);
+#elif defined(GIL_SSE)
+		__m128 a0 = _mm_loadu_ps(a);
+		__m128 a1 = _mm_loadu_ps(a + 4);
+		__m128 a2 = _mm_loadu_ps(a + 8);
+		__m128 a3 = _mm_loadu_ps(a + 12);
+		__m128 r[4];
+		for (int j = 0; j < 4; ++j)
+		{
+			__m128 c = _mm_loadu_ps(b + j * 4);
+			r[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0))),
+				_mm_mul_ps(a1, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)))),
+				_mm_add_ps(_mm_mul_ps(a2, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2))),
+				_mm_mul_ps(a3, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 3, 3)))));
+		}
+		for (int j = 0; j < 4; ++j)
+			_mm_storeu_ps(out + j * 4, r[j]);
+#else
+		float r[16];
+		for (int j = 0; j < 4; ++j)
+		{
+			for (int i = 0; i < 4; ++i)
+				r[j * 4 + i] = a[i] * b[j * 4] + a[i + 4] * b[j * 4 + 1] + a[i + 8] * b[j * 4 + 2] + a[i + 12] * b[j * 4 + 3];
+		}
+		for (int k = 0; k < 16; ++k)
+			out[k] = r[k];
+#endif
+	}
+
+	inline void multiplyMatrices(const float* a, const float* b, float* out, int count, int stride)
+	{
+		for (int i = 0; i < count; ++i)
+			multiplyMatrix(a + i * stride, b + i * stride, out + i * stride);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// inverses of V::WIDTH matrices, one matrix per lane, the scalar kernel
+	// The columns are moved to the lanes with load4(), and the cofactors are
+	// the ones of the scalar invertMatrix4() of Matrices.cpp; 12 2x2
+	// sub-determinants of the first and the last 2 columns are shared by the
+	// determinant and all 16 cofactors. The inverse of a lane with a (near) 0
+	// determinant is not finite; the caller replaces it.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline typename V::F cofactor(typename V::F a, typename V::F x, typename V::F b, typename V::F y,
+		typename V::F c, typename V::F z)
+	{
+		return V::fmadd(c, z, V::sub(V::mul(a, x), V::mul(b, y)));     // a*x - b*y + c*z
+	}
+
+	template <class V>
+	inline void invertMatrixLanes(const float* in, float* out, float* determinants, int stride)
+	{
+		typedef typename V::F F;
+		F m[16];
+		for (int j = 0; j < 16; j += 4)
+			V::load4(in + j, stride, m[j], m[j + 1], m[j + 2], m[j + 3]);
+
+		F s0 = V::sub(V::mul(m[0], m[5]), V::mul(m[4], m[1]));
+		F s1 = V::sub(V::mul(m[0], m[6]), V::mul(m[4], m[2]));
+		F s2 = V::sub(V::mul(m[0], m[7]), V::mul(m[4], m[3]));
+		F s3 = V::sub(V::mul(m[1], m[6]), V::mul(m[5], m[2]));
+		F s4 = V::sub(V::mul(m[1], m[7]), V::mul(m[5], m[3]));
+		F s5 = V::sub(V::mul(m[2], m[7]), V::mul(m[6], m[3]));
+
+		F c5 = V::sub(V::mul(m[10], m[15]), V::mul(m[14], m[11]));
+		F c4 = V::sub(V::mul(m[9], m[15]), V::mul(m[13], m[11]));
+		F c3 = V::sub(V::mul(m[9], m[14]), V::mul(m[13], m[10]));
+		F c2 = V::sub(V::mul(m[8], m[15]), V::mul(m[12], m[11]));
+		F c1 = V::sub(V::mul(m[8], m[14]), V::mul(m[12], m[10]));
+		F c0 = V::sub(V::mul(m[8], m[13]), V::mul(m[12], m[9]));
+
+		F det = V::add(V::sub(V::add(V::sub(V::mul(s0, c5), V::mul(s1, c4)), V::mul(s2, c3)), V::mul(s4, c1)),
+			V::add(V::mul(s3, c2), V::mul(s5, c0)));
+		V::store(determinants, det);
+		F invDet = V::div(V::set1(1.0f), det);
+		F nInvDet = V::sub(V::set1(0.0f), invDet);
+
+		F r0 = V::mul(cofactor<V>(m[5], c5, m[6], c4, m[7], c3), invDet);
+		F r1 = V::mul(cofactor<V>(m[1], c5, m[2], c4, m[3], c3), nInvDet);
+		F r2 = V::mul(cofactor<V>(m[13], s5, m[14], s4, m[15], s3), invDet);
+		F r3 = V::mul(cofactor<V>(m[9], s5, m[10], s4, m[11], s3), nInvDet);
+		V::store4(out, stride, r0, r1, r2, r3);
+
+		r0 = V::mul(cofactor<V>(m[4], c5, m[6], c2, m[7], c1), nInvDet);
+		r1 = V::mul(cofactor<V>(m[0], c5, m[2], c2, m[3], c1), invDet);
+		r2 = V::mul(cofactor<V>(m[12], s5, m[14], s2, m[15], s1), nInvDet);
+		r3 = V::mul(cofactor<V>(m[8], s5, m[10], s2, m[11], s1), invDet);
+		V::store4(out + 4, stride, r0, r1, r2, r3);
+
+		r0 = V::mul(cofactor<V>(m[4], c4, m[5], c2, m[7], c0), invDet);
+		r1 = V::mul(cofactor<V>(m[0], c4, m[1], c2, m[3], c0), nInvDet);
+		r2 = V::mul(cofactor<V>(m[12], s4, m[13], s2, m[15], s0), invDet);
+		r3 = V::mul(cofactor<V>(m[8], s4, m[9], s2, m[11], s0), nInvDet);
+		V::store4(out + 8, stride, r0, r1, r2, r3);
+
+		r0 = V::mul(cofactor<V>(m[4], c3, m[5], c1, m[6], c0), nInvDet);
+		r1 = V::mul(cofactor<V>(m[0], c3, m[1], c1, m[2], c0), invDet);
+		r2 = V::mul(cofactor<V>(m[12], s3, m[13], s1, m[14], s0), nInvDet);
+		r3 = V::mul(cofactor<V>(m[8], s3, m[9], s1, m[10], s0), invDet);
+		V::store4(out + 12, stride, r0, r1, r2, r3);
+	}
+
+#ifdef GIL_SSE
+	///////////////////////////////////////////////////////////////////////////
+	// products of 2x2 matrices packed in each 4-float group as (a0 a1 a2 a3),
+	// used by the block inverse below. A# is the adjugate of A, A*A# = |A|*I.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline typename V::F mul2x2(typename V::F a, typename V::F b)         // A * B
+	{
+		return V::add(V::mul(a, V::template shuffle<_MM_SHUFFLE(3, 0, 3, 0)>(b, b)),
+			V::mul(V::template shuffle<_MM_SHUFFLE(2, 3, 0, 1)>(a, a), V::template shuffle<_MM_SHUFFLE(1, 2, 1, 2)>(b, b)));
+	}
+
+	template <class V>
+	inline typename V::F adjMul2x2(typename V::F a, typename V::F b)      // A# * B
+	{
+		return V::sub(V::mul(V::template shuffle<_MM_SHUFFLE(0, 0, 3, 3)>(a, a), b),
+			V::mul(V::template shuffle<_MM_SHUFFLE(2, 2, 1, 1)>(a, a), V::template shuffle<_MM_SHUFFLE(1, 0, 3, 2)>(b, b)));
+	}
+
+	template <class V>
+	inline typename V::F mulAdj2x2(typename V::F a, typename V::F b)      // A * B#
+	{
+		return V::sub(V::mul(a, V::template shuffle<_MM_SHUFFLE(0, 3, 0, 3)>(b, b)),
+			V::mul(V::template shuffle<_MM_SHUFFLE(2, 3, 0, 1)>(a, a), V::template shuffle<_MM_SHUFFLE(1, 2, 1, 2)>(b, b)));
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// inverses of V::WIDTH / 4 matrices, one matrix per 4-float group
+	// Same block inverse as the SSE invertMatrix4() of Matrices.cpp; all
+	// shuffles stay within the groups, so AVX2 inverts 2 matrices at once and
+	// AVX-512 4. The 16 floats are the rows of the transposed matrix, which
+	// does not matter because (M^T)^-1 = (M^-1)^T.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline void invertMatrixGroups(const float* in, float* out, float* determinants, int stride)
+	{
+		typedef typename V::F F;
+		static const float SIGNS[16] = { 1, -1, -1, 1, 1, -1, -1, 1, 1, -1, -1, 1, 1, -1, -1, 1 };
+
+		F r0 = V::loadGroups(in, stride);
+		F r1 = V::loadGroups(in + 4, stride);
+		F r2 = V::loadGroups(in + 8, stride);
+		F r3 = V::loadGroups(in + 12, stride);
+
+		// 2x2 blocks
+		F a = V::template shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(r0, r1);
+		F b = V::template shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(r0, r1);
+		F c = V::template shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(r2, r3);
+		F d = V::template shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(r2, r3);
+
+		// determinants of the blocks (|A| |B| |C| |D|)
+		F detSub = V::sub(
+			V::mul(V::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(r0, r2), V::template shuffle<_MM_SHUFFLE(3, 1, 3, 1)>(r1, r3)),
+			V::mul(V::template shuffle<_MM_SHUFFLE(3, 1, 3, 1)>(r0, r2), V::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(r1, r3)));
+		F detA = V::template shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(detSub, detSub);
+		F detB = V::template shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(detSub, detSub);
+		F detC = V::template shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(detSub, detSub);
+		F detD = V::template shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(detSub, detSub);
+
+		F dc = adjMul2x2<V>(d, c);      // D#C
+		F ab = adjMul2x2<V>(a, b);      // A#B
+
+		// tr((A#B)(D#C)), summed within the groups
+		F tr = V::mul(ab, V::template shuffle<_MM_SHUFFLE(3, 1, 2, 0)>(dc, dc));
+		tr = V::add(tr, V::template shuffle<_MM_SHUFFLE(2, 3, 0, 1)>(tr, tr));
+		tr = V::add(tr, V::template shuffle<_MM_SHUFFLE(1, 0, 3, 2)>(tr, tr));
+		F det = V::sub(V::add(V::mul(detA, detD), V::mul(detB, detC)), tr);
+
+		float dets[V::WIDTH];
+		V::store(dets, det);
+		for (int g = 0; g < V::WIDTH / 4; ++g)
+			determinants[g] = dets[g * 4];
+
+		F x = V::sub(V::mul(detD, a), mul2x2<V>(b, dc));
+		F w = V::sub(V::mul(detA, d), mul2x2<V>(c, ab));
+		F y = V::sub(V::mul(detB, c), mulAdj2x2<V>(d, ab));
+		F z = V::sub(V::mul(detC, b), mulAdj2x2<V>(a, dc));
+
+		// (1/|M|, -1/|M|, -1/|M|, 1/|M|) applies the signs of the adjugates
+		F invDet = V::div(V::load(SIGNS), det);
+		x = V::mul(x, invDet);
+		y = V::mul(y, invDet);
+		z = V::mul(z, invDet);
+		w = V::mul(w, invDet);
+
+		// adjugate shuffle and block assembly at once
+		V::storeGroups(out, stride, V::template shuffle<_MM_SHUFFLE(1, 3, 1, 3)>(x, y));
+		V::storeGroups(out + 4, stride, V::template shuffle<_MM_SHUFFLE(0, 2, 0, 2)>(x, y));
+		V::storeGroups(out + 8, stride, V::template shuffle<_MM_SHUFFLE(1, 3, 1, 3)>(z, w));
+		V::storeGroups(out + 12, stride, V::template shuffle<_MM_SHUFFLE(0, 2, 0, 2)>(z, w));
+	}
+#endif
+
+	inline void invertMatrices(const float* in, float* out, float* determinants, int count, int stride)
+	{
+		int i = 0;
+#ifdef GIL_SSE
+		const int N = SimdLanes::WIDTH / 4;     // matrices per register
+		for (; i + N <= count; i += N)
+			invertMatrixGroups<SimdLanes>(in + i * stride, out + i * stride, determinants + i, stride);
+		for (; i < count; ++i)
+			invertMatrixGroups<Simd4>(in + i * stride, out + i * stride, determinants + i, stride);
+#endif
+		for (; i < count; ++i)
+			invertMatrixLanes<Simd1>(in + i * stride, out + i * stride, determinants + i, stride);
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// M = T*R*S of V::WIDTH elements, same terms as composeTRS() of
+	// Matrices.cpp. The elements are moved to the lanes with load4(), and each
+	// column of the lanes is stored to its matrix with store4(); stride is the
+	// floats between matrices.
+	// load4() of a 3-float translation or scale reads 1 float after it, so
+	// the last element is always left to the 1-lane kernel, with copies.
+	///////////////////////////////////////////////////////////////////////////
+	template <class V>
+	inline void composeTRSLanes(const float* translations, const float* rotations, const float* scales, float* out, int stride)
+	{
+		typedef typename V::F F;
+		F tx, ty, tz, sx, sy, sz, unused;
+		V::load4(translations, 3, tx, ty, tz, unused);
+		V::load4(scales, 3, sx, sy, sz, unused);
+		F s, x, y, z;
+		V::load4(rotations, 4, s, x, y, z);
+
+		F x2 = V::add(x, x), y2 = V::add(y, y), z2 = V::add(z, z);
+		F xx2 = V::mul(x, x2), xy2 = V::mul(x, y2), xz2 = V::mul(x, z2);
+		F yy2 = V::mul(y, y2), yz2 = V::mul(y, z2), zz2 = V::mul(z, z2);
+		F sx2 = V::mul(s, x2), sy2 = V::mul(s, y2), sz2 = V::mul(s, z2);
+		F one = V::set1(1.0f), zero = V::set1(0.0f);
+
+		V::store4(out, stride, V::mul(V::sub(one, V::add(yy2, zz2)), sx), V::mul(V::add(xy2, sz2), sx),
+			V::mul(V::sub(xz2, sy2), sx), zero);
+		V::store4(out + 4, stride, V::mul(V::sub(xy2, sz2), sy), V::mul(V::sub(one, V::add(xx2, zz2)), sy),
+			V::mul(V::add(yz2, sx2), sy), zero);
+		V::store4(out + 8, stride, V::mul(V::add(xz2, sy2), sz), V::mul(V::sub(yz2, sx2), sz),
+			V::mul(V::sub(one, V::add(xx2, yy2)), sz), zero);
+		V::store4(out + 12, stride, tx, ty, tz, one);
+	}
+
+	template <class V>
+	void composeTRS(const float* translations, const float* rotations, const float* scales, float* out, int count, int stride)
+	{
+		int i = 0;
+		for (; i + V::WIDTH < count; i += V::WIDTH)
+			composeTRSLanes<V>(translations + i * 3, rotations + i * 4, scales + i * 3, out + i * stride, stride);
+		for (; i < count; ++i)
+		{
+			const float* t = translations + i * 3;
+			const float* s = scales + i * 3;
+			float t4[4] = { t[0], t[1], t[2], 0 }, s4[4] = { s[0], s[1], s[2], 0 };
+			composeTRSLanes<Simd1>(t4, rotations + i * 4, s4, out + i * stride, stride);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////////////////
+	// M * (p, w) of aligned 3D vectors (x y z 0), w = 1 for points and 0 for
+	// directions; the 4th float of the results is 0.
+	// One vector per 4-float group, so the columns of the matrix are repeated
+	// in the groups and each coordinate is spread within its group; SSE
+	// transforms 1 vector per register, AVX2 2 and AVX-512 4.
+	///////////////////////////////////////////////////////////////////////////
+#ifdef GIL_SSE
+	template <class V>
+	inline void transformAlignedGroups(const typename V::F c[4], const float* in, float* out)
+	{
+		typename V::F p = V::load(in);
+		typename V::F r = V::fmadd(c[0], V::template shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(p, p), c[3]);
+		r = V::fmadd(c[1], V::template shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(p, p), r);
+		r = V::fmadd(c[2], V::template shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(p, p), r);
+		V::store(out, r);
+	}
+#endif
+
+	inline void transformAligned(const float* m, const float* in, float* out, int count, float w)
+	{
+		// columns with 0 in the 4th row, the translation times w
+		float c[16];
+		for (int j = 0; j < 4; ++j)
+		{
+			for (int k = 0; k < 3; ++k)
+				c[j * 4 + k] = j < 3 ? m[j * 4 + k] : m[12 + k] * w;
+			c[j * 4 + 3] = 0;
+		}
+
+		int i = 0;
+#ifdef GIL_SSE
+		const int N = SimdLanes::WIDTH / 4;     // vectors per register
+		SimdLanes::F cols[4];
+		Simd4::F cols4[4];
+		for (int j = 0; j < 4; ++j)
+		{
+			cols[j] = SimdLanes::loadGroups(c + j * 4, 0);
+			cols4[j] = Simd4::load(c + j * 4);
+		}
+		for (; i + N <= count; i += N)
+			transformAlignedGroups<SimdLanes>(cols, in + i * 4, out + i * 4);
+		for (; i < count; ++i)
+			transformAlignedGroups<Simd4>(cols4, in + i * 4, out + i * 4);
+#endif
+		for (; i < count; ++i)
+		{
+			const float* p = in + i * 4;
+			float r[4];
+			for (int k = 0; k < 4; ++k)
+				r[k] = c[k] * p[0] + c[4 + k] * p[1] + c[8 + k] * p[2] + c[12 + k];
+			for (int k = 0; k < 4; ++k)
+				out[i * 4 + k] = r[k];
+		}
+	}
+
+
+
+#if defined(GIL_SSE) && !defined(GIL_AVX2)
+	///////////////////////////////////////////////////////////////////////////
+	// SSE2 float16 conversion of 4 lanes, same steps as floatToHalf() and
+	// halfToFloat() with masks instead of branches; the halves are in the
+	// low 16 bits of the 32-bit lanes (sign extended for toHalf4, so
+	// _mm_packs_epi32 keeps the bits)
+	///////////////////////////////////////////////////////////////////////////
+	inline __m128i toHalf4(__m128 f)
+	{
+		__m128 sign = _mm_and_ps(f, _mm_set1_ps(-0.0f));
+		__m128 absf = _mm_xor_ps(f, sign);
+		__m128i u = _mm_castps_si128(absf);
+
+		// inf or NaN (0x7e00 for NaN)
+		__m128i nanBit = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(absf, absf)), _mm_set1_epi32(0x200));
+		__m128i special = _mm_or_si128(nanBit, _mm_set1_epi32(0x7c00));
+		__m128i regular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), u);
+
+		// subnormal, rounded by adding the magic number
+		const __m128i DENORM_MAGIC = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(DENORM_MAGIC))), DENORM_MAGIC);
+		__m128i isSubnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), u);
+
+		// normal, rebias and round half to even
+		__m128i odd = _mm_srai_epi32(_mm_slli_epi32(u, 31 - 13), 31);  // -1 if odd
+		__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(u, _mm_set1_epi32(0xfff - ((127 - 15) << 23))), odd), 13);
+
+		__m128i h = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+		h = _mm_or_si128(_mm_and_si128(regular, h), _mm_andnot_si128(regular, special));
+		return _mm_or_si128(h, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+	}
+
+	inline __m128 fromHalf4(__m128i h)
+	{
+		__m128i expMant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+		__m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMant), 16);
+
+		// 2^112 rebiases the exponent and renormalizes the subnormals at once
+		__m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMant, 13)),
+			_mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+		__m128i infNan = _mm_and_si128(_mm_cmpgt_epi32(expMant, _mm_set1_epi32(0x7bff)), _mm_set1_epi32(255 << 23));
+		return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNan)));
+	}
+#endif
+
+	///////////////////////////////////////////////////////////////////////////
+	// float16 arrays
+	///////////////////////////////////////////////////////////////////////////
+	inline void toHalf(const float* src, Half* dst, int count)
+	{
+		int i = 0;
+#if defined(GIL_AVX512)
+		for (; i + 16 <= count; i += 16)
+			_mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(GIL_AVX2)
+		for (; i + 8 <= count; i += 8)
+			_mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(GIL_SSE)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i lo = toHalf4(_mm_loadu_ps(src + i));
+			__m128i hi = toHalf4(_mm_loadu_ps(src + i + 4));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = floatToHalf(src[i]);
+	}
+
+	inline void fromHalf(const Half* src, float* dst, int count)
+	{
+		int i = 0;
+#if defined(GIL_AVX512)
+		for (; i + 16 <= count; i += 16)
+			_mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(src + i))));
+#elif defined(GIL_AVX2)
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+#elif defined(GIL_SSE)
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i h = _mm_loadu_si128((const __m128i*)(src + i));
+			_mm_storeu_ps(dst + i, fromHalf4(_mm_unpacklo_epi16(h, zero)));
+			_mm_storeu_ps(dst + i + 4, fromHalf4(_mm_unpackhi_epi16(h, zero)));
+		}
+#endif
+		for (; i < count; ++i)
+			dst[i] = halfToFloat(src[i]);
+	}
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// Morton codes
+	// The points are copied to SoA chunks on the stack, then quantized and
+	// interleaved in the lanes.
+	///////////////////////////////////////////////////////////////////////////
+	const int MORTON_CHUNK = 256;
+
+	// spread the low 11 bits to every 3rd bit, bit k -> bit 3k
+	template <class V>
+	inline typename V::I spreadBits(typename V::I v)
+	{
+		v = V::andi(v, 0x7ff);
+		v = V::andi(V::ori(v, V::template shli<16>(v)), 0x070000ff);
+		v = V::andi(V::ori(v, V::template shli<8>(v)), 0x0700f00f);
+		v = V::andi(V::ori(v, V::template shli<4>(v)), 0x430c30c3);
+		v = V::andi(V::ori(v, V::template shli<2>(v)), 0x49249249);
+		return v;
+	}
+
+	// interleave 10-bit x, y, z to 30 bits, x y z x y z ...
+	template <class V>
+	inline typename V::I interleave3(typename V::I x, typename V::I y, typename V::I z)
+	{
+		return V::ori(V::template shli<2>(spreadBits<V>(x)),
+			V::ori(V::template shli<1>(spreadBits<V>(y)), spreadBits<V>(z)));
+	}
+
+	// (p - min) * scale clamped to [0, maxq], NaN becomes 0
+	template <class V>
+	inline void quantizeLanes(const float* const p[3], const float* min, const float* scale, float maxq,
+		typename V::I q[3], int i)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			typename V::F f = V::mul(V::sub(V::load(p[c] + i), V::set1(min[c])), V::set1(scale[c]));
+			q[c] = V::truncate(V::min(V::max(f, V::set1(0.0f)), V::set1(maxq)));
+		}
+	}
+
+	template <class V>
+	inline void morton30Lanes(const float* const p[3], const float* min, const float* scale, int* codes, int i)
+	{
+		typename V::I q[3];
+		quantizeLanes<V>(p, min, scale, 1023.0f, q, i);
+		V::storei(codes + i, interleave3<V>(q[0], q[1], q[2]));
+	}
+
+	// low 30 bits from the low 10 bits of each axis, and the high 33 bits
+	// from the high 11 bits; the 64-bit merge is scalar
+	template <class V>
+	inline void morton63Lanes(const float* const p[3], const float* min, const float* scale,
+		unsigned long long* codes, int i)
+	{
+		typename V::I q[3];
+		quantizeLanes<V>(p, min, scale, 2097151.0f, q, i);
+		int lo[V::WIDTH], hx[V::WIDTH], hy[V::WIDTH], hz[V::WIDTH];
+		V::storei(lo, interleave3<V>(V::andi(q[0], 0x3ff), V::andi(q[1], 0x3ff), V::andi(q[2], 0x3ff)));
+		V::storei(hx, spreadBits<V>(V::template shri<10>(q[0])));
+		V::storei(hy, spreadBits<V>(V::template shri<10>(q[1])));
+		V::storei(hz, spreadBits<V>(V::template shri<10>(q[2])));
+		for (int k = 0; k < V::WIDTH; ++k)
+		{
+			codes[i + k] = ((unsigned long long)(unsigned int)hx[k] << 32) | ((unsigned long long)(unsigned int)hy[k] << 31)
+				| ((unsigned long long)(unsigned int)hz[k] << 30) | (unsigned int)lo[k];
+		}
+	}
+
+	inline void deinterleave3(const float* src, float* x, float* y, float* z, int n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			x[i] = src[i * 3];
+			y[i] = src[i * 3 + 1];
+			z[i] = src[i * 3 + 2];
+		}
+	}
+
+	template <class V>
+	void mortonCodes30(const float* points, int count, const float* min, const float* scale, unsigned int* codes)
+	{
+		float x[MORTON_CHUNK], y[MORTON_CHUNK], z[MORTON_CHUNK];
+		const float* p[3] = { x, y, z };
+		for (int first = 0; first < count; first += MORTON_CHUNK)
+		{
+			int n = count - first < MORTON_CHUNK ? count - first : MORTON_CHUNK;
+			deinterleave3(points + first * 3, x, y, z, n);
+			int* dst = (int*)codes + first;
+			int i = 0;
+			for (; i + V::WIDTH <= n; i += V::WIDTH)
+				morton30Lanes<V>(p, min, scale, dst, i);
+			for (; i < n; ++i)
+				morton30Lanes<Simd1>(p, min, scale, dst, i);
+		}
+	}
+
+	template <class V>
+	void mortonCodes63(const float* points, int count, const float* min, const float* scale, unsigned long long* codes)
+	{
+		float x[MORTON_CHUNK], y[MORTON_CHUNK], z[MORTON_CHUNK];
+		const float* p[3] = { x, y, z };
+		for (int first = 0; first < count; first += MORTON_CHUNK)
+		{
+			int n = count - first < MORTON_CHUNK ? count - first : MORTON_CHUNK;
+			deinterleave3(points + first * 3, x, y, z, n);
+			unsigned long long* dst = codes + first;
+			int i = 0;
+			for (; i + V::WIDTH <= n; i += V::WIDTH)
+				morton63Lanes<V>(p, min, scale, dst, i);
+			for (; i < n; ++i)
+				morton63Lanes<Simd1>(p, min, scale, dst, i);
+		}
+	}
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// table of the kernels of this target
+	///////////////////////////////////////////////////////////////////////////
+	constexpr KernelTable makeKernelTable(SimdLevel level)
+	{
+		typedef SimdLanes V;
+		typedef SimdBlockLanes B;
+		return KernelTable {
+			level,
+			sinCos<V>, arcCosine<V>, arcTangent2<V>,
+			transformPoints<V>, rotate<V>, slerp<V>, normalize3<V>, normalize4<V>,
+			transformPointBlocks<B>, rotateBlocks<B>, slerpBlocks<B>, normalize3Blocks<B>, normalize4Blocks<B>,
+			multiplyQuaternions<V>, multiplyMatrices,
+			transformAligned, multiplyQuaternionsBy<V>, multiplyQuaternionPrefix<V>,
+			invertMatrices, composeTRS<V>,
+			toHalf, fromHalf,
+			mortonCodes30<V>, mortonCodes63<V>
+		};
+	}
+} //end of namespace kernels
+} //end of inline namespace GIL_ISA
+} //end of namespace Gil
@@ -0,0 +1,21 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdKernelsAvx2.cpp
+// ===================
+// Batch kernels with AVX2 and FMA (8 lanes).
+// MSVC: compiled with /arch:AVX2 (see the project file), only called if the
+// CPU supports it.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#define GIL_TARGET_AVX2
+#include "simdKernels.h"
+
+const Gil::KernelTable& Gil::getAvx2Kernels()
+{
+	static constexpr KernelTable TABLE = kernels::makeKernelTable(SIMD_AVX2);
+	return TABLE;
+}
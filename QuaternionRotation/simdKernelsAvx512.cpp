@@ -0,0 +1,21 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdKernelsAvx512.cpp
+// =====================
+// Batch kernels with AVX-512F (16 lanes; 8 lanes for AoSoA blocks).
+// MSVC: compiled with /arch:AVX512 (see the project file), only called if the
+// CPU supports it.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#define GIL_TARGET_AVX512
+#include "simdKernels.h"
+
+const Gil::KernelTable& Gil::getAvx512Kernels()
+{
+	static constexpr KernelTable TABLE = kernels::makeKernelTable(SIMD_AVX512);
+	return TABLE;
+}
@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdKernelsScalar.cpp
+// =====================
+// Batch kernels without SIMD lanes, the reference of the other levels.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#define GIL_TARGET_SCALAR
+#include "simdKernels.h"
+
+const Gil::KernelTable& Gil::getScalarKernels()
+{
+	static constexpr KernelTable TABLE = kernels::makeKernelTable(SIMD_SCALAR);
+	return TABLE;
+}
@@ -0,0 +1,19 @@
+///////////////////////////////////////////////////////////////////////////////
+// simdKernelsSse2.cpp
+// ===================
+// Batch kernels with SSE2 (4 lanes), the baseline of x64.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#define GIL_TARGET_SSE2
+#include "simdKernels.h"
+
+const Gil::KernelTable& Gil::getSse2Kernels()
+{
+	static constexpr KernelTable TABLE = kernels::makeKernelTable(SIMD_SSE2);
+	return TABLE;
+}
@@ -0,0 +1,230 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformBuilder.cpp
+// ====================
+// Recording, merging and one-pass evaluation of transform chains.
+// The chain is evaluated on a local 3x4 affine accumulator A = [L | t];
+// each step multiplies it from the left, and the Matrix4 is written once.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "transformBuilder.h"
+#include "fastMath.h"
+
+namespace
+{
+	const float DEG2RAD_HALF = Gil::trig::PI / 360.0f;      // half angle for quaternions
+}
+
+
+
+Gil::TransformBuilder& Gil::TransformBuilder::translate(float x, float y, float z)
+{
+	bool merged;
+	Step* step = push(STEP_TRANSLATE, merged);
+	if (merged)
+	{
+		step->v[0] += x;
+		step->v[1] += y;
+		step->v[2] += z;
+	}
+	else
+	{
+		step->v[0] = x;
+		step->v[1] = y;
+		step->v[2] = z;
+	}
+	return *this;
+}
+
+Gil::TransformBuilder& Gil::TransformBuilder::rotate(float angle, float x, float y, float z)
+{
+	return rotate(Quaternion(Vector3(x, y, z), angle * DEG2RAD_HALF));
+}
+
+// unit axes need no normalization
+Gil::TransformBuilder& Gil::TransformBuilder::rotateX(float angle)
+{
+	float sine, cosine;
+	Gil::sinCos(angle * DEG2RAD_HALF, sine, cosine);
+	return rotate(Quaternion(cosine, sine, 0, 0));
+}
+
+Gil::TransformBuilder& Gil::TransformBuilder::rotateY(float angle)
+{
+	float sine, cosine;
+	Gil::sinCos(angle * DEG2RAD_HALF, sine, cosine);
+	return rotate(Quaternion(cosine, 0, sine, 0));
+}
+
+Gil::TransformBuilder& Gil::TransformBuilder::rotateZ(float angle)
+{
+	float sine, cosine;
+	Gil::sinCos(angle * DEG2RAD_HALF, sine, cosine);
+	return rotate(Quaternion(cosine, 0, 0, sine));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// consecutive rotations are merged to q = q_new * q_old
+///////////////////////////////////////////////////////////////////////////////
+Gil::TransformBuilder& Gil::TransformBuilder::rotate(const Quaternion& q)
+{
+	bool merged;
+	Step* step = push(STEP_ROTATE, merged);
+	Quaternion r = q;
+	if (merged)
+		r = q * Quaternion(step->v[0], step->v[1], step->v[2], step->v[3]);
+	step->v[0] = r.s;
+	step->v[1] = r.x;
+	step->v[2] = r.y;
+	step->v[3] = r.z;
+	return *this;
+}
+
+Gil::TransformBuilder& Gil::TransformBuilder::scale(float x, float y, float z)
+{
+	bool merged;
+	Step* step = push(STEP_SCALE, merged);
+	if (merged)
+	{
+		step->v[0] *= x;
+		step->v[1] *= y;
+		step->v[2] *= z;
+	}
+	else
+	{
+		step->v[0] = x;
+		step->v[1] = y;
+		step->v[2] = z;
+	}
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// evaluate the steps on the accumulator and write the matrix once
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 Gil::TransformBuilder::build() const
+{
+	float a[12];
+	for (int i = 0; i < 12; ++i)
+		a[i] = base[i];
+	for (int i = 0; i < stepCount; ++i)
+		applyStep(steps[i], a);
+
+	return Matrix4(a[0], a[1], a[2], 0,
+				   a[3], a[4], a[5], 0,
+				   a[6], a[7], a[8], 0,
+				   a[9], a[10], a[11], 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// m = A * m; m may be projective, so the bottom row of m is used for the
+// translation, as Matrix4::translate() does
+///////////////////////////////////////////////////////////////////////////////
+void Gil::TransformBuilder::apply(Matrix4& m) const
+{
+	if (baseIdentity && stepCount == 0)
+		return;
+
+	float a[12];
+	for (int i = 0; i < 12; ++i)
+		a[i] = base[i];
+	for (int i = 0; i < stepCount; ++i)
+		applyStep(steps[i], a);
+
+	const float* src = m.get();
+	float dst[16];
+	for (int c = 0; c < 4; ++c)
+	{
+		const float* col = src + c * 4;
+		for (int r = 0; r < 3; ++r)
+			dst[c * 4 + r] = a[r] * col[0] + a[3 + r] * col[1] + a[6 + r] * col[2] + a[9 + r] * col[3];
+		dst[c * 4 + 3] = col[3];
+	}
+	m.set(dst);
+}
+
+void Gil::TransformBuilder::clear()
+{
+	for (int i = 0; i < 12; ++i)
+		base[i] = (i % 4 == 0 && i < 9) ? 1.0f : 0.0f;
+	baseIdentity = true;
+	stepCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// return the last step if it has the same kind, so the caller merges into it,
+// otherwise a new step; the steps are folded when the array is full
+///////////////////////////////////////////////////////////////////////////////
+Gil::TransformBuilder::Step* Gil::TransformBuilder::push(StepKind kind, bool& merged)
+{
+	merged = stepCount > 0 && steps[stepCount - 1].kind == kind;
+	if (merged)
+		return &steps[stepCount - 1];
+
+	if (stepCount == MAX_STEPS)
+		fold();
+	Step* step = &steps[stepCount++];
+	step->kind = kind;
+	return step;
+}
+
+void Gil::TransformBuilder::fold()
+{
+	for (int i = 0; i < stepCount; ++i)
+		applyStep(steps[i], base);
+	stepCount = 0;
+	baseIdentity = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// A = Op * A for the accumulator a = [L | t], L is column-major 3x3
+///////////////////////////////////////////////////////////////////////////////
+void Gil::TransformBuilder::applyStep(const Step& step, float a[12])
+{
+	const float* v = step.v;
+	switch (step.kind)
+	{
+	case STEP_TRANSLATE:
+		a[9] += v[0];
+		a[10] += v[1];
+		a[11] += v[2];
+		break;
+
+	case STEP_SCALE:
+		for (int c = 0; c < 4; ++c)
+		{
+			a[c * 3] *= v[0];
+			a[c * 3 + 1] *= v[1];
+			a[c * 3 + 2] *= v[2];
+		}
+		break;
+
+	case STEP_ROTATE:
+	{
+		// rotation matrix of the quaternion, same as Quaternion::getMatrix()
+		float s = v[0], x = v[1], y = v[2], z = v[3];
+		float x2 = x + x, y2 = y + y, z2 = z + z;
+		float xx2 = x * x2, xy2 = x * y2, xz2 = x * z2;
+		float yy2 = y * y2, yz2 = y * z2, zz2 = z * z2;
+		float sx2 = s * x2, sy2 = s * y2, sz2 = s * z2;
+		float r0 = 1 - (yy2 + zz2), r1 = xy2 + sz2,       r2 = xz2 - sy2;
+		float r3 = xy2 - sz2,       r4 = 1 - (xx2 + zz2), r5 = yz2 + sx2;
+		float r6 = xz2 + sy2,       r7 = yz2 - sx2,       r8 = 1 - (xx2 + yy2);
+
+		// rotate each column of L and t
+		for (int c = 0; c < 4; ++c)
+		{
+			float* col = a + c * 3;
+			float c0 = col[0], c1 = col[1], c2 = col[2];
+			col[0] = r0 * c0 + r3 * c1 + r6 * c2;
+			col[1] = r1 * c0 + r4 * c1 + r7 * c2;
+			col[2] = r2 * c0 + r5 * c1 + r8 * c2;
+		}
+		break;
+	}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// transformBuilder.h
+// ==================
+// Builder of an affine Matrix4 from a chain of translate, rotate and scale
+// calls, with the same order and meaning as the member functions of Matrix4
+// (each call multiplies the transform from the left, M = Op * M).
+//
+// Each Matrix4::rotate() or scale() call rewrites 12 elements of the
+// matrix, so a chain of N calls is N passes over the matrix. The builder
+// records the calls instead, merges the adjacent steps of the same kind
+// (rotations into one quaternion, scales into one vector, translations into
+// one vector), and builds the matrix at the end in one pass over a 3x4
+// accumulator.
+//
+// The result is the same as the Matrix4 calls up to float rounding (about
+// 1e-6 for unit rotations); the rotation axes are normalized, while
+// Matrix4::rotate() expects a unit axis.
+// The builder does not allocate; after MAX_STEPS steps that cannot be
+// merged, the steps are folded into the accumulator.
+//
+// usage:
+//   Gil::TransformBuilder b;
+//   b.translate(0, 0, 1).rotateX(30).rotateY(45).rotateZ(10).scale(2);   // 1 rotation step
+//   Matrix4 m = b.build();     // same as Matrix4().translate(0, 0, 1).rotateX(30)...
+//   b.apply(view);             // same calls applied to an existing matrix
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+	class TransformBuilder
+	{
+	public:
+		static const int MAX_STEPS = 16;        // pending steps before folding
+
+		TransformBuilder()                      { clear(); }
+
+		// same as the functions of Matrix4, angles in degree
+		TransformBuilder& translate(float x, float y, float z);
+		TransformBuilder& translate(const Vector3& v)                   { return translate(v.x, v.y, v.z); }
+		TransformBuilder& rotate(float angle, float x, float y, float z);
+		TransformBuilder& rotate(float angle, const Vector3& axis)      { return rotate(angle, axis.x, axis.y, axis.z); }
+		TransformBuilder& rotateX(float angle);
+		TransformBuilder& rotateY(float angle);
+		TransformBuilder& rotateZ(float angle);
+		TransformBuilder& rotate(const Quaternion& q);                  // unit quaternion
+		TransformBuilder& scale(float s)                                { return scale(s, s, s); }
+		TransformBuilder& scale(float x, float y, float z);
+
+		Matrix4     build() const;                  // Op_n * ... * Op_1
+		void        apply(Matrix4& m) const;        // m = Op_n * ... * Op_1 * m
+		void        clear();                        // back to identity
+		int         getStepCount() const            { return stepCount; }   // pending steps after merging
+
+	private:
+		enum StepKind
+		{
+			STEP_TRANSLATE,                         // v = (x, y, z)
+			STEP_ROTATE,                            // v = (s, x, y, z)
+			STEP_SCALE                              // v = (x, y, z)
+		};
+		struct Step
+		{
+			StepKind kind;
+			float v[4];
+		};
+
+		Step*       push(StepKind kind, bool& merged);  // last step if same kind (merged), otherwise a new one
+		void        fold();                         // steps to the accumulator
+		static void applyStep(const Step& step, float a[12]);
+
+		float base[12];                             // folded steps, 3x3 column-major + translation
+		bool baseIdentity;
+		Step steps[MAX_STEPS];
+		int stepCount;
+	};
+} //end of namespace Gil
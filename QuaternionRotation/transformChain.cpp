@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformChain.cpp
+// ==================
+// Tiled application of transform chains with the SoA kernel of the CPU.
+// AoS points are copied per tile to SoA scratch streams, transformed in
+// place by each step and copied back, so the scratch stays in cache.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <vector>
+#include "transformChain.h"
+#include "simdDispatch.h"
+#include "Timer.h"
+#include "profiler.h"
+
+namespace
+{
+	const int MIN_TILE_SIZE = 64;               // points
+	const int MAX_TILE_SIZE = 32768;
+	const int TUNE_POINTS = 1 << 18;            // larger than L2, 3 MB of points
+	const int TUNE_STEPS = 4;
+	const int TUNE_RUNS = 3;
+
+	std::atomic<int> tileSize(0);               // 0 until measured or set
+
+	// matrices packed to 16 floats each (Matrix4 has the transpose after m)
+	void packMatrices(const Matrix4* matrices, int steps, std::vector<float>& packed)
+	{
+		packed.resize(steps * 16);
+		for (int s = 0; s < steps; ++s)
+		{
+			const float* m = matrices[s].get();
+			for (int k = 0; k < 16; ++k)
+				packed[s * 16 + k] = m[k];
+		}
+	}
+
+	// all steps over one tile, the first from in to out, the rest in place
+	void transformTile(const Gil::KernelTable& kernels, const float* packed, int steps,
+		const float* const in[3], float* const out[3], int count)
+	{
+		kernels.transformPoints(packed, in, out, count);
+		for (int s = 1; s < steps; ++s)
+			kernels.transformPoints(packed + s * 16, out, out, count);
+	}
+
+	void transformSoA(const float* packed, int steps, const float* const in[3], float* const out[3], int count, int tile)
+	{
+		const Gil::KernelTable& kernels = Gil::getKernels();
+		for (int first = 0; first < count; first += tile)
+		{
+			int n = count - first < tile ? count - first : tile;
+			const float* tileIn[3] = { in[0] + first, in[1] + first, in[2] + first };
+			float* tileOut[3] = { out[0] + first, out[1] + first, out[2] + first };
+			transformTile(kernels, packed, steps, tileIn, tileOut, n);
+		}
+	}
+
+	void transformAoS(const float* packed, int steps, const Vector3* in, Vector3* out, int count, int tile)
+	{
+		const Gil::KernelTable& kernels = Gil::getKernels();
+		std::vector<float> scratch(tile * 3);
+		float* s[3] = { &scratch[0], &scratch[tile], &scratch[tile * 2] };
+		for (int first = 0; first < count; first += tile)
+		{
+			int n = count - first < tile ? count - first : tile;
+			const Vector3* src = in + first;
+			for (int i = 0; i < n; ++i)
+			{
+				s[0][i] = src[i].x;
+				s[1][i] = src[i].y;
+				s[2][i] = src[i].z;
+			}
+			transformTile(kernels, packed, steps, s, s, n);
+			Vector3* dst = out + first;
+			for (int i = 0; i < n; ++i)
+				dst[i].Set(s[0][i], s[1][i], s[2][i]);
+		}
+	}
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// chain of matrices over AoS points
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::transformPointsChain(const Matrix4* matrices, int steps, const Vector3* in, Vector3* out, int count)
+{
+	GIL_PROFILE_ZONE("transformPointsChain");
+	if (steps < 0 || count < 0)
+		return false;
+	if (steps == 0)
+	{
+		if (in != out)
+		{
+			for (int i = 0; i < count; ++i)
+				out[i] = in[i];
+		}
+		return true;
+	}
+
+	std::vector<float> packed;
+	packMatrices(matrices, steps, packed);
+	transformAoS(&packed[0], steps, in, out, count, getChainTileSize());
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// chain of matrices over SoA streams, the tiles are ranges of the streams
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::transformPointsChain(const Matrix4* matrices, int steps, const float* const in[3], float* const out[3], int count)
+{
+	GIL_PROFILE_ZONE("transformPointsChain");
+	if (steps < 0 || count < 0)
+		return false;
+	if (steps == 0)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			if (in[c] != out[c])
+			{
+				for (int i = 0; i < count; ++i)
+					out[c][i] = in[c][i];
+			}
+		}
+		return true;
+	}
+
+	std::vector<float> packed;
+	packMatrices(matrices, steps, packed);
+	transformSoA(&packed[0], steps, in, out, count, getChainTileSize());
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// chain of rotation + translation steps; each step is converted to a matrix,
+// which is exact to float rounding for unit quaternions
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::transformPointsChain(const Quaternion* rotations, const Vector3* translations, int steps,
+	const Vector3* in, Vector3* out, int count)
+{
+	if (steps < 0 || count < 0)
+		return false;
+
+	std::vector<Matrix4> matrices(steps);
+	for (int s = 0; s < steps; ++s)
+		matrices[s] = Matrix4::fromTRS(translations[s], rotations[s], Vector3(1, 1, 1));
+	return transformPointsChain(steps > 0 ? &matrices[0] : 0, steps, in, out, count);
+}
+
+int Gil::getChainTileSize()
+{
+	int size = tileSize.load();
+	if (size == 0)
+	{
+		size = tuneChainTileSize();
+		tileSize = size;
+	}
+	return size;
+}
+
+void Gil::setChainTileSize(int points)
+{
+	if (points > 0 && points < MIN_TILE_SIZE)
+		points = MIN_TILE_SIZE;
+	tileSize = points;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// time a chain of TUNE_STEPS rigid transforms over TUNE_POINTS AoS points
+// with each power-of-2 tile size, and return the fastest
+///////////////////////////////////////////////////////////////////////////////
+int Gil::tuneChainTileSize()
+{
+	std::vector<Vector3> points(TUNE_POINTS);
+	for (int i = 0; i < TUNE_POINTS; ++i)
+		points[i].Set((float)(i % 101), (float)(i % 103), (float)(i % 107));
+	Matrix4 matrices[TUNE_STEPS];
+	for (int s = 0; s < TUNE_STEPS; ++s)
+		matrices[s].rotate(30.0f + s, 1, 2, 3).translate(0.5f, -0.5f, 0.25f);
+	std::vector<float> packed;
+	packMatrices(matrices, TUNE_STEPS, packed);
+
+	Timer timer;
+	int best = MIN_TILE_SIZE;
+	double bestTime = 0;
+	for (int tile = MIN_TILE_SIZE; tile <= MAX_TILE_SIZE; tile *= 2)
+	{
+		for (int run = 0; run < TUNE_RUNS; ++run)
+		{
+			timer.start();
+			transformAoS(&packed[0], TUNE_STEPS, &points[0], &points[0], TUNE_POINTS, tile);
+			timer.stop();
+			double time = timer.getElapsedTimeInMicroSec();
+			if (bestTime == 0 || time < bestTime)
+			{
+				bestTime = time;
+				best = tile;
+			}
+		}
+	}
+	return best;
+}
@@ -0,0 +1,52 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// transformChain.h
+// ================
+// Application of a chain of transforms to large point sets, one step after
+// another, without multiplying the matrices together.
+//
+// Applying K matrices with K calls of a batch transform reads and writes the
+// whole array K times, so large arrays are bound by the memory bandwidth.
+// Multiplying the matrices first is one pass, but the product loses
+// precision when the steps differ much in scale, and it cannot keep the
+// intermediate results exact per step.
+// These functions split the points into tiles that fit in L1/L2 cache, and
+// apply all K steps to a tile before moving to the next, so the memory is
+// read and written once, and each step is the same SoA kernel of the CPU
+// (see simdDispatch.h).
+//
+// The tile size is measured at the first call over a range of sizes, and
+// can be set instead with setChainTileSize().
+//
+// NOTE: the steps are affine; the last row of the matrices is ignored.
+//
+// usage:
+//   Matrix4 steps[3] = { local, skeleton, world };
+//   Gil::transformPointsChain(steps, 3, points, points, count);  // world * skeleton * local * p
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+	// p = M[steps-1] * ... * M[1] * M[0] * p, applied in turn per tile
+	// out may be the same as in; false if steps or count is negative
+	bool transformPointsChain(const Matrix4* matrices, int steps, const Vector3* in, Vector3* out, int count);
+	bool transformPointsChain(const Matrix4* matrices, int steps, const float* const in[3], float* const out[3], int count);
+
+	// p = rotations[k] * p * rotations[k]^-1 + translations[k] for k = 0, 1, ...
+	// the quaternions must be unit length
+	bool transformPointsChain(const Quaternion* rotations, const Vector3* translations, int steps,
+		const Vector3* in, Vector3* out, int count);
+
+	int  getChainTileSize();                    // points per tile, measured at the first call
+	void setChainTileSize(int points);          // fixed tile size, 0 to measure again
+	int  tuneChainTileSize();                   // measure the best tile size of the CPU now
+} //end of namespace Gil
@@ -0,0 +1,353 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformIntern.cpp
+// ===================
+// Hash table from quantized transforms to shared, reference counted matrices.
+// The table holds only the ids, the keys and hashes are in the arrays of the
+// slots; erasing shifts the following entries back, so there are no
+// tombstones and the probe sequences stay short.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "transformIntern.h"
+
+namespace
+{
+	const float MAX_STEPS = 1073741824.0f;      // 2^30, keeps the keys in int range
+	const int MIN_TABLE_SIZE = 64;
+
+	// nearest step, rounded half away from 0 by truncation (no libm call);
+	// the rounding uses the comparison results, not branches on the sign
+	int quantizeValue(float value, float inverseStep)
+	{
+		float steps = value * inverseStep;
+		if (!(steps > -MAX_STEPS))              // also NaN
+			return (int)-MAX_STEPS;
+		if (steps > MAX_STEPS)
+			return (int)MAX_STEPS;
+		int n = (int)steps;
+		float fraction = steps - n;
+		return n + (fraction >= 0.5f) - (fraction <= -0.5f);
+	}
+
+#ifdef GIL_SSE
+	// same as quantizeValue() for 4 values, but the nearest step is rounded
+	// with ties to even, so a value exactly half way may round the other way
+	__m128i quantize4(__m128 values, __m128 inverseSteps)
+	{
+		__m128 steps = _mm_mul_ps(values, inverseSteps);
+		steps = _mm_min_ps(_mm_max_ps(steps, _mm_set1_ps(-MAX_STEPS)), _mm_set1_ps(MAX_STEPS));  // NaN is -MAX_STEPS
+		return _mm_cvtps_epi32(steps);
+	}
+#endif
+
+	// quantized quaternion; q and -q are the same rotation, so the sign is
+	// fixed by the first non-zero component (negated without a branch)
+	void quantizeRotation(const Quaternion& rotation, float inverseStep, int v[4])
+	{
+#ifdef GIL_SSE
+		__m128i q = quantize4(_mm_loadu_ps(&rotation.s), _mm_set1_ps(inverseStep));
+		int nonZero = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(q, _mm_setzero_si128()))) & 0xf;
+		int negative = _mm_movemask_ps(_mm_castsi128_ps(q)) & nonZero & -nonZero;
+		__m128i sign = _mm_set1_epi32(negative ? -1 : 0);
+		_mm_storeu_si128((__m128i*)v, _mm_sub_epi32(_mm_xor_si128(q, sign), sign));
+#else
+		int s = quantizeValue(rotation.s, inverseStep);
+		int x = quantizeValue(rotation.x, inverseStep);
+		int y = quantizeValue(rotation.y, inverseStep);
+		int z = quantizeValue(rotation.z, inverseStep);
+
+		int first = s != 0 ? s : (x != 0 ? x : (y != 0 ? y : z));
+		int sign = first >> 31;                 // -1 if negative, else 0
+		v[0] = (s ^ sign) - sign;
+		v[1] = (x ^ sign) - sign;
+		v[2] = (y ^ sign) - sign;
+		v[3] = (z ^ sign) - sign;
+#endif
+	}
+}
+
+
+
+Gil::TransformInterner::TransformInterner(float positionStep, float rotationStep, float scaleStep)
+	: table(MIN_TABLE_SIZE, -1), positionStep(positionStep), rotationStep(rotationStep), scaleStep(scaleStep),
+	slotCount(0), references(0), lookups(0), hits(0)
+{
+	inverseSteps[0] = 1 / positionStep;
+	inverseSteps[1] = 1 / rotationStep;
+	inverseSteps[2] = 1 / scaleStep;
+}
+
+int Gil::TransformInterner::acquire(const Quaternion& rotation)
+{
+	return acquireKey(quantize(rotation));
+}
+
+int Gil::TransformInterner::acquire(const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	return acquireKey(quantize(translation, rotation, scale));
+}
+
+int Gil::TransformInterner::update(int id, const Quaternion& rotation)
+{
+	return updateKey(id, quantize(rotation));
+}
+
+int Gil::TransformInterner::update(int id, const Vector3& translation, const Quaternion& rotation, const Vector3& scale)
+{
+	return updateKey(id, quantize(translation, rotation, scale));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// find the slot of the quantized transform, or compute the matrix in a new one
+///////////////////////////////////////////////////////////////////////////////
+int Gil::TransformInterner::acquireKey(const Key& key)
+{
+	++lookups;
+	++references;
+	unsigned int hash = hashKey(key);
+	int entry = findEntry(key, hash);
+	if (table[entry] >= 0)
+	{
+		++hits;
+		++refCounts[table[entry]];
+		return table[entry];
+	}
+
+	int id;
+	if (!freeIds.empty())
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+		matrices[id] = buildMatrix(key);
+		keys[id] = key;
+		hashes[id] = hash;
+		refCounts[id] = 1;
+	}
+	else
+	{
+		id = (int)matrices.size();
+		matrices.push_back(buildMatrix(key));
+		keys.push_back(key);
+		hashes.push_back(hash);
+		refCounts.push_back(1);
+	}
+
+	// keep the load factor below 1/2
+	++slotCount;
+	if (slotCount * 2 > (int)table.size())
+	{
+		growTable();
+		entry = findEntry(key, hash);
+	}
+	table[entry] = id;
+	return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// keep id if the quantized value is the same (no hash or probe), otherwise
+// move the reference to the slot of the new value
+///////////////////////////////////////////////////////////////////////////////
+int Gil::TransformInterner::updateKey(int id, const Key& key)
+{
+	if (getRefCount(id) == 0)
+		return acquireKey(key);
+	if (keys[id] == key)
+		return id;
+
+	// acquire first, so a slot shared by both is not freed and rebuilt
+	int newId = acquireKey(key);
+	release(id);
+	return newId;
+}
+
+bool Gil::TransformInterner::addRef(int id)
+{
+	if (getRefCount(id) == 0)
+		return false;
+	++refCounts[id];
+	++references;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// remove a reference, the slot is freed with the last one
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::TransformInterner::release(int id)
+{
+	if (getRefCount(id) == 0)
+		return false;
+	--references;
+	if (--refCounts[id] == 0)
+	{
+		eraseEntry(findEntry(keys[id], hashes[id]));
+		freeIds.push_back(id);
+		--slotCount;
+	}
+	return true;
+}
+
+void Gil::TransformInterner::clear()
+{
+	table.assign(MIN_TABLE_SIZE, -1);
+	matrices.clear();
+	keys.clear();
+	hashes.clear();
+	refCounts.clear();
+	freeIds.clear();
+	slotCount = 0;
+	references = 0;
+}
+
+int Gil::TransformInterner::getRefCount(int id) const
+{
+	if (id < 0 || id >= (int)refCounts.size())
+		return 0;
+	return refCounts[id];
+}
+
+Gil::InternStats Gil::TransformInterner::getStats() const
+{
+	InternStats stats;
+	stats.slots = slotCount;
+	stats.references = references;
+	stats.lookups = lookups;
+	stats.hits = hits;
+	return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// quantize to the grid; the rotation-only key is the 4 quaternion values
+///////////////////////////////////////////////////////////////////////////////
+Gil::TransformInterner::Key Gil::TransformInterner::quantize(const Quaternion& rotation) const
+{
+	Key key;
+	key.size = ROTATION_KEY;
+	quantizeRotation(rotation, inverseSteps[1], key.v);
+	return key;
+}
+
+Gil::TransformInterner::Key Gil::TransformInterner::quantize(const Vector3& translation, const Quaternion& rotation,
+	const Vector3& scale) const
+{
+	Key key;
+	key.size = TRS_KEY;
+	quantizeRotation(rotation, inverseSteps[1], key.v);
+#ifdef GIL_SSE
+	// (tx ty tz sx) and (sy sz)
+	__m128i a = quantize4(_mm_setr_ps(translation.x, translation.y, translation.z, scale.x),
+		_mm_setr_ps(inverseSteps[0], inverseSteps[0], inverseSteps[0], inverseSteps[2]));
+	__m128i b = quantize4(_mm_setr_ps(scale.y, scale.z, 0, 0), _mm_set1_ps(inverseSteps[2]));
+	_mm_storeu_si128((__m128i*)(key.v + 4), a);
+	_mm_storel_epi64((__m128i*)(key.v + 8), b);
+#else
+	key.v[4] = quantizeValue(translation.x, inverseSteps[0]);
+	key.v[5] = quantizeValue(translation.y, inverseSteps[0]);
+	key.v[6] = quantizeValue(translation.z, inverseSteps[0]);
+	key.v[7] = quantizeValue(scale.x, inverseSteps[2]);
+	key.v[8] = quantizeValue(scale.y, inverseSteps[2]);
+	key.v[9] = quantizeValue(scale.z, inverseSteps[2]);
+#endif
+	return key;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// T*R*S of the quantized values, the quaternion is normalized again
+// (T = 0 and S = 1 for a rotation-only key)
+///////////////////////////////////////////////////////////////////////////////
+Matrix4 Gil::TransformInterner::buildMatrix(const Key& key) const
+{
+	Quaternion rotation(key.v[0] * rotationStep, key.v[1] * rotationStep, key.v[2] * rotationStep, key.v[3] * rotationStep);
+	Vector3 translation(0, 0, 0);
+	Vector3 scale(1, 1, 1);
+	if (key.size == TRS_KEY)
+	{
+		translation.Set(key.v[4] * positionStep, key.v[5] * positionStep, key.v[6] * positionStep);
+		scale.Set(key.v[7] * scaleStep, key.v[8] * scaleStep, key.v[9] * scaleStep);
+	}
+	if (rotation.length() > 0)
+		rotation.normalize();
+	else
+		rotation.Set(1, 0, 0, 0);
+	return Matrix4::fromTRS(translation, rotation, scale);
+}
+
+bool Gil::TransformInterner::Key::operator==(const Key& rhs) const
+{
+	if (size != rhs.size)
+		return false;
+	for (int i = 0; i < size; ++i)
+	{
+		if (v[i] != rhs.v[i])
+			return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// multiply-xor of the quantized values, 2 per 64-bit word; a TRS key takes 5
+// dependent multiplies and a rotation key 2, and the size is the seed
+///////////////////////////////////////////////////////////////////////////////
+unsigned int Gil::TransformInterner::hashKey(const Key& key)
+{
+	unsigned long long hash = (unsigned long long)key.size;
+	for (int i = 0; i < key.size; i += 2)
+	{
+		unsigned long long word = (unsigned int)key.v[i] | (unsigned long long)(unsigned int)key.v[i + 1] << 32;
+		hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+	}
+	return (unsigned int)(hash ^ (hash >> 32));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// linear probing from the hash; the key is compared only if the hash matches
+///////////////////////////////////////////////////////////////////////////////
+int Gil::TransformInterner::findEntry(const Key& key, unsigned int hash) const
+{
+	int mask = (int)table.size() - 1;
+	int entry = (int)(hash & mask);
+	while (table[entry] >= 0)
+	{
+		int id = table[entry];
+		if (hashes[id] == hash && keys[id] == key)
+			break;
+		entry = (entry + 1) & mask;
+	}
+	return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// empty the entry and move back the following entries of the cluster that
+// would not be found after the hole
+///////////////////////////////////////////////////////////////////////////////
+void Gil::TransformInterner::eraseEntry(int entry)
+{
+	int mask = (int)table.size() - 1;
+	int hole = entry;
+	for (int i = (hole + 1) & mask; table[i] >= 0; i = (i + 1) & mask)
+	{
+		int home = (int)(hashes[table[i]] & mask);
+		// distance from home to i is larger than from home to the hole
+		if (((i - home) & mask) >= ((i - hole) & mask))
+		{
+			table[hole] = table[i];
+			hole = i;
+		}
+	}
+	table[hole] = -1;
+}
+
+void Gil::TransformInterner::growTable()
+{
+	std::vector<int> old(table.size() * 2, -1);
+	old.swap(table);
+	for (size_t i = 0; i < old.size(); ++i)
+	{
+		int id = old[i];
+		if (id >= 0)
+			table[findEntry(keys[id], hashes[id])] = id;
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// transformIntern.h
+// =================
+// Interning of transform matrices: objects with the same rotation, or the
+// same translation/rotation/scale, share one Matrix4 computed once.
+//
+// The values are quantized to a grid (the steps of the constructor), and the
+// quantized key is looked up in an open-addressing hash table of the ids. A
+// hit returns the id of the existing slot and adds a reference; a miss
+// computes the matrix from the quantized values and stores it in a new slot.
+// release() removes the reference, and the slot is reused when no object
+// refers to it.
+//
+// The matrix of a slot is built from the quantized values, not the values of
+// the first caller, so it does not depend on the order of acquire() calls.
+// q and -q are the same rotation and share a slot. The rotation-only
+// overloads use a key of the 4 quaternion values; their slots are separate
+// from those of the full transforms.
+//
+// A lookup (quantize, hash, probe) can cost more than building one T*R*S
+// matrix; benchmarkInterning() compares them, with the rotation-only key and
+// update(). The gain is in the memory and bandwidth of the shared matrices
+// (e.g. 256 matrices for 256k instances), and in the work done per distinct
+// matrix, such as the inverse, the normal matrix or the upload. Objects that
+// keep their id and call update() pay for a lookup only when the quantized
+// value changes.
+//
+// NOTE: the default steps are about 0.01 degree and 0.001 unit; values
+// closer than a step are merged. Use smaller steps if objects must not snap.
+//
+// usage:
+//   Gil::TransformInterner interner;
+//   int id = interner.acquire(position, rotation, scale);   // per object
+//   glMultMatrixf(interner.getMatrix(id).get());
+//   id = interner.update(id, position, rotation, scale);    // when it moves
+//   interner.release(id);                                   // when removed
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+	// counters of the interner
+	struct InternStats
+	{
+		int slots;                  // live shared matrices
+		int references;             // live references to them
+		int lookups;                // acquire() calls
+		int hits;                   // acquire() calls that found a slot
+	};
+
+	class TransformInterner
+	{
+	public:
+		// grid of the quantization; translation, quaternion component, scale
+		explicit TransformInterner(float positionStep = 1.0f / 1024, float rotationStep = 1.0f / 16384,
+			float scaleStep = 1.0f / 1024);
+
+		int         acquire(const Quaternion& rotation);    //rotation only, id of the shared slot
+		int         acquire(const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+		int         update(int id, const Quaternion& rotation); //id if the quantized value is the same, else the new id
+		int         update(int id, const Vector3& translation, const Quaternion& rotation, const Vector3& scale);
+		bool        addRef(int id);                         //false if id is not live
+		bool        release(int id);                        //false if id is not live
+		void        clear();                                //release all, the ids become invalid
+
+		const Matrix4& getMatrix(int id) const              { return matrices[id]; }   //id must be live
+		int         getRefCount(int id) const;              //0 if id is not live
+		InternStats getStats() const;
+
+	private:
+		// quantized rotation (first non-zero component > 0) in v[0..3], then
+		// the translation and scale of a TRS key
+		static const int ROTATION_KEY = 4;
+		static const int TRS_KEY = 10;
+		struct Key
+		{
+			int v[TRS_KEY];
+			int size;                                       // ROTATION_KEY or TRS_KEY values
+			bool operator==(const Key& rhs) const;
+		};
+
+		Key         quantize(const Quaternion& rotation) const;
+		Key         quantize(const Vector3& translation, const Quaternion& rotation, const Vector3& scale) const;
+		Matrix4     buildMatrix(const Key& key) const;
+		int         acquireKey(const Key& key);
+		int         updateKey(int id, const Key& key);
+		static unsigned int hashKey(const Key& key);
+		int         findEntry(const Key& key, unsigned int hash) const;    //entry of the key or the empty entry to insert
+		void        eraseEntry(int entry);
+		void        growTable();
+
+		std::vector<int> table;                             // ids by hash, linear probing, -1 is empty
+		std::vector<Matrix4> matrices;
+		std::vector<Key> keys;
+		std::vector<unsigned int> hashes;
+		std::vector<int> refCounts;
+		std::vector<int> freeIds;
+		float positionStep;
+		float rotationStep;
+		float scaleStep;
+		float inverseSteps[3];                              // 1 / steps for quantize()
+		int slotCount;
+		int references;
+		int lookups;
+		int hits;
+	};
+} //end of namespace Gil
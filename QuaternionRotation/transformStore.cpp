@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformStore.cpp
+// ==================
+// Dense transform arrays with swap-remove and generational handles.
+// The free slots are linked through Slot::index, so create() and destroy()
+// are O(1) and allocate only when the arrays grow.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include "transformStore.h"
+#include "profiler.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// add an object at the end of the arrays, in a free slot if any
+///////////////////////////////////////////////////////////////////////////////
+Gil::TransformHandle Gil::TransformStore::create(const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+{
+	int slot = freeSlot;
+	if (slot >= 0)
+	{
+		freeSlot = slots[slot].index;
+	}
+	else
+	{
+		slot = (int)slots.size();
+		Slot s = { 0, 1 };
+		slots.push_back(s);
+	}
+
+	int index = size();
+	slots[slot].index = index;
+	TransformHandle h((unsigned int)slot, slots[slot].generation);
+	positionArray.push_back(position);
+	rotationArray.push_back(rotation);
+	scaleArray.push_back(scale);
+	worldArray.push_back(Matrix4::fromTRS(position, rotation, scale));
+	handleArray.push_back(h);
+	return h;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// move the last object to the place of the destroyed one, and retire the slot
+// with a new generation
+///////////////////////////////////////////////////////////////////////////////
+bool Gil::TransformStore::destroy(TransformHandle h)
+{
+	int index = find(h);
+	if (index < 0)
+		return false;
+
+	int last = size() - 1;
+	if (index != last)
+	{
+		positionArray[index] = positionArray[last];
+		rotationArray[index] = rotationArray[last];
+		scaleArray[index] = scaleArray[last];
+		worldArray[index] = worldArray[last];
+		handleArray[index] = handleArray[last];
+		slots[handleArray[index].slot].index = index;
+	}
+	positionArray.pop_back();
+	rotationArray.pop_back();
+	scaleArray.pop_back();
+	worldArray.pop_back();
+	handleArray.pop_back();
+
+	Slot& slot = slots[h.slot];
+	if (++slot.generation == 0)     // skip null generation on wrap-around
+		slot.generation = 1;
+	slot.index = freeSlot;
+	freeSlot = (int)h.slot;
+	return true;
+}
+
+void Gil::TransformStore::clear()
+{
+	while (size() > 0)
+		destroy(handleArray.back());
+}
+
+void Gil::TransformStore::reserve(int count)
+{
+	positionArray.reserve(count);
+	rotationArray.reserve(count);
+	scaleArray.reserve(count);
+	worldArray.reserve(count);
+	handleArray.reserve(count);
+	slots.reserve(count);
+}
+
+int Gil::TransformStore::find(TransformHandle h) const
+{
+	if (h.isNull() || h.slot >= slots.size() || slots[h.slot].generation != h.generation)
+		return -1;
+	return slots[h.slot].index;
+}
+
+bool Gil::TransformStore::setPosition(TransformHandle h, const Vector3& position)
+{
+	int index = find(h);
+	if (index < 0)
+		return false;
+	positionArray[index] = position;
+	return true;
+}
+
+bool Gil::TransformStore::setRotation(TransformHandle h, const Quaternion& rotation)
+{
+	int index = find(h);
+	if (index < 0)
+		return false;
+	rotationArray[index] = rotation;
+	return true;
+}
+
+bool Gil::TransformStore::setScale(TransformHandle h, const Vector3& scale)
+{
+	int index = find(h);
+	if (index < 0)
+		return false;
+	scaleArray[index] = scale;
+	return true;
+}
+
+bool Gil::TransformStore::get(TransformHandle h, Vector3& position, Quaternion& rotation, Vector3& scale) const
+{
+	int index = find(h);
+	if (index < 0)
+		return false;
+	position = positionArray[index];
+	rotation = rotationArray[index];
+	scale = scaleArray[index];
+	return true;
+}
+
+const Matrix4* Gil::TransformStore::getWorldMatrix(TransformHandle h) const
+{
+	int index = find(h);
+	return index < 0 ? 0 : &worldArray[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// recompute the cached world matrices of the range from the dense arrays
+// with the batch Matrix4::fromTRS() (lanes of the CPU)
+///////////////////////////////////////////////////////////////////////////////
+void Gil::TransformStore::updateWorldMatrices(int first, int count)
+{
+	GIL_PROFILE_ZONE("updateWorldMatrices");
+	if (first < 0)
+	{
+		count += first;
+		first = 0;
+	}
+	if (count > size() - first)
+		count = size() - first;
+
+	if (count > 0)
+		Matrix4::fromTRS(&positionArray[first], &rotationArray[first], &scaleArray[first], &worldArray[first], count);
+}
@@ -0,0 +1,112 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// transformStore.h
+// ================
+// Dense store of object transforms (position, rotation, scale and the cached
+// world matrix) in separate contiguous arrays, addressed by generational
+// handles.
+//
+// The arrays have no holes: destroy() moves the last object into the freed
+// place (swap-remove), so the systems loop over 0..size()-1 of the arrays
+// they need, e.g. only rotations() for the animation, and the cost grows
+// linearly with the number of live objects.
+//
+// A handle keeps the slot index and the generation of the slot. The slot
+// maps to the current dense index, and its generation changes when the
+// object is destroyed, so a stale handle is detected instead of pointing to
+// another object that reused the slot.
+//
+// NOTE: the dense index of an object changes by destroy(); keep handles, not
+// indices, across frames. The pointers to the arrays are invalid after
+// create() and destroy().
+//
+// usage:
+//   Gil::TransformStore store;
+//   Gil::TransformHandle h = store.create(Vector3(0, 1, 0));
+//   store.setRotation(h, q);
+//   Quaternion* rotations = store.rotations();         // animate all
+//   for (int i = 0; i < store.size(); ++i) ...
+//   store.updateWorldMatrices();
+//   glMultMatrixf(store.getWorldMatrix(h)->get());
+//   store.destroy(h);
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+	// reference to an object of TransformStore, generation 0 is null
+	struct TransformHandle
+	{
+		unsigned int slot;
+		unsigned int generation;
+
+		constexpr TransformHandle() : slot(0), generation(0) {}
+		constexpr TransformHandle(unsigned int slot, unsigned int generation) : slot(slot), generation(generation) {}
+		constexpr bool isNull() const                               { return generation == 0; }
+		constexpr bool operator==(const TransformHandle& rhs) const { return slot == rhs.slot && generation == rhs.generation; }
+		constexpr bool operator!=(const TransformHandle& rhs) const { return !(*this == rhs); }
+	};
+
+	class TransformStore
+	{
+	public:
+		TransformStore() : freeSlot(-1) {}
+
+		TransformHandle create(const Vector3& position = Vector3(0, 0, 0),
+			const Quaternion& rotation = Quaternion(1, 0, 0, 0),
+			const Vector3& scale = Vector3(1, 1, 1));
+		bool        destroy(TransformHandle h);             //false if h is not valid
+		void        clear();                                //destroy all, old handles become invalid
+		void        reserve(int count);
+
+		int         size() const                            { return (int)handleArray.size(); }
+		bool        isValid(TransformHandle h) const        { return find(h) >= 0; }
+		int         find(TransformHandle h) const;          //dense index, -1 if not valid
+
+		// access by handle, false or 0 if not valid
+		bool        setPosition(TransformHandle h, const Vector3& position);
+		bool        setRotation(TransformHandle h, const Quaternion& rotation);
+		bool        setScale(TransformHandle h, const Vector3& scale);
+		bool        get(TransformHandle h, Vector3& position, Quaternion& rotation, Vector3& scale) const;
+		const Matrix4* getWorldMatrix(TransformHandle h) const;  //as of the last updateWorldMatrices()
+
+		// dense arrays of size() elements
+		Vector3*    positions()                             { return data(positionArray); }
+		Quaternion* rotations()                             { return data(rotationArray); }
+		Vector3*    scales()                                { return data(scaleArray); }
+		const Matrix4* worldMatrices() const                { return handleArray.empty() ? 0 : &worldArray[0]; }
+		const TransformHandle* handles() const              { return handleArray.empty() ? 0 : &handleArray[0]; }   //handle of each dense index
+
+		// world = T * R * S of the dense range, all by default
+		void        updateWorldMatrices()                   { updateWorldMatrices(0, size()); }
+		void        updateWorldMatrices(int first, int count);
+
+	private:
+		// slot of a handle; dense index if live, next free slot otherwise
+		struct Slot
+		{
+			int index;
+			unsigned int generation;
+		};
+
+		template <class T>
+		static T*   data(std::vector<T>& v)                 { return v.empty() ? 0 : &v[0]; }
+
+		std::vector<Vector3> positionArray;
+		std::vector<Quaternion> rotationArray;
+		std::vector<Vector3> scaleArray;
+		std::vector<Matrix4> worldArray;
+		std::vector<TransformHandle> handleArray;
+		std::vector<Slot> slots;
+		int freeSlot;                                       // head of the free slots, -1 if none
+	};
+} //end of namespace Gil
@@ -0,0 +1,277 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////
+// vectorExpr.h
+// ============
+// Optional expression templates for Vector2/3/4 and Quaternion.
+// The regular operators of Vectors.h and Quaternion.h return a new object for
+// every operator, so a chain like a + s*b + t*c makes 4 temporaries. With the
+// expression templates, the operators only build a small tree of types, and
+// the whole chain is evaluated once per component when it is assigned.
+//
+// The same expression can be evaluated for a single object or for arrays;
+// single objects are broadcast to all elements of the arrays.
+//
+// usage:
+//   using namespace Gil::expr;
+//   Vector3 v = eval<Vector3>(cross(ref(v1), ref(v2)) + s * ref(v2) + t * ref(v1));
+//   assign(out, count, ref(from) * array(scales) + array(to) * array(weights)); // out[i] = from*scales[i] + to[i]*weights[i]
+//
+// NOTE: ref() and array() keep the pointer of the object, so the expression
+// must be evaluated before the objects are destroyed (in the same statement).
+// Quaternion components are indexed in (s, x, y, z) order.
+//
+//  AUTHOR: yao xiao dong
+// CREATED: 2026-10-19
+//
+// Copyright (C) 2026 yao xiao dong
+///////////////////////////////////////////////////////////////////////////////
+
+#include <utility>
+#include "Vectors.h"
+#include "Quaternion.h"
+
+namespace Gil
+{
+namespace expr
+{
+	///////////////////////////////////////////////////////////////////////////
+	// number of components and component access of the math types
+	///////////////////////////////////////////////////////////////////////////
+	template <class T> struct Components;
+
+	template <> struct Components<Vector2>
+	{
+		static const int SIZE = 2;
+		static float get(const Vector2& v, int c)       { return (&v.x)[c]; }
+		static float& at(Vector2& v, int c)             { return (&v.x)[c]; }
+	};
+
+	template <> struct Components<Vector3>
+	{
+		static const int SIZE = 3;
+		static float get(const Vector3& v, int c)       { return (&v.x)[c]; }
+		static float& at(Vector3& v, int c)             { return (&v.x)[c]; }
+	};
+
+	template <> struct Components<Vector4>
+	{
+		static const int SIZE = 4;
+		static float get(const Vector4& v, int c)       { return (&v.x)[c]; }
+		static float& at(Vector4& v, int c)             { return (&v.x)[c]; }
+	};
+
+	template <> struct Components<Quaternion>
+	{
+		static const int SIZE = 4;
+		static float get(const Quaternion& q, int c)    { return (&q.s)[c]; }
+		static float& at(Quaternion& q, int c)          { return (&q.s)[c]; }
+	};
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// base of all expression nodes (CRTP)
+	// Every node E has;
+	//   E::SIZE            number of components (1 for scalar)
+	//   get<C>(i)          component C of element i
+	// The component index is a template parameter, so the evaluation is
+	// unrolled at compile time and each component is a straight expression.
+	///////////////////////////////////////////////////////////////////////////
+	template <class E>
+	struct Expr
+	{
+		const E& self() const { return static_cast<const E&>(*this); }
+	};
+
+	// component index of an operand, scalar operands are broadcast
+	template <int C, class E>
+	inline float component(const E& e, int i)
+	{
+		return e.template get<E::SIZE == 1 ? 0 : C>(i);
+	}
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// leaves
+	///////////////////////////////////////////////////////////////////////////
+
+	// single object, same for all elements
+	template <class T>
+	struct Ref : public Expr<Ref<T> >
+	{
+		static const int SIZE = Components<T>::SIZE;
+		const T* p;
+		explicit Ref(const T& v) : p(&v) {}
+		template <int C> float get(int) const { return Components<T>::get(*p, C); }
+	};
+
+	// array of objects, i-th element
+	template <class T>
+	struct ArrayRef : public Expr<ArrayRef<T> >
+	{
+		static const int SIZE = Components<T>::SIZE;
+		const T* p;
+		explicit ArrayRef(const T* a) : p(a) {}
+		template <int C> float get(int i) const { return Components<T>::get(p[i], C); }
+	};
+
+	// scalar constant
+	struct Scalar : public Expr<Scalar>
+	{
+		static const int SIZE = 1;
+		float value;
+		explicit Scalar(float v) : value(v) {}
+		template <int C> float get(int) const { return value; }
+	};
+
+	// array of scalars, i-th element
+	struct ScalarArray : public Expr<ScalarArray>
+	{
+		static const int SIZE = 1;
+		const float* p;
+		explicit ScalarArray(const float* a) : p(a) {}
+		template <int C> float get(int i) const { return p[i]; }
+	};
+
+	template <class T> inline Ref<T> ref(const T& v)            { return Ref<T>(v); }
+	template <class T> inline ArrayRef<T> array(const T* a)     { return ArrayRef<T>(a); }
+	inline ScalarArray array(const float* a)                    { return ScalarArray(a); }
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// component-wise operations
+	///////////////////////////////////////////////////////////////////////////
+	struct OpAdd { static float apply(float a, float b) { return a + b; } };
+	struct OpSub { static float apply(float a, float b) { return a - b; } };
+	struct OpMul { static float apply(float a, float b) { return a * b; } };
+	struct OpDiv { static float apply(float a, float b) { return a / b; } };
+
+	template <class Op, class A, class B>
+	struct Binary : public Expr<Binary<Op, A, B> >
+	{
+		static_assert(A::SIZE == B::SIZE || A::SIZE == 1 || B::SIZE == 1, "component counts do not match");
+		static const int SIZE = A::SIZE > B::SIZE ? A::SIZE : B::SIZE;
+		A a;
+		B b;
+		Binary(const A& a, const B& b) : a(a), b(b) {}
+		template <int C> float get(int i) const { return Op::apply(component<C>(a, i), component<C>(b, i)); }
+	};
+
+	template <class A>
+	struct Negate : public Expr<Negate<A> >
+	{
+		static const int SIZE = A::SIZE;
+		A a;
+		explicit Negate(const A& a) : a(a) {}
+		template <int C> float get(int i) const { return -a.template get<C>(i); }
+	};
+
+	// cross product of 3D expressions
+	template <class A, class B>
+	struct Cross : public Expr<Cross<A, B> >
+	{
+		static_assert(A::SIZE == 3 && B::SIZE == 3, "cross product requires 3 components");
+		static const int SIZE = 3;
+		A a;
+		B b;
+		Cross(const A& a, const B& b) : a(a), b(b) {}
+		template <int C> float get(int i) const
+		{
+			// (a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x)
+			const int C1 = (C + 1) % 3;
+			const int C2 = (C + 2) % 3;
+			return a.template get<C1>(i) * b.template get<C2>(i) - a.template get<C2>(i) * b.template get<C1>(i);
+		}
+	};
+
+	// dot product, scalar expression
+	template <class A, class B>
+	struct Dot : public Expr<Dot<A, B> >
+	{
+		static_assert(A::SIZE == B::SIZE, "component counts do not match");
+		static const int SIZE = 1;
+		A a;
+		B b;
+		Dot(const A& a, const B& b) : a(a), b(b) {}
+		template <int C> float get(int i) const
+		{
+			return sum(i, std::make_integer_sequence<int, A::SIZE>());
+		}
+		template <int... N> float sum(int i, std::integer_sequence<int, N...>) const
+		{
+			return ((a.template get<N>(i) * b.template get<N>(i)) + ...);
+		}
+	};
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// operators and functions to build the expressions
+	///////////////////////////////////////////////////////////////////////////
+	template <class A, class B>
+	inline Binary<OpAdd, A, B> operator+(const Expr<A>& a, const Expr<B>& b)   { return Binary<OpAdd, A, B>(a.self(), b.self()); }
+	template <class A, class B>
+	inline Binary<OpSub, A, B> operator-(const Expr<A>& a, const Expr<B>& b)   { return Binary<OpSub, A, B>(a.self(), b.self()); }
+	template <class A, class B>
+	inline Binary<OpMul, A, B> operator*(const Expr<A>& a, const Expr<B>& b)   { return Binary<OpMul, A, B>(a.self(), b.self()); }
+	template <class A, class B>
+	inline Binary<OpDiv, A, B> operator/(const Expr<A>& a, const Expr<B>& b)   { return Binary<OpDiv, A, B>(a.self(), b.self()); }
+
+	template <class A>
+	inline Binary<OpMul, Scalar, A> operator*(float s, const Expr<A>& a)       { return Binary<OpMul, Scalar, A>(Scalar(s), a.self()); }
+	template <class A>
+	inline Binary<OpMul, A, Scalar> operator*(const Expr<A>& a, float s)       { return Binary<OpMul, A, Scalar>(a.self(), Scalar(s)); }
+	template <class A>
+	inline Binary<OpMul, A, Scalar> operator/(const Expr<A>& a, float s)       { return Binary<OpMul, A, Scalar>(a.self(), Scalar(1.0f / s)); }
+	template <class A>
+	inline Negate<A> operator-(const Expr<A>& a)                               { return Negate<A>(a.self()); }
+
+	template <class A, class B>
+	inline Cross<A, B> cross(const Expr<A>& a, const Expr<B>& b)               { return Cross<A, B>(a.self(), b.self()); }
+	template <class A, class B>
+	inline Dot<A, B> dot(const Expr<A>& a, const Expr<B>& b)                   { return Dot<A, B>(a.self(), b.self()); }
+
+
+	///////////////////////////////////////////////////////////////////////////
+	// evaluation
+	///////////////////////////////////////////////////////////////////////////
+
+	// store all components of element i to dst
+	template <class T, class E, int... C>
+	inline void store(T& dst, const E& e, int i, std::integer_sequence<int, C...>)
+	{
+		((Components<T>::at(dst, C) = e.template get<C>(i)), ...);
+	}
+
+	// evaluate the expression to a single object
+	template <class T, class E>
+	inline T eval(const Expr<E>& e)
+	{
+		static_assert(Components<T>::SIZE == E::SIZE, "component counts do not match");
+		T result;
+		store(result, e.self(), 0, std::make_integer_sequence<int, E::SIZE>());
+		return result;
+	}
+
+	// evaluate the expression to a single object
+	template <class T, class E>
+	inline void assign(T& dst, const Expr<E>& e)
+	{
+		dst = eval<T>(e);
+	}
+
+	// evaluate the expression for count elements; dst[i] = e(i)
+	// dst may be one of the arrays in the expression, because each element
+	// only depends on the same element of the arrays.
+	template <class T, class E>
+	inline void assign(T* dst, int count, const Expr<E>& e)
+	{
+		static_assert(Components<T>::SIZE == E::SIZE, "component counts do not match");
+		const E& expr = e.self();
+		for (int i = 0; i < count; ++i)
+		{
+			T result;
+			store(result, expr, i, std::make_integer_sequence<int, E::SIZE>());
+			dst[i] = result;
+		}
+	}
+} //end of namespace expr
+} //end of namespace Gil